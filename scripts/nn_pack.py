@@ -0,0 +1,118 @@
+"""
+Quantize a float model description into the int8 model format read by
+src/analysis/inference/nn_model.c (nn_model_open).
+
+usage: python3 nn_pack.py <model.json> <out.nn8>
+
+model.json:
+{
+  "kind": "classifier" | "autoencoder",
+  "input_scale": 0.05, "input_zp": 0,
+  "layers": [
+    {"type": "conv1d" | "dense", "in_len": 32, "in_ch": 2, "out_ch": 8,
+     "kernel": 5, "stride": 2, "activation": "relu" | "none",
+     "out_scale": 0.1, "out_zp": -128,
+     "weights": [[... kernel * in_ch floats, channels-last ...], ... out_ch rows],
+     "bias": [... out_ch floats ...]}
+  ]
+}
+Dense layers take the flattened input: in_ch 1, kernel = stride = in_len.
+Weights are quantized symmetric per tensor, biases to int32 at in_scale * w_scale.
+"""
+
+import json
+import math
+import struct
+import sys
+
+MAGIC = 0x384E4945
+VERSION = 1
+ALIGN = 16
+KINDS = {'classifier': 0, 'autoencoder': 1}
+TYPES = {'dense': 0, 'conv1d': 1}
+ACTS = {'none': 0, 'relu': 1}
+
+
+def quant_multiplier(real):
+    if not 0.0 < real < 1.0:
+        raise ValueError(f"requant scale {real} outside (0, 1), adjust out_scale")
+    q, exp = math.frexp(real)
+    m = round(q * (1 << 31))
+    if m == (1 << 31):
+        m //= 2
+        exp += 1
+    if -exp > 31:
+        raise ValueError(f"requant scale {real} too small")
+    return m, -exp
+
+
+def align(n):
+    return (n + ALIGN - 1) // ALIGN * ALIGN
+
+
+def pack(model):
+    layers = model['layers']
+    in_scale = model['input_scale']
+    in_zp = model.get('input_zp', 0)
+
+    descs = []
+    blobs = []
+    off = 64 + 64 * len(layers)
+    for l in layers:
+        n = l['kernel'] * l['in_ch']
+        w = [x for row in l['weights'] for x in row]
+        if len(w) != l['out_ch'] * n or len(l['bias']) != l['out_ch']:
+            raise ValueError("weights / bias shape mismatch")
+
+        w_scale = max(abs(x) for x in w) / 127.0 or 1.0
+        wq = [max(-128, min(127, round(x / w_scale))) for x in w]
+        bq = [round(b / (in_scale * w_scale)) for b in l['bias']]
+        mult, shift = quant_multiplier(in_scale * w_scale / l['out_scale'])
+
+        out_len = 1 if l['type'] == 'dense' else (l['in_len'] - l['kernel']) // l['stride'] + 1
+        off = align(off)
+        w_off = off
+        off = align(off + len(wq))
+        b_off = off
+        off += 4 * len(bq)
+
+        descs.append(struct.pack('<8I4i4I',
+                                 TYPES[l['type']], ACTS[l.get('activation', 'none')],
+                                 l['in_len'], l['in_ch'], out_len, l['out_ch'], l['kernel'], l['stride'],
+                                 in_zp, l['out_zp'], mult, shift, w_off, b_off, 0, 0))
+        blobs.append((w_off, struct.pack(f'<{len(wq)}b', *wq)))
+        blobs.append((b_off, struct.pack(f'<{len(bq)}i', *bq)))
+
+        in_scale = l['out_scale']
+        in_zp = l['out_zp']
+
+    first = layers[0]
+    header = struct.pack('<5Ififi7I', MAGIC, VERSION, KINDS[model['kind']], len(layers),
+                         first['in_len'] * first['in_ch'], model['input_scale'], model.get('input_zp', 0),
+                         in_scale, in_zp, *([0] * 7))
+
+    image = bytearray(off)
+    image[0:64] = header
+    for i, d in enumerate(descs):
+        image[64 + 64 * i:128 + 64 * i] = d
+    for o, b in blobs:
+        image[o:o + len(b)] = b
+    return bytes(image)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip())
+        return 1
+
+    with open(sys.argv[1]) as f:
+        model = json.load(f)
+    image = pack(model)
+    with open(sys.argv[2], 'wb') as f:
+        f.write(image)
+    print(f"{sys.argv[2]}: {len(image)} bytes, {len(model['layers'])} layers")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
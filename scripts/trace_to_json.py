@@ -0,0 +1,101 @@
+"""
+Convert a binary trace written by trace_dump() (src/utilities/trace) into
+Chrome trace-event JSON, loadable in chrome://tracing or ui.perfetto.dev.
+
+usage: python3 trace_to_json.py <trace.bin> [out.json]
+"""
+
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x43525445
+TRACE_VERSION = 1
+NAME_LEN = 32
+EVENT_FMT = '<QQHB5x'       # trace_event_t : ts_ns, arg, point, phase
+EVENT_SIZE = struct.calcsize(EVENT_FMT)
+
+
+def read_exact(f, n):
+    data = f.read(n)
+    if len(data) != n:
+        raise ValueError("truncated trace file")
+    return data
+
+
+def read_name(f):
+    return read_exact(f, NAME_LEN).split(b'\0', 1)[0].decode(errors='replace')
+
+
+def load_trace(path):
+    with open(path, 'rb') as f:
+        magic, version, n_points = struct.unpack('<III', read_exact(f, 12))
+        if magic != TRACE_MAGIC or version != TRACE_VERSION:
+            raise ValueError(f"not a trace file (magic {magic:#x}, version {version})")
+
+        points = [read_name(f) for _ in range(n_points)]
+
+        threads = []
+        (n_threads,) = struct.unpack('<I', read_exact(f, 4))
+        for _ in range(n_threads):
+            (tid,) = struct.unpack('<I', read_exact(f, 4))
+            name = read_name(f)
+            (n_events,) = struct.unpack('<I', read_exact(f, 4))
+            events = [struct.unpack(EVENT_FMT, read_exact(f, EVENT_SIZE)) for _ in range(n_events)]
+            threads.append((tid, name, events))
+
+    return points, threads
+
+
+def to_chrome(points, threads):
+    out = []
+    t0 = min((ev[0][0] for _, _, ev in threads if ev), default=0)
+
+    for tid, name, events in threads:
+        out.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': tid, 'args': {'name': name}})
+
+        # the ring may start mid-span, drop ends without a matching begin
+        depth = 0
+        for ts_ns, arg, point, phase in events:
+            ph = chr(phase)
+            if ph == 'E':
+                if depth == 0:
+                    continue
+                depth -= 1
+            elif ph == 'B':
+                depth += 1
+
+            ev = {
+                'name': points[point] if point < len(points) else f'point{point}',
+                'ph': ph,
+                'ts': (ts_ns - t0) / 1000.0,     # microseconds
+                'pid': 1,
+                'tid': tid,
+                'args': {'arg': arg},
+            }
+            if ph == 'i':
+                ev['s'] = 't'
+            out.append(ev)
+
+    return {'traceEvents': out, 'displayTimeUnit': 'ns'}
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__.strip())
+        return 1
+
+    points, threads = load_trace(sys.argv[1])
+    doc = to_chrome(points, threads)
+
+    if len(sys.argv) > 2:
+        with open(sys.argv[2], 'w') as f:
+            json.dump(doc, f)
+    else:
+        json.dump(doc, sys.stdout)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
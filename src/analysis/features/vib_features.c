@@ -0,0 +1,203 @@
+#include "vib_features.h"
+#include "utilities/fft/fft.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+struct vib_features_ctx
+{
+    vib_features_cfg_t cfg;
+    fft_t fft;
+    vib_frame_t block;                  /* de-interleaved block, g */
+    float *scratch_re;
+    float *scratch_im;
+    float *power;                       /* block_len / 2 + 1 bins */
+    size_t fill;                        /* samples in current block */
+    uint32_t block_seq;
+};
+
+vib_features_ctx_t* vib_features_init(const vib_features_cfg_t *cfg)
+{
+    if (!cfg || cfg->block_len < 2 * VIB_FEATURES_BANDS || cfg->lsb_to_g <= 0.0f) return NULL;
+
+    vib_features_ctx_t *ctx = calloc(1, sizeof(vib_features_ctx_t));
+    if (!ctx) return NULL;
+
+    if (fft_init(&ctx->fft, cfg->block_len) != OK)
+    {
+        fprintf(stderr, "FEATURES: block_len must be a power of two\n");
+        free(ctx);
+        return NULL;
+    }
+
+    const size_t n = cfg->block_len;
+    vib_frame_init(&ctx->block, n);
+    ctx->scratch_re = calloc(n, sizeof(float));
+    ctx->scratch_im = calloc(n, sizeof(float));
+    ctx->power = calloc(n / 2 + 1, sizeof(float));
+
+    if (!ctx->block.axis[0] || 
+        !ctx->scratch_re || !ctx->scratch_im || !ctx->power)
+    {
+        fprintf(stderr, "FEATURES: mem alloc failed\n");
+        vib_features_free(ctx);
+        return NULL;
+    }
+
+    ctx->cfg = *cfg;
+
+    return ctx;
+}
+
+int vib_features_free(vib_features_ctx_t *ctx)
+{
+    if (!ctx) return ERROR;
+
+    vib_frame_free(&ctx->block);
+    free(ctx->scratch_re);
+    free(ctx->scratch_im);
+    free(ctx->power);
+    fft_free(&ctx->fft);
+    free(ctx);
+
+    return OK;
+}
+
+static void compute_block(vib_features_ctx_t *ctx, vib_features_t *out)
+{
+    const size_t n = ctx->cfg.block_len;
+    const size_t bins = n / 2;
+    const float norm = 1.0f / ((float)n * (float)n);
+    float max_rms = 0.0f;
+
+    memset(out->band_energy, 0, sizeof(out->band_energy));
+
+    for (int a = 0; a < VIB_FEATURES_AXES; a++)
+    {
+        float *x = ctx->block.axis[a];
+
+        float mean = 0.0f;
+        for (size_t i = 0; i < n; i++) mean += x[i];
+        mean /= (float)n;
+
+        float sum_sq = 0.0f;
+        float peak = 0.0f;
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] -= mean;
+            sum_sq += x[i] * x[i];
+            float mag = fabsf(x[i]);
+            if (mag > peak) peak = mag;
+        }
+
+        out->rms[a] = sqrtf(sum_sq / (float)n);
+        out->peak[a] = peak;
+        if (out->rms[a] > max_rms) max_rms = out->rms[a];
+
+        /* one-sided spectrum scaled so the bands sum to the mean square (Parseval) */
+        fft_power_spectrum(&ctx->fft, x, ctx->scratch_re, ctx->scratch_im, ctx->power);
+        for (size_t k = 1; k <= bins; k++)
+        {
+            size_t band = ((k - 1) * VIB_FEATURES_BANDS) / bins;
+            float scale = (k == bins) ? norm : 2.0f * norm;
+            out->band_energy[band] += ctx->power[k] * scale;
+        }
+    }
+
+    out->alarm_state = 0;
+    if (ctx->cfg.rms_warning_g > 0.0f && max_rms >= ctx->cfg.rms_warning_g) out->alarm_state |= VIB_ALARM_WARNING;
+    if (ctx->cfg.rms_danger_g > 0.0f && max_rms >= ctx->cfg.rms_danger_g) out->alarm_state |= VIB_ALARM_DANGER;
+
+    out->block_seq = ctx->block_seq++;
+}
+
+int vib_features_add(vib_features_ctx_t *ctx, 
+                     const vib_sensor_data_t *sample, 
+                     uint64_t timestamp_ns,
+                     uint8_t *ready, 
+                     vib_features_t *out)
+{
+    if (!ctx || !sample || !ready || !out) return ERROR;
+
+    const float scale = ctx->cfg.lsb_to_g;
+    ctx->block.axis[0][ctx->fill] = (float)sample->accel_x * scale;
+    ctx->block.axis[1][ctx->fill] = (float)sample->accel_y * scale;
+    ctx->block.axis[2][ctx->fill] = (float)sample->accel_z * scale;
+    ctx->fill++;
+
+    *ready = 0;
+    if (ctx->fill < ctx->cfg.block_len) return OK;
+
+    compute_block(ctx, out);
+    out->timestamp_ns = timestamp_ns;
+    ctx->fill = 0;
+    *ready = 1;
+
+    return OK;
+}
+
+int vib_features_add_frame(vib_features_ctx_t *ctx, 
+                           const vib_frame_t *frame, 
+                           size_t *pos,
+                           uint8_t *ready, 
+                           vib_features_t *out)
+{
+    if (!ctx || !frame || !pos || !ready || !out || *pos > frame->n_samples) return ERROR;
+
+    size_t take = frame->n_samples - *pos;
+    if (take > ctx->cfg.block_len - ctx->fill) take = ctx->cfg.block_len - ctx->fill;
+
+    for (int a = 0; a < VIB_FEATURES_AXES; a++)
+    {
+        memcpy(ctx->block.axis[a] + ctx->fill, frame->axis[a] + *pos, take * sizeof(float));
+    }
+    ctx->fill += take;
+    *pos += take;
+
+    *ready = 0;
+    if (ctx->fill < ctx->cfg.block_len) return OK;
+
+    compute_block(ctx, out);
+    out->timestamp_ns = frame->t_first_ns + (uint64_t)(*pos - 1) * frame->dt_ns;
+    ctx->fill = 0;
+    *ready = 1;
+
+    return OK;
+}
+
+int vib_features_reset(vib_features_ctx_t *ctx)
+{
+    if (!ctx) return ERROR;
+
+    ctx->fill = 0;
+
+    return OK;
+}
+
+int vib_features_set_levels(vib_features_ctx_t *ctx, float rms_warning_g, float rms_danger_g)
+{
+    if (!ctx || rms_warning_g < 0.0f || rms_danger_g < 0.0f) return ERROR;
+
+    ctx->cfg.rms_warning_g = rms_warning_g;
+    ctx->cfg.rms_danger_g = rms_danger_g;
+
+    return OK;
+}
+
+int vib_features_to_channels(const vib_features_t *feat, float *out)
+{
+    if (!feat || !out) return ERROR;
+
+    for (int a = 0; a < VIB_FEATURES_AXES; a++)
+    {
+        out[VIB_CH_RMS_X + a] = feat->rms[a];
+        out[VIB_CH_PEAK_X + a] = feat->peak[a];
+    }
+    for (int b = 0; b < VIB_FEATURES_BANDS; b++)
+    {
+        out[VIB_CH_BAND_0 + b] = feat->band_energy[b];
+    }
+
+    return OK;
+}
@@ -0,0 +1,85 @@
+/* 
+Description : per-block vibration feature extraction (RMS, peak, band energy, alarm)
+*/
+
+#pragma once
+
+#include "sensors/vibration/vib_sensor.h"
+#include "analysis/frame/vib_frame.h"
+#include "common_def.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define VIB_FEATURES_AXES           3
+#define VIB_FEATURES_BANDS          8       /* equal width bands from 0 to fs/2 */
+
+/* flat channel layout of a feature record, see vib_features_to_channels() */
+#define VIB_CH_RMS_X                0       /* RMS X, Y, Z */
+#define VIB_CH_PEAK_X               3       /* peak X, Y, Z */
+#define VIB_CH_BAND_0               6       /* band energies */
+#define VIB_CH_COUNT                (VIB_CH_BAND_0 + VIB_FEATURES_BANDS)
+
+/* alarm_state bits */
+#define VIB_ALARM_WARNING           0x01    /* any axis RMS above warning level */
+#define VIB_ALARM_DANGER            0x02    /* any axis RMS above danger level */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* one feature record per completed block, all levels in g */
+typedef struct
+{
+    uint64_t timestamp_ns;                      /* CLOCK_MONOTONIC at block end */
+    uint32_t block_seq;                         /* running block counter */
+    uint32_t alarm_state;                       /* VIB_ALARM_* bits */
+    float rms[VIB_FEATURES_AXES];               /* AC RMS per axis */
+    float peak[VIB_FEATURES_AXES];              /* max |x - mean| per axis */
+    float band_energy[VIB_FEATURES_BANDS];      /* mean square per band, summed over axes */
+} vib_features_t;
+
+typedef struct
+{
+    size_t block_len;           /* samples per block, power of two */
+    float lsb_to_g;             /* raw count scale for vib_features_add(), see vib_sensor_lsb_to_g() */
+    float rms_warning_g;        /* 0 disables the warning level */
+    float rms_danger_g;         /* 0 disables the danger level */
+} vib_features_cfg_t;
+
+typedef struct vib_features_ctx vib_features_ctx_t;
+
+vib_features_ctx_t* vib_features_init(const vib_features_cfg_t *cfg);
+
+int vib_features_free(vib_features_ctx_t *ctx);
+
+/* accumulate one sample; when a block completes 'ready' is set to 1 and 'out' is filled */
+int vib_features_add(vib_features_ctx_t *ctx, 
+                     const vib_sensor_data_t *sample, 
+                     uint64_t timestamp_ns,
+                     uint8_t *ready, 
+                     vib_features_t *out);
+
+/* 
+ append frame samples from *pos on, dense per axis copies of already scaled data
+ - stops at a completed block with 'ready' set and *pos advanced past its last sample;
+   call again until *pos == frame->n_samples
+*/
+int vib_features_add_frame(vib_features_ctx_t *ctx, 
+                           const vib_frame_t *frame, 
+                           size_t *pos,
+                           uint8_t *ready, 
+                           vib_features_t *out);
+
+/* drop the partially filled block, e.g. across a gap in the sample stream */
+int vib_features_reset(vib_features_ctx_t *ctx);
+
+/* alarm levels for the next completed block on, 0 disables a level */
+int vib_features_set_levels(vib_features_ctx_t *ctx, float rms_warning_g, float rms_danger_g);
+
+/* flatten a feature record into VIB_CH_COUNT floats (trend store, uplinks) */
+int vib_features_to_channels(const vib_features_t *feat, float *out);
+
+#ifdef __cplusplus
+}
+#endif
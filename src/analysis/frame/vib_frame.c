@@ -0,0 +1,102 @@
+#include "vib_frame.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/* g per LSB for each iis3dwb_fs_t encoding, resolved at compile time */
+static const float vib_frame_scale[4] = {
+    [IIS3DWB_FS_2G]  = IIS3DWB_LSB_TO_G(IIS3DWB_FS_2G),
+    [IIS3DWB_FS_16G] = IIS3DWB_LSB_TO_G(IIS3DWB_FS_16G),
+    [IIS3DWB_FS_4G]  = IIS3DWB_LSB_TO_G(IIS3DWB_FS_4G),
+    [IIS3DWB_FS_8G]  = IIS3DWB_LSB_TO_G(IIS3DWB_FS_8G),
+};
+
+int vib_frame_init(vib_frame_t *frame, size_t capacity)
+{
+    if (!frame || capacity == 0 || capacity > UINT32_MAX) return ERROR;
+
+    memset(frame, 0, sizeof(vib_frame_t));
+
+    const size_t stride = (capacity * sizeof(float) + VIB_FRAME_ALIGN - 1) & ~(size_t)(VIB_FRAME_ALIGN - 1);
+    uint8_t *mem = NULL;
+    if (posix_memalign((void **)&mem, VIB_FRAME_ALIGN, stride * VIB_FRAME_AXES) != 0)
+    {
+        fprintf(stderr, "FRAME: mem alloc failed\n");
+        return ERROR;
+    }
+    memset(mem, 0, stride * VIB_FRAME_AXES);
+
+    for (int a = 0; a < VIB_FRAME_AXES; a++) frame->axis[a] = (float *)(mem + (size_t)a * stride);
+    frame->capacity = (uint32_t)capacity;
+
+    return OK;
+}
+
+int vib_frame_free(vib_frame_t *frame)
+{
+    if (!frame) return ERROR;
+
+    free(frame->axis[0]);
+    memset(frame, 0, sizeof(vib_frame_t));
+
+    return OK;
+}
+
+void vib_frame_deinterleave_scalar(const vib_sensor_data_t *raw, size_t n, float scale, float *x, float *y, float *z)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = (float)raw[i].accel_x * scale;
+        y[i] = (float)raw[i].accel_y * scale;
+        z[i] = (float)raw[i].accel_z * scale;
+    }
+}
+
+#if defined(__ARM_NEON)
+
+/* 8 samples per step : vld3q_s16 splits the x/y/z lanes, widen, convert, scale, store per axis */
+static void deinterleave(const vib_sensor_data_t *raw, size_t n, float scale, float *x, float *y, float *z)
+{
+    const int16_t *src = (const int16_t *)raw;
+    float *dst[VIB_FRAME_AXES] = { x, y, z };
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const int16x8x3_t v = vld3q_s16(src + 3 * i);
+        for (int a = 0; a < VIB_FRAME_AXES; a++)
+        {
+            const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v.val[a])));
+            const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v.val[a])));
+            vst1q_f32(dst[a] + i, vmulq_n_f32(lo, scale));
+            vst1q_f32(dst[a] + i + 4, vmulq_n_f32(hi, scale));
+        }
+    }
+
+    vib_frame_deinterleave_scalar(raw + i, n - i, scale, x + i, y + i, z + i);
+}
+
+#else
+
+static void deinterleave(const vib_sensor_data_t *raw, size_t n, float scale, float *x, float *y, float *z)
+{
+    vib_frame_deinterleave_scalar(raw, n, scale, x, y, z);
+}
+
+#endif
+
+int vib_frame_load(vib_frame_t *frame, const vib_sensor_data_t *raw, size_t n, iis3dwb_fs_t fs)
+{
+    if (!frame || !frame->axis[0] || !raw || n > frame->capacity || (unsigned)fs > IIS3DWB_FS_8G) return ERROR;
+
+    deinterleave(raw, n, vib_frame_scale[fs], frame->axis[0], frame->axis[1], frame->axis[2]);
+    frame->n_samples = (uint32_t)n;
+
+    return OK;
+}
@@ -0,0 +1,45 @@
+/* 
+Description : structure-of-arrays acceleration frame for the analysis path
+              - x / y / z each in their own contiguous, cache-line aligned float array (g)
+              - filled in one de-interleave-and-scale pass over a block of raw
+                vib_sensor_data_t samples (NEON vld3q_s16, scalar fallback)
+*/
+
+#pragma once
+
+#include "sensors/vibration/vib_sensor.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define VIB_FRAME_AXES              3
+#define VIB_FRAME_ALIGN             64      /* every axis array starts on a cache line */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint64_t t_first_ns;            /* CLOCK_MONOTONIC of sample 0 */
+    uint32_t dt_ns;                 /* sample period */
+    uint32_t n_samples;
+    uint32_t capacity;              /* samples per axis array */
+    uint32_t flags;                 /* BLOCK_FLAG_* of the source block */
+    float *axis[VIB_FRAME_AXES];    /* x, y, z in g, VIB_FRAME_ALIGN aligned */
+} vib_frame_t;
+
+/* one allocation for all three axes, each padded to VIB_FRAME_ALIGN */
+int vib_frame_init(vib_frame_t *frame, size_t capacity);
+
+int vib_frame_free(vib_frame_t *frame);
+
+/* de-interleave and scale 'n' raw samples at full scale 'fs'; timing fields are left to the caller */
+int vib_frame_load(vib_frame_t *frame, const vib_sensor_data_t *raw, size_t n, iis3dwb_fs_t fs);
+
+/* portable reference of the load kernel, exposed for tests and benchmarks */
+void vib_frame_deinterleave_scalar(const vib_sensor_data_t *raw, size_t n, float scale, float *x, float *y, float *z);
+
+#ifdef __cplusplus
+}
+#endif
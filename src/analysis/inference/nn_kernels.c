@@ -0,0 +1,49 @@
+#include "nn_kernels.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+int32_t nn_dot_s8_scalar(const int8_t *x, const int8_t *w, size_t n)
+{
+    int32_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += (int32_t)x[i] * (int32_t)w[i];
+
+    return acc;
+}
+
+#if defined(__ARM_NEON)
+
+/* 16 MACs per step : widening multiply to int16, pairwise accumulate into int32 lanes */
+int32_t nn_dot_s8(const int8_t *x, const int8_t *w, size_t n)
+{
+    int32x4_t acc = vdupq_n_s32(0);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        const int8x16_t vx = vld1q_s8(x + i);
+        const int8x16_t vw = vld1q_s8(w + i);
+        acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(vx), vget_low_s8(vw)));
+        acc = vpadalq_s16(acc, vmull_s8(vget_high_s8(vx), vget_high_s8(vw)));
+    }
+
+    for (; i + 8 <= n; i += 8)
+    {
+        acc = vpadalq_s16(acc, vmull_s8(vld1_s8(x + i), vld1_s8(w + i)));
+    }
+
+    int32_t sum = vgetq_lane_s32(acc, 0) + vgetq_lane_s32(acc, 1) +
+                  vgetq_lane_s32(acc, 2) + vgetq_lane_s32(acc, 3);
+
+    return sum + nn_dot_s8_scalar(x + i, w + i, n - i);
+}
+
+#else
+
+int32_t nn_dot_s8(const int8_t *x, const int8_t *w, size_t n)
+{
+    return nn_dot_s8_scalar(x, w, n);
+}
+
+#endif
@@ -0,0 +1,39 @@
+/* 
+Description : int8 compute kernels for the inference engine
+              - nn_dot_s8() uses NEON when built for ARM, the scalar version is always available
+              - requantization is shared by both paths so results are bit-identical
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* sum of x[i] * w[i] in int32 (exact for n < 2^17) */
+int32_t nn_dot_s8(const int8_t *x, const int8_t *w, size_t n);
+int32_t nn_dot_s8_scalar(const int8_t *x, const int8_t *w, size_t n);
+
+/*
+ int32 accumulator -> int8 activation
+ - y = round(acc * mult / 2^31), rounding half up (matches NEON vqrdmulh)
+ - y = round(y / 2^shift), rounding half up (matches NEON vrshl)
+ - y + zp, clamped to [lo, 127] (lo = zp implements ReLU)
+*/
+static inline int8_t nn_requant(int32_t acc, int32_t mult, int32_t shift, int32_t zp, int32_t lo)
+{
+    int64_t y = ((int64_t)acc * mult + (1ll << 30)) >> 31;
+    if (y > INT32_MAX) y = INT32_MAX;                   /* INT32_MIN * INT32_MIN only */
+    if (shift > 0) y = (y + (1ll << (shift - 1))) >> shift;
+    y += zp;
+    if (y < lo) y = lo;
+    if (y > 127) y = 127;
+    return (int8_t)y;
+}
+
+#ifdef __cplusplus
+}
+#endif
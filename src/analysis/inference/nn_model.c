@@ -0,0 +1,403 @@
+#include "nn_model.h"
+#include "nn_kernels.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define NN_MAX_DOT_LEN          (1u << 17)      /* keeps int8 x int8 sums exact in int32 */
+#define NN_ARENA_ALIGN          64
+
+struct nn_model
+{
+    const uint8_t *base;
+    size_t len;
+    int mapped;                                 /* base came from mmap */
+
+    nn_file_header_t hdr;
+    nn_layer_desc_t layers[NN_MAX_LAYERS];
+    const int8_t *weights[NN_MAX_LAYERS];
+
+    /* static memory plan */
+    void *arena;
+    size_t arena_bytes;
+    int32_t *bias[NN_MAX_LAYERS];               /* bias - in_zp * sum(w), per output channel */
+    int8_t *act[2];                             /* ping-pong activations */
+    int8_t *qin;
+    int8_t *qout;
+    size_t out_len;
+};
+
+static size_t align_up(size_t v, size_t a)
+{
+    return (v + a - 1) / a * a;
+}
+
+static size_t layer_out_size(const nn_layer_desc_t *l)
+{
+    return (size_t)l->out_len * l->out_ch;
+}
+
+static size_t layer_dot_len(const nn_layer_desc_t *l)
+{
+    return (size_t)l->kernel * l->in_ch;
+}
+
+/* structural checks shared by the loader and the packer, file_len bounds the blob offsets */
+static int validate(const nn_file_header_t *hdr, const nn_layer_desc_t *layers, size_t file_len)
+{
+    if (hdr->n_layers == 0 || hdr->n_layers > NN_MAX_LAYERS || hdr->input_len == 0) return ERROR;
+    if (hdr->kind != NN_KIND_CLASSIFIER && hdr->kind != NN_KIND_AUTOENCODER) return ERROR;
+    if (!(hdr->input_scale > 0.0f) || !(hdr->output_scale > 0.0f)) return ERROR;
+    if (hdr->input_zp < -128 || hdr->input_zp > 127 || hdr->output_zp < -128 || hdr->output_zp > 127) return ERROR;
+
+    size_t in_size = hdr->input_len;
+    int32_t in_zp = hdr->input_zp;
+
+    for (uint32_t i = 0; i < hdr->n_layers; i++)
+    {
+        const nn_layer_desc_t *l = &layers[i];
+
+        if (l->in_ch == 0 || l->in_len == 0 || l->out_ch == 0 || l->kernel == 0 || l->stride == 0) return ERROR;
+        if ((size_t)l->in_len * l->in_ch != in_size || l->in_zp != in_zp) return ERROR;
+        if (l->activation != NN_ACT_NONE && l->activation != NN_ACT_RELU) return ERROR;
+        if (l->out_zp < -128 || l->out_zp > 127) return ERROR;
+        if (l->out_mult < (1 << 30) || l->out_shift < 0 || l->out_shift > 31) return ERROR;
+        if (layer_dot_len(l) >= NN_MAX_DOT_LEN) return ERROR;
+
+        if (l->type == NN_LAYER_DENSE)
+        {
+            if (l->in_ch != 1 || l->kernel != l->in_len || l->out_len != 1) return ERROR;
+        }
+        else if (l->type == NN_LAYER_CONV1D)
+        {
+            if (l->kernel > l->in_len || l->out_len != (l->in_len - l->kernel) / l->stride + 1) return ERROR;
+        }
+        else
+        {
+            return ERROR;
+        }
+
+        const size_t w_bytes = (size_t)l->out_ch * layer_dot_len(l);
+        const size_t b_bytes = (size_t)l->out_ch * sizeof(int32_t);
+        if (l->weight_off > file_len || w_bytes > file_len - l->weight_off) return ERROR;
+        if (l->bias_off > file_len || b_bytes > file_len - l->bias_off) return ERROR;
+
+        in_size = layer_out_size(l);
+        in_zp = l->out_zp;
+    }
+
+    if (in_zp != hdr->output_zp) return ERROR;
+    if (hdr->kind == NN_KIND_CLASSIFIER && in_size > NN_MAX_OUTPUTS) return ERROR;
+    if (hdr->kind == NN_KIND_AUTOENCODER && in_size != hdr->input_len) return ERROR;
+
+    return OK;
+}
+
+/* one arena for everything the forward pass touches */
+static int plan(nn_model_t *m)
+{
+    size_t max_act = 0;
+    size_t bias_bytes = 0;
+    for (uint32_t i = 0; i < m->hdr.n_layers; i++)
+    {
+        if (layer_out_size(&m->layers[i]) > max_act) max_act = layer_out_size(&m->layers[i]);
+        bias_bytes += align_up(m->layers[i].out_ch * sizeof(int32_t), NN_ARENA_ALIGN);
+    }
+    m->out_len = layer_out_size(&m->layers[m->hdr.n_layers - 1]);
+
+    const size_t act_bytes = align_up(max_act, NN_ARENA_ALIGN);
+    const size_t in_bytes = align_up(m->hdr.input_len, NN_ARENA_ALIGN);
+    const size_t out_bytes = align_up(m->out_len, NN_ARENA_ALIGN);
+    m->arena_bytes = bias_bytes + 2 * act_bytes + in_bytes + out_bytes;
+
+    if (posix_memalign(&m->arena, NN_ARENA_ALIGN, m->arena_bytes) != 0) return ERROR;
+    memset(m->arena, 0, m->arena_bytes);
+
+    uint8_t *p = (uint8_t *)m->arena;
+    for (uint32_t i = 0; i < m->hdr.n_layers; i++)
+    {
+        const nn_layer_desc_t *l = &m->layers[i];
+        const size_t n = layer_dot_len(l);
+
+        /* fold the input zero point into the bias : sum((x - zp) * w) = sum(x * w) - zp * sum(w) */
+        m->bias[i] = (int32_t *)p;
+        for (uint32_t c = 0; c < l->out_ch; c++)
+        {
+            int32_t b = 0;
+            memcpy(&b, m->base + l->bias_off + c * sizeof(int32_t), sizeof(b));
+            int32_t wsum = 0;
+            for (size_t k = 0; k < n; k++) wsum += m->weights[i][c * n + k];
+            m->bias[i][c] = b - l->in_zp * wsum;
+        }
+        p += align_up(l->out_ch * sizeof(int32_t), NN_ARENA_ALIGN);
+    }
+
+    m->act[0] = (int8_t *)p;
+    p += act_bytes;
+    m->act[1] = (int8_t *)p;
+    p += act_bytes;
+    m->qin = (int8_t *)p;
+    p += in_bytes;
+    m->qout = (int8_t *)p;
+
+    return OK;
+}
+
+nn_model_t* nn_model_load(const void *mem, size_t len)
+{
+    if (!mem || len < sizeof(nn_file_header_t)) return NULL;
+
+    nn_model_t *m = calloc(1, sizeof(nn_model_t));
+    if (!m) return NULL;
+
+    m->base = (const uint8_t *)mem;
+    m->len = len;
+    memcpy(&m->hdr, mem, sizeof(nn_file_header_t));
+
+    if (m->hdr.magic != NN_MODEL_MAGIC || m->hdr.version != NN_MODEL_VERSION ||
+        m->hdr.n_layers == 0 || m->hdr.n_layers > NN_MAX_LAYERS ||
+        len < sizeof(nn_file_header_t) + m->hdr.n_layers * sizeof(nn_layer_desc_t))
+    {
+        fprintf(stderr, "NN: not a model image\n");
+        free(m);
+        return NULL;
+    }
+
+    memcpy(m->layers, m->base + sizeof(nn_file_header_t), m->hdr.n_layers * sizeof(nn_layer_desc_t));
+    if (validate(&m->hdr, m->layers, len) != OK)
+    {
+        fprintf(stderr, "NN: invalid model layout\n");
+        free(m);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < m->hdr.n_layers; i++) m->weights[i] = (const int8_t *)(m->base + m->layers[i].weight_off);
+
+    if (plan(m) != OK)
+    {
+        fprintf(stderr, "NN: arena alloc failure\n");
+        free(m);
+        return NULL;
+    }
+
+    return m;
+}
+
+nn_model_t* nn_model_open(const char *path)
+{
+    if (!path) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void *mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+    {
+        fprintf(stderr, "NN: mmap of %s failed\n", path);
+        return NULL;
+    }
+
+    nn_model_t *m = nn_model_load(mem, (size_t)st.st_size);
+    if (!m)
+    {
+        munmap(mem, (size_t)st.st_size);
+        return NULL;
+    }
+    m->mapped = 1;
+
+    return m;
+}
+
+int nn_model_close(nn_model_t *model)
+{
+    if (!model) return ERROR;
+
+    if (model->mapped) munmap((void *)model->base, model->len);
+    free(model->arena);
+    free(model);
+
+    return OK;
+}
+
+size_t nn_model_input_len(const nn_model_t *model)
+{
+    return model ? model->hdr.input_len : 0;
+}
+
+size_t nn_model_output_len(const nn_model_t *model)
+{
+    return model ? model->out_len : 0;
+}
+
+uint32_t nn_model_kind(const nn_model_t *model)
+{
+    return model ? model->hdr.kind : 0;
+}
+
+size_t nn_model_arena_bytes(const nn_model_t *model)
+{
+    return model ? model->arena_bytes : 0;
+}
+
+static void run_layer(const nn_model_t *m, uint32_t i, const int8_t *src, int8_t *dst)
+{
+    const nn_layer_desc_t *l = &m->layers[i];
+    const int8_t *w = m->weights[i];
+    const int32_t *bias = m->bias[i];
+    const size_t n = layer_dot_len(l);
+    const int32_t lo = (l->activation == NN_ACT_RELU) ? l->out_zp : -128;
+
+    for (uint32_t o = 0; o < l->out_len; o++)
+    {
+        const int8_t *win = src + (size_t)o * l->stride * l->in_ch;
+        int8_t *out = dst + (size_t)o * l->out_ch;
+        for (uint32_t c = 0; c < l->out_ch; c++)
+        {
+            const int32_t acc = bias[c] + nn_dot_s8(win, w + (size_t)c * n, n);
+            out[c] = nn_requant(acc, l->out_mult, l->out_shift, l->out_zp, lo);
+        }
+    }
+}
+
+int nn_model_run_q(nn_model_t *model, const int8_t *in, int8_t *out)
+{
+    if (!model || !in || !out) return ERROR;
+
+    const uint32_t n_layers = model->hdr.n_layers;
+    const int8_t *src = in;
+    for (uint32_t i = 0; i < n_layers; i++)
+    {
+        int8_t *dst = (i == n_layers - 1) ? out : model->act[i & 1];
+        run_layer(model, i, src, dst);
+        src = dst;
+    }
+
+    return OK;
+}
+
+int nn_model_run(nn_model_t *model, const float *in, nn_result_t *result)
+{
+    if (!model || !in || !result) return ERROR;
+
+    const nn_file_header_t *h = &model->hdr;
+    for (uint32_t i = 0; i < h->input_len; i++)
+    {
+        float q = roundf(in[i] / h->input_scale) + (float)h->input_zp;
+        if (q < -128.0f) q = -128.0f;
+        if (q > 127.0f) q = 127.0f;
+        model->qin[i] = (int8_t)q;
+    }
+
+    if (nn_model_run_q(model, model->qin, model->qout) != OK) return ERROR;
+
+    memset(result, 0, sizeof(nn_result_t));
+    result->kind = h->kind;
+
+    if (h->kind == NN_KIND_CLASSIFIER)
+    {
+        result->n_scores = (uint32_t)model->out_len;
+        for (uint32_t i = 0; i < result->n_scores; i++)
+        {
+            result->scores[i] = (float)(model->qout[i] - h->output_zp) * h->output_scale;
+            if (model->qout[i] > model->qout[result->class_id]) result->class_id = i;
+        }
+        return OK;
+    }
+
+    /* autoencoder : distance between the reconstruction and the original (unquantized) input */
+    double err = 0.0;
+    for (uint32_t i = 0; i < h->input_len; i++)
+    {
+        const double d = (double)(model->qout[i] - h->output_zp) * h->output_scale - in[i];
+        err += d * d;
+    }
+    result->recon_error = (float)(err / h->input_len);
+
+    return OK;
+}
+
+int nn_quant_multiplier(double real, int32_t *mult, int32_t *shift)
+{
+    if (!mult || !shift || !(real > 0.0) || real >= 1.0) return ERROR;
+
+    int exp = 0;
+    const double q = frexp(real, &exp);                 /* real = q * 2^exp, q in [0.5, 1) */
+    long long m = llround(q * (double)(1ll << 31));
+    if (m == (1ll << 31))
+    {
+        m /= 2;
+        exp++;
+    }
+    if (-exp > 31) return ERROR;
+
+    *mult = (int32_t)m;
+    *shift = -exp;
+
+    return OK;
+}
+
+size_t nn_model_pack(const nn_model_spec_t *spec, void *out, size_t cap)
+{
+    if (!spec || spec->n_layers == 0 || spec->n_layers > NN_MAX_LAYERS) return 0;
+
+    nn_file_header_t hdr = {
+        .magic = NN_MODEL_MAGIC,
+        .version = NN_MODEL_VERSION,
+        .kind = spec->kind,
+        .n_layers = spec->n_layers,
+        .input_len = spec->input_len,
+        .input_scale = spec->input_scale,
+        .input_zp = spec->input_zp,
+        .output_scale = spec->output_scale,
+        .output_zp = spec->output_zp,
+    };
+
+    /* header, layer table, then weight / bias blobs */
+    nn_layer_desc_t layers[NN_MAX_LAYERS];
+    size_t off = sizeof(nn_file_header_t) + spec->n_layers * sizeof(nn_layer_desc_t);
+    for (uint32_t i = 0; i < spec->n_layers; i++)
+    {
+        const nn_layer_spec_t *ls = &spec->layers[i];
+        if (!ls->weights || !ls->bias) return 0;
+
+        layers[i] = ls->desc;
+        off = align_up(off, NN_MODEL_ALIGN);
+        layers[i].weight_off = (uint32_t)off;
+        off += (size_t)ls->desc.out_ch * ls->desc.kernel * ls->desc.in_ch;
+        off = align_up(off, NN_MODEL_ALIGN);
+        layers[i].bias_off = (uint32_t)off;
+        off += (size_t)ls->desc.out_ch * sizeof(int32_t);
+    }
+
+    if (validate(&hdr, layers, off) != OK) return 0;
+    if (!out) return off;
+    if (cap < off) return 0;
+
+    uint8_t *p = (uint8_t *)out;
+    memset(p, 0, off);
+    memcpy(p, &hdr, sizeof(hdr));
+    memcpy(p + sizeof(hdr), layers, spec->n_layers * sizeof(nn_layer_desc_t));
+    for (uint32_t i = 0; i < spec->n_layers; i++)
+    {
+        const nn_layer_desc_t *l = &layers[i];
+        memcpy(p + l->weight_off, spec->layers[i].weights, (size_t)l->out_ch * l->kernel * l->in_ch);
+        memcpy(p + l->bias_off, spec->layers[i].bias, (size_t)l->out_ch * sizeof(int32_t));
+    }
+
+    return off;
+}
@@ -0,0 +1,138 @@
+/* 
+Description : compact int8 inference engine for small models (dense, 1D conv, autoencoder)
+              - weights int8 symmetric per tensor, activations int8 asymmetric, bias int32
+              - conv1d is channels-last ([len][ch]) with valid padding; dense is a conv whose
+                kernel spans the whole input
+              - all buffers are planned and allocated at load, nn_model_run*() never allocates
+              - model files are mmap'd read-only, layout below
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define NN_MODEL_MAGIC          0x384E4945u     /* "EIN8" */
+#define NN_MODEL_VERSION        1u
+#define NN_MAX_LAYERS           16
+#define NN_MAX_OUTPUTS          32              /* classifier classes */
+#define NN_MODEL_ALIGN          16              /* weight / bias blob alignment in the file */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    NN_KIND_CLASSIFIER = 0,     /* output = class scores */
+    NN_KIND_AUTOENCODER         /* output = reconstruction of the input */
+} nn_kind_t;
+
+typedef enum
+{
+    NN_LAYER_DENSE = 0,
+    NN_LAYER_CONV1D
+} nn_layer_type_t;
+
+typedef enum
+{
+    NN_ACT_NONE = 0,
+    NN_ACT_RELU
+} nn_activation_t;
+
+/* file header, 64 bytes, little endian */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t kind;              /* nn_kind_t */
+    uint32_t n_layers;
+    uint32_t input_len;         /* elements of the flattened input */
+    float input_scale;
+    int32_t input_zp;
+    float output_scale;
+    int32_t output_zp;
+    uint32_t reserved[7];
+} nn_file_header_t;
+
+/* layer record, 64 bytes, n_layers of them follow the header */
+typedef struct
+{
+    uint32_t type;              /* nn_layer_type_t */
+    uint32_t activation;        /* nn_activation_t */
+    uint32_t in_len;            /* positions (dense : flattened input size) */
+    uint32_t in_ch;             /* channels per position (dense : 1) */
+    uint32_t out_len;           /* output positions (dense : 1) */
+    uint32_t out_ch;            /* output channels / units */
+    uint32_t kernel;            /* conv taps (dense : in_len) */
+    uint32_t stride;
+    int32_t in_zp;              /* must equal the previous layer's out_zp */
+    int32_t out_zp;
+    int32_t out_mult;           /* requant multiplier, Q31 in [2^30, 2^31) */
+    int32_t out_shift;          /* requant right shift, 0..31 */
+    uint32_t weight_off;        /* int8 [out_ch][kernel * in_ch] */
+    uint32_t bias_off;          /* int32 [out_ch] */
+    uint32_t reserved[2];
+} nn_layer_desc_t;
+
+/* model description for nn_model_pack(), offsets are filled in by the packer */
+typedef struct
+{
+    nn_layer_desc_t desc;
+    const int8_t *weights;
+    const int32_t *bias;
+} nn_layer_spec_t;
+
+typedef struct
+{
+    uint32_t kind;
+    uint32_t input_len;
+    float input_scale;
+    int32_t input_zp;
+    float output_scale;
+    int32_t output_zp;
+    uint32_t n_layers;
+    nn_layer_spec_t layers[NN_MAX_LAYERS];
+} nn_model_spec_t;
+
+typedef struct
+{
+    uint32_t kind;
+    uint32_t class_id;                  /* classifier : argmax */
+    uint32_t n_scores;
+    float scores[NN_MAX_OUTPUTS];       /* classifier : dequantized outputs */
+    float recon_error;                  /* autoencoder : mean squared error in input units */
+} nn_result_t;
+
+typedef struct nn_model nn_model_t;
+
+/* map a model file read-only */
+nn_model_t* nn_model_open(const char *path);
+
+/* use a model image already in memory, 'mem' must outlive the model */
+nn_model_t* nn_model_load(const void *mem, size_t len);
+
+int nn_model_close(nn_model_t *model);
+
+size_t nn_model_input_len(const nn_model_t *model);
+size_t nn_model_output_len(const nn_model_t *model);
+uint32_t nn_model_kind(const nn_model_t *model);
+
+/* bytes planned at load (activation ping-pong + folded biases) */
+size_t nn_model_arena_bytes(const nn_model_t *model);
+
+/* quantized in / out, out holds nn_model_output_len() values */
+int nn_model_run_q(nn_model_t *model, const int8_t *in, int8_t *out);
+
+/* float in, quantized with the model's input scale, class scores or reconstruction error out */
+int nn_model_run(nn_model_t *model, const float *in, nn_result_t *result);
+
+/* real multiplier (0, 1) -> Q31 multiplier + right shift */
+int nn_quant_multiplier(double real, int32_t *mult, int32_t *shift);
+
+/* serialize a model; out NULL returns the size needed, 0 on an invalid spec */
+size_t nn_model_pack(const nn_model_spec_t *spec, void *out, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,335 @@
+#include "kurtogram.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdbool.h>
+
+#define KURTOGRAM_PI            3.14159265358979323846
+#define KURTOGRAM_HIST          (KURTOGRAM_TAPS - 1)    /* parent samples a child output reaches back */
+#define KURTOGRAM_DC_POLE       0.999f                  /* DC blocker, ~4 Hz corner at the IIS3DWB rate */
+
+struct kurtogram
+{
+    kurtogram_cfg_t cfg;
+
+    /* analysis filters : prototype shifted to the lower (0) and upper (1) half of the parent band */
+    float h_re[2][KURTOGRAM_TAPS];
+    float h_im[2][KURTOGRAM_TAPS];
+
+    float stage[KURTOGRAM_CHUNK];       /* input waiting for a full chunk */
+    size_t stage_fill;
+    float dc_x;                         /* DC blocker state */
+    float dc_y;
+    bool dc_primed;
+
+    /* signal of every band that has children : level k holds 2^k nodes of
+       KURTOGRAM_HIST history samples followed by KURTOGRAM_CHUNK >> k new ones */
+    float *sig_re[KURTOGRAM_MAX_LEVELS];
+    float *sig_im[KURTOGRAM_MAX_LEVELS];
+
+    /* moments per band, node (k, j) at index 2^k - 1 + j */
+    double *s2;
+    double *s4;
+    uint64_t count[KURTOGRAM_MAX_LEVELS + 1];   /* samples per band of each level */
+    uint64_t samples;                           /* input samples analysed */
+};
+
+static size_t node_stride(uint32_t level)
+{
+    return KURTOGRAM_HIST + (KURTOGRAM_CHUNK >> level);
+}
+
+/* Hamming windowed sinc, cutoff at a quarter of the parent band on either side of its centre */
+static void filters_init(kurtogram_t *kg)
+{
+    const double mid = (KURTOGRAM_TAPS - 1) / 2.0;
+    double h0[KURTOGRAM_TAPS];
+    double sum = 0.0;
+
+    for (int i = 0; i < KURTOGRAM_TAPS; i++)
+    {
+        const double t = (double)i - mid;
+        const double sinc = sin(KURTOGRAM_PI * t / 4.0) / (KURTOGRAM_PI * t);
+        const double w = 0.54 - 0.46 * cos(2.0 * KURTOGRAM_PI * (double)i / (KURTOGRAM_TAPS - 1));
+        h0[i] = sinc * w;
+        sum += h0[i];
+    }
+
+    /* centred at pi/4 and 3pi/4 : each child keeps half of the parent's [0, pi) band */
+    for (int i = 0; i < KURTOGRAM_TAPS; i++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            const double w = KURTOGRAM_PI * (double)(2 * c + 1) / 4.0 * (double)i;
+            kg->h_re[c][i] = (float)(h0[i] / sum * cos(w));
+            kg->h_im[c][i] = (float)(h0[i] / sum * sin(w));
+        }
+    }
+}
+
+kurtogram_t* kurtogram_init(const kurtogram_cfg_t *cfg)
+{
+    if (!cfg || cfg->levels == 0 || cfg->levels > KURTOGRAM_MAX_LEVELS || cfg->sample_rate_hz <= 0.0f) return NULL;
+
+    kurtogram_t *kg = calloc(1, sizeof(kurtogram_t));
+    if (!kg) return NULL;
+
+    kg->cfg = *cfg;
+    filters_init(kg);
+
+    bool ok = true;
+    for (uint32_t k = 0; ok && k < cfg->levels; k++)
+    {
+        const size_t len = ((size_t)1 << k) * node_stride(k);
+        kg->sig_re[k] = calloc(len, sizeof(float));
+        kg->sig_im[k] = calloc(len, sizeof(float));
+        ok = kg->sig_re[k] && kg->sig_im[k];
+    }
+    const size_t nodes = ((size_t)2 << cfg->levels) - 1;
+    kg->s2 = calloc(nodes, sizeof(double));
+    kg->s4 = calloc(nodes, sizeof(double));
+
+    if (!ok || !kg->s2 || !kg->s4)
+    {
+        fprintf(stderr, "KURTOGRAM: mem alloc failed\n");
+        kurtogram_free(kg);
+        return NULL;
+    }
+
+    return kg;
+}
+
+int kurtogram_free(kurtogram_t *kg)
+{
+    if (!kg) return ERROR;
+
+    for (uint32_t k = 0; k < KURTOGRAM_MAX_LEVELS; k++)
+    {
+        free(kg->sig_re[k]);
+        free(kg->sig_im[k]);
+    }
+    free(kg->s2);
+    free(kg->s4);
+    free(kg);
+
+    return OK;
+}
+
+/*
+ split one band into its two children, decimating by 2. The upper child lands in [-pi, 0)
+ after decimation and is shifted back to [0, pi) by (-1)^m, so every band has the same
+ orientation and the same two filters serve the whole tree. The chunk keeps m's parity
+ continuous across calls. 'out_re' is NULL for the last level, only the moments are kept
+*/
+static void split_node(kurtogram_t *kg, const float *p_re, const float *p_im, size_t n_out,
+                       float *out_re[2], float *out_im[2], double *s2, double *s4)
+{
+    for (int c = 0; c < 2; c++)
+    {
+        const float *hr = kg->h_re[c];
+        const float *hi = kg->h_im[c];
+        const float sign_step = c ? -1.0f : 1.0f;
+        float sign = 1.0f;
+        float acc2 = 0.0f;
+        float acc4 = 0.0f;
+
+        for (size_t m = 0; m < n_out; m++)
+        {
+            const float *xr = p_re + KURTOGRAM_HIST + 2 * m + 1;
+            const float *xi = p_im + KURTOGRAM_HIST + 2 * m + 1;
+            float yr = 0.0f;
+            float yi = 0.0f;
+            for (int i = 0; i < KURTOGRAM_TAPS; i++)
+            {
+                yr += hr[i] * xr[-i] - hi[i] * xi[-i];
+                yi += hr[i] * xi[-i] + hi[i] * xr[-i];
+            }
+            yr *= sign;
+            yi *= sign;
+            sign *= sign_step;
+
+            const float pw = yr * yr + yi * yi;
+            acc2 += pw;
+            acc4 += pw * pw;
+            if (out_re[c])
+            {
+                out_re[c][KURTOGRAM_HIST + m] = yr;
+                out_im[c][KURTOGRAM_HIST + m] = yi;
+            }
+        }
+
+        s2[c] += acc2;
+        s4[c] += acc4;
+    }
+}
+
+static void process_chunk(kurtogram_t *kg)
+{
+    const uint32_t levels = kg->cfg.levels;
+
+    /* level 0 : the DC-free input, the gravity component would dominate every moment */
+    float *root_re = kg->sig_re[0] + KURTOGRAM_HIST;
+    float acc2 = 0.0f;
+    float acc4 = 0.0f;
+    for (size_t i = 0; i < KURTOGRAM_CHUNK; i++)
+    {
+        const float x = kg->stage[i];
+        kg->dc_y = x - kg->dc_x + KURTOGRAM_DC_POLE * kg->dc_y;
+        kg->dc_x = x;
+        root_re[i] = kg->dc_y;
+
+        const float x2 = kg->dc_y * kg->dc_y;
+        acc2 += x2;
+        acc4 += x2 * x2;
+    }
+    kg->s2[0] += acc2;
+    kg->s4[0] += acc4;
+    kg->count[0] += KURTOGRAM_CHUNK;
+
+    for (uint32_t k = 0; k < levels; k++)
+    {
+        const size_t stride = node_stride(k);
+        const size_t n_out = (KURTOGRAM_CHUNK >> k) / 2;
+        const size_t child_base = ((size_t)2 << k) - 1;
+
+        for (size_t j = 0; j < ((size_t)1 << k); j++)
+        {
+            float *out_re[2] = { NULL, NULL };
+            float *out_im[2] = { NULL, NULL };
+            if (k + 1 < levels)
+            {
+                const size_t child_stride = node_stride(k + 1);
+                for (int c = 0; c < 2; c++)
+                {
+                    out_re[c] = kg->sig_re[k + 1] + (2 * j + c) * child_stride;
+                    out_im[c] = kg->sig_im[k + 1] + (2 * j + c) * child_stride;
+                }
+            }
+            split_node(kg, kg->sig_re[k] + j * stride, kg->sig_im[k] + j * stride, n_out,
+                       out_re, out_im, kg->s2 + child_base + 2 * j, kg->s4 + child_base + 2 * j);
+        }
+        kg->count[k + 1] += n_out;
+
+        /* this level's newest samples are the next chunk's history */
+        for (size_t j = 0; j < ((size_t)1 << k); j++)
+        {
+            float *re = kg->sig_re[k] + j * stride;
+            float *im = kg->sig_im[k] + j * stride;
+            memmove(re, re + stride - KURTOGRAM_HIST, KURTOGRAM_HIST * sizeof(float));
+            memmove(im, im + stride - KURTOGRAM_HIST, KURTOGRAM_HIST * sizeof(float));
+        }
+    }
+
+    kg->samples += KURTOGRAM_CHUNK;
+}
+
+int kurtogram_add(kurtogram_t *kg, const float *x, size_t n)
+{
+    if (!kg || (!x && n)) return ERROR;
+
+    /* start the DC blocker at the first sample instead of stepping from zero */
+    if (!kg->dc_primed && n)
+    {
+        kg->dc_x = x[0];
+        kg->dc_y = 0.0f;
+        kg->dc_primed = true;
+    }
+
+    while (n)
+    {
+        size_t take = KURTOGRAM_CHUNK - kg->stage_fill;
+        if (take > n) take = n;
+        memcpy(kg->stage + kg->stage_fill, x, take * sizeof(float));
+        kg->stage_fill += take;
+        x += take;
+        n -= take;
+
+        if (kg->stage_fill == KURTOGRAM_CHUNK)
+        {
+            process_chunk(kg);
+            kg->stage_fill = 0;
+        }
+    }
+
+    return OK;
+}
+
+static float band_sk(const kurtogram_t *kg, uint32_t level, size_t node)
+{
+    const double n = (double)kg->count[level];
+    if (n == 0.0 || kg->s2[node] <= 0.0) return 0.0f;
+
+    const double ratio = n * kg->s4[node] / (kg->s2[node] * kg->s2[node]);
+
+    /* the real full band signal has E|x|^4 / (E|x|^2)^2 = 1.5 times that of its analytic
+       signal, scaled down so level 0 competes with the complex bands on equal terms */
+    return (float)(level ? ratio - 2.0 : ratio / 1.5 - 2.0);
+}
+
+int kurtogram_best(const kurtogram_t *kg, kurtogram_band_t *out)
+{
+    if (!kg || !out || kg->samples == 0) return ERROR;
+
+    uint32_t best_level = 0;
+    size_t best_band = 0;
+    float best_sk = band_sk(kg, 0, 0);
+
+    for (uint32_t k = 1; k <= kg->cfg.levels; k++)
+    {
+        const size_t base = ((size_t)1 << k) - 1;
+        for (size_t j = 0; j < ((size_t)1 << k); j++)
+        {
+            const float sk = band_sk(kg, k, base + j);
+            if (sk > best_sk)
+            {
+                best_sk = sk;
+                best_level = k;
+                best_band = j;
+            }
+        }
+    }
+
+    const float width = kg->cfg.sample_rate_hz / (float)(2u << best_level);
+    out->level = best_level;
+    out->band = (uint32_t)best_band;
+    out->f_lo_hz = width * (float)best_band;
+    out->f_hi_hz = width * (float)(best_band + 1);
+    out->sk = best_sk;
+    out->samples = kg->samples;
+
+    return OK;
+}
+
+int kurtogram_level(const kurtogram_t *kg, uint32_t level, float *sk, size_t n)
+{
+    if (!kg || !sk || level > kg->cfg.levels || n < ((size_t)1 << level)) return ERROR;
+
+    const size_t base = ((size_t)1 << level) - 1;
+    for (size_t j = 0; j < ((size_t)1 << level); j++) sk[j] = band_sk(kg, level, base + j);
+
+    return OK;
+}
+
+int kurtogram_reset(kurtogram_t *kg)
+{
+    if (!kg) return ERROR;
+
+    for (uint32_t k = 0; k < kg->cfg.levels; k++)
+    {
+        const size_t len = ((size_t)1 << k) * node_stride(k);
+        memset(kg->sig_re[k], 0, len * sizeof(float));
+        memset(kg->sig_im[k], 0, len * sizeof(float));
+    }
+    const size_t nodes = ((size_t)2 << kg->cfg.levels) - 1;
+    memset(kg->s2, 0, nodes * sizeof(double));
+    memset(kg->s4, 0, nodes * sizeof(double));
+    memset(kg->count, 0, sizeof(kg->count));
+    kg->samples = 0;
+    kg->stage_fill = 0;
+    kg->dc_primed = false;
+
+    return OK;
+}
@@ -0,0 +1,63 @@
+/*
+Description : streaming spectral kurtosis over a fast kurtogram filter bank
+              - binary tree of quasi-analytic half-band filters : each level splits every
+                band of the level above in two and decimates by 2, so level k holds 2^k
+                complex bands of width fs / 2^(k+1) at fs / 2^k samples per second
+              - per band only |c|^2 and |c|^4 are accumulated, the estimate sharpens as
+                blocks are added and memory does not grow with the amount of data
+              - SK = E|c|^4 / (E|c|^2)^2 - 2 for the complex bands (0 for Gaussian noise);
+                the real full band level 0 is put on the same scale
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define KURTOGRAM_MAX_LEVELS        8       /* narrowest band fs / 512 */
+#define KURTOGRAM_TAPS              16      /* prototype low-pass length */
+#define KURTOGRAM_CHUNK             1024    /* input samples per decomposition pass, >= 2^(MAX_LEVELS + 1) */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t levels;                /* decomposition depth, 1 .. KURTOGRAM_MAX_LEVELS */
+    float sample_rate_hz;           /* only used to label the bands */
+} kurtogram_cfg_t;
+
+/* one cell of the kurtogram */
+typedef struct
+{
+    uint32_t level;                 /* 0 = full band */
+    uint32_t band;                  /* 0 = lowest of the 2^level bands */
+    float f_lo_hz;
+    float f_hi_hz;
+    float sk;
+    uint64_t samples;               /* input samples behind the estimate */
+} kurtogram_band_t;
+
+typedef struct kurtogram kurtogram_t;
+
+kurtogram_t* kurtogram_init(const kurtogram_cfg_t *cfg);
+
+int kurtogram_free(kurtogram_t *kg);
+
+/* append samples of one axis, any length; they are analysed a KURTOGRAM_CHUNK at a time.
+   The input scale does not matter, SK is scale invariant */
+int kurtogram_add(kurtogram_t *kg, const float *x, size_t n);
+
+/* band with the highest SK, the widest one on a tie; ERROR before the first chunk */
+int kurtogram_best(const kurtogram_t *kg, kurtogram_band_t *out);
+
+/* SK of the 2^level bands of one level, lowest first; 'n' must be at least 2^level */
+int kurtogram_level(const kurtogram_t *kg, uint32_t level, float *sk, size_t n);
+
+/* forget the filter history and every accumulated moment, e.g. across a gap */
+int kurtogram_reset(kurtogram_t *kg);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,411 @@
+#include "order_track.h"
+#include "utilities/fft/fft.h"
+#include "utilities/block_pool/block_pool.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdbool.h>
+
+#define ORDER_TRACK_MAX_SKEW_NS     2000000.0   /* frame timestamp jump treated as a gap */
+#define ORDER_TRACK_SKEW_GAIN       16.0        /* smaller jumps pull the time base in gently */
+
+struct order_track
+{
+    order_track_cfg_t cfg;
+    uint64_t max_period_ns;             /* pulse interval at min_rpm */
+
+    /* time domain : sample i of buf was taken at t0_ns + i * dt_ns */
+    float *buf[ORDER_TRACK_AXES];
+    size_t cap;
+    size_t len;
+    double t0_ns;
+    double dt_ns;
+    bool have_time;
+
+    /* tach pulses not resampled yet, the interval pulse[0] .. pulse[1] is next */
+    uint64_t pulse[ORDER_TRACK_MAX_PULSES];
+    size_t p_head;
+    size_t p_count;
+    uint64_t prev_pulse;                /* pulse before pulse[0], for the acceleration term */
+    bool have_prev;
+    float rpm_now;
+
+    /* angle domain */
+    size_t n_ang;                       /* samples_per_rev * revs_per_spectrum */
+    float *ang[ORDER_TRACK_AXES];
+    size_t fill;
+    uint64_t t_start_ns;
+    uint64_t t_end_ns;
+    double rpm_sum;
+    float rpm_min;
+    float rpm_max;
+    uint32_t n_intervals;
+
+    fft_t fft;
+    float *scratch_re;
+    float *scratch_im;
+    float *power;
+    float *spectrum[ORDER_TRACK_AXES];  /* n_ang / 2 + 1 bins */
+    uint32_t spectrum_seq;
+};
+
+static bool is_pow2(uint32_t v)
+{
+    return v && !(v & (v - 1));
+}
+
+order_track_t* order_track_init(const order_track_cfg_t *cfg)
+{
+    if (!cfg || !is_pow2(cfg->samples_per_rev) || !is_pow2(cfg->revs_per_spectrum) || cfg->pulses_per_rev == 0 ||
+        cfg->samples_per_rev % cfg->pulses_per_rev != 0 || cfg->sample_rate_hz <= 0.0f || cfg->min_rpm <= 0.0f)
+    {
+        return NULL;
+    }
+
+    order_track_t *ot = calloc(1, sizeof(order_track_t));
+    if (!ot) return NULL;
+
+    ot->cfg = *cfg;
+    ot->max_period_ns = (uint64_t)(60.0e9 / ((double)cfg->min_rpm * cfg->pulses_per_rev));
+    ot->n_ang = (size_t)cfg->samples_per_rev * cfg->revs_per_spectrum;
+
+    /* the slowest pulse interval, plus the vibration stream lagging the tach by a few FIFO bursts */
+    const size_t interval = (size_t)ceil((double)cfg->sample_rate_hz * (double)ot->max_period_ns / 1.0e9);
+    ot->cap = 2 * interval + 4 * IIS3DWB_FIFO_MAX_WORDS;
+
+    bool ok = fft_init(&ot->fft, ot->n_ang) == OK;
+    for (int a = 0; ok && a < ORDER_TRACK_AXES; a++)
+    {
+        ot->buf[a] = calloc(ot->cap, sizeof(float));
+        ot->ang[a] = calloc(ot->n_ang, sizeof(float));
+        ot->spectrum[a] = calloc(ot->n_ang / 2 + 1, sizeof(float));
+        ok = ot->buf[a] && ot->ang[a] && ot->spectrum[a];
+    }
+    ot->scratch_re = calloc(ot->n_ang, sizeof(float));
+    ot->scratch_im = calloc(ot->n_ang, sizeof(float));
+    ot->power = calloc(ot->n_ang / 2 + 1, sizeof(float));
+
+    if (!ok || !ot->scratch_re || !ot->scratch_im || !ot->power)
+    {
+        fprintf(stderr, "ORDER: mem alloc failed\n");
+        order_track_free(ot);
+        return NULL;
+    }
+
+    return ot;
+}
+
+int order_track_free(order_track_t *ot)
+{
+    if (!ot) return ERROR;
+
+    for (int a = 0; a < ORDER_TRACK_AXES; a++)
+    {
+        free(ot->buf[a]);
+        free(ot->ang[a]);
+        free(ot->spectrum[a]);
+    }
+    free(ot->scratch_re);
+    free(ot->scratch_im);
+    free(ot->power);
+    if (ot->fft.n) fft_free(&ot->fft);
+    free(ot);
+
+    return OK;
+}
+
+/* angle domain continuity is lost, start the next spectrum from scratch */
+static void restart_angle(order_track_t *ot)
+{
+    ot->fill = 0;
+    ot->rpm_sum = 0.0;
+    ot->n_intervals = 0;
+}
+
+/* drop the oldest 'n' time domain samples */
+static void discard(order_track_t *ot, size_t n)
+{
+    if (n == 0) return;
+    if (n > ot->len) n = ot->len;
+
+    for (int a = 0; a < ORDER_TRACK_AXES; a++) memmove(ot->buf[a], ot->buf[a] + n, (ot->len - n) * sizeof(float));
+    ot->len -= n;
+    ot->t0_ns += (double)n * ot->dt_ns;
+}
+
+int order_track_add_edge(order_track_t *ot, uint64_t t_ns)
+{
+    if (!ot) return ERROR;
+
+    const uint64_t last = ot->p_count ? ot->pulse[(ot->p_head + ot->p_count - 1) % ORDER_TRACK_MAX_PULSES] :
+                          (ot->have_prev ? ot->prev_pulse : 0);
+    if ((ot->p_count || ot->have_prev) && t_ns <= last) return ERROR;
+
+    /* vibration stalled for a long time : the oldest pulses are useless now */
+    if (ot->p_count == ORDER_TRACK_MAX_PULSES)
+    {
+        ot->p_head = (ot->p_head + 1) % ORDER_TRACK_MAX_PULSES;
+        ot->p_count--;
+        ot->have_prev = false;
+        restart_angle(ot);
+    }
+
+    ot->pulse[(ot->p_head + ot->p_count++) % ORDER_TRACK_MAX_PULSES] = t_ns;
+
+    return OK;
+}
+
+int order_track_add_frame(order_track_t *ot, const vib_frame_t *frame)
+{
+    if (!ot || !frame || frame->dt_ns == 0) return ERROR;
+    if (frame->n_samples == 0) return OK;
+
+    const size_t n = (frame->n_samples > ot->cap) ? ot->cap : frame->n_samples;
+    const size_t skip = frame->n_samples - n;
+    const double t_first = (double)frame->t_first_ns + (double)skip * frame->dt_ns;
+
+    /* block timestamps jitter with the drain time, the sample clock does not : keep one time base */
+    bool restart = !ot->have_time || (frame->flags & BLOCK_FLAG_GAP) || skip;
+    if (!restart)
+    {
+        const double err = t_first - (ot->t0_ns + (double)ot->len * ot->dt_ns);
+        if (fabs(err) > ORDER_TRACK_MAX_SKEW_NS) restart = true;
+        else ot->t0_ns += err / ORDER_TRACK_SKEW_GAIN;
+    }
+    if (restart)
+    {
+        ot->len = 0;
+        ot->t0_ns = t_first;
+        ot->dt_ns = (double)frame->dt_ns;
+        ot->have_time = true;
+        restart_angle(ot);
+    }
+
+    /* no pulses for a while : make room, pending intervals that lose their start are skipped */
+    if (ot->len + n > ot->cap) discard(ot, ot->len + n - ot->cap);
+
+    for (int a = 0; a < ORDER_TRACK_AXES; a++) memcpy(ot->buf[a] + ot->len, frame->axis[a] + skip, n * sizeof(float));
+    ot->len += n;
+
+    return OK;
+}
+
+/* time of angle 'phi' (in pulse intervals from ta) on theta(u) = a u^2 + b u */
+static double angle_time(double ta, double a, double b, double phi)
+{
+    if (a == 0.0) return ta + phi / b;
+
+    const double disc = b * b + 4.0 * a * phi;
+    if (disc <= 0.0) return ta + phi / b;
+
+    return ta + 2.0 * phi / (b + sqrt(disc));
+}
+
+/* fractional sample position of time 't', clamped to the buffer */
+static double sample_pos(const order_track_t *ot, double t)
+{
+    double x = (t - ot->t0_ns) / ot->dt_ns;
+    if (x < 0.0) x = 0.0;
+    if (x > (double)(ot->len - 1)) x = (double)(ot->len - 1);
+
+    return x;
+}
+
+/*
+ resample pulse interval [ta, tb) to samples_per_rev / pulses_per_rev angle points
+ - each point averages the samples within half an angle step either side; the window
+   scales with speed, a cheap tracking anti-alias filter ahead of the decimation
+ - with fewer than two samples in the window it interpolates linearly
+*/
+static void resample_interval(order_track_t *ot, uint64_t ta, uint64_t tb)
+{
+    const uint32_t m = ot->cfg.samples_per_rev / ot->cfg.pulses_per_rev;
+    const double d1 = (double)(tb - ta);
+
+    /* constant acceleration through prev, ta, tb; falls back to constant speed */
+    double a = 0.0;
+    double b = 1.0 / d1;
+    if (ot->have_prev)
+    {
+        const double d0 = (double)(ta - ot->prev_pulse);
+        const double qa = (d0 - d1) / (d0 * d1 * (d0 + d1));
+        const double qb = (1.0 - qa * d1 * d1) / d1;
+        if (qb > 0.0 && qb + 2.0 * qa * d1 > 0.0)
+        {
+            a = qa;
+            b = qb;
+        }
+    }
+
+    const double half = 0.5 / (double)m;
+    for (uint32_t j = 0; j < m; j++)
+    {
+        const double phi = (double)j / (double)m;
+        const double t = angle_time((double)ta, a, b, phi);
+        const double lo = sample_pos(ot, angle_time((double)ta, a, b, phi - half));
+        const double hi = sample_pos(ot, angle_time((double)ta, a, b, phi + half));
+        const size_t i0 = (size_t)ceil(lo);
+        const size_t i1 = (size_t)floor(hi);
+
+        for (int ax = 0; ax < ORDER_TRACK_AXES; ax++)
+        {
+            const float *x = ot->buf[ax];
+            float v;
+            if (i1 > i0)
+            {
+                float sum = 0.0f;
+                for (size_t i = i0; i <= i1; i++) sum += x[i];
+                v = sum / (float)(i1 - i0 + 1);
+            }
+            else
+            {
+                const double p = sample_pos(ot, t);
+                const size_t i = (size_t)p;
+                const float f = (float)(p - (double)i);
+                v = (i + 1 < ot->len) ? x[i] + f * (x[i + 1] - x[i]) : x[i];
+            }
+            ot->ang[ax][ot->fill] = v;
+        }
+
+        if (ot->fill == 0) ot->t_start_ns = (uint64_t)t;
+        ot->t_end_ns = (uint64_t)t;
+        ot->fill++;
+    }
+}
+
+static void compute_spectrum(order_track_t *ot, order_features_t *out)
+{
+    const size_t n = ot->n_ang;
+    const size_t bins = n / 2;
+
+    for (int a = 0; a < ORDER_TRACK_AXES; a++)
+    {
+        float *x = ot->ang[a];
+
+        float mean = 0.0f;
+        for (size_t i = 0; i < n; i++) mean += x[i];
+        mean /= (float)n;
+
+        float sum_sq = 0.0f;
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] -= mean;
+            sum_sq += x[i] * x[i];
+        }
+        out->rms[a] = sqrtf(sum_sq / (float)n);
+
+        /* peak amplitude per order bin, a shaft-synchronous sine of amplitude A reads A */
+        fft_power_spectrum(&ot->fft, x, ot->scratch_re, ot->scratch_im, ot->power);
+        ot->spectrum[a][0] = 0.0f;
+        for (size_t k = 1; k <= bins; k++)
+        {
+            const float scale = (k == bins) ? 1.0f : 2.0f;
+            ot->spectrum[a][k] = scale * sqrtf(ot->power[k]) / (float)n;
+        }
+
+        for (int h = 0; h < ORDER_TRACK_HARMONICS; h++)
+        {
+            const size_t k = (size_t)(h + 1) * ot->cfg.revs_per_spectrum;
+            out->order_amp[a][h] = (k <= bins) ? ot->spectrum[a][k] : 0.0f;
+        }
+    }
+
+    out->t_start_ns = ot->t_start_ns;
+    out->t_end_ns = ot->t_end_ns;
+    out->spectrum_seq = ot->spectrum_seq++;
+    out->rpm_mean = (float)(ot->rpm_sum / (double)ot->n_intervals);
+    out->rpm_min = ot->rpm_min;
+    out->rpm_max = ot->rpm_max;
+}
+
+int order_track_process(order_track_t *ot, uint8_t *ready, order_features_t *out)
+{
+    if (!ot || !ready || !out) return ERROR;
+
+    *ready = 0;
+    while (ot->p_count >= 2 && ot->have_time && ot->len >= 2)
+    {
+        const uint64_t ta = ot->pulse[ot->p_head];
+        const uint64_t tb = ot->pulse[(ot->p_head + 1) % ORDER_TRACK_MAX_PULSES];
+
+        /* wait until the vibration stream has caught up with the pulse */
+        const double t_last = ot->t0_ns + (double)(ot->len - 1) * ot->dt_ns;
+        const bool stopped = (tb - ta) > ot->max_period_ns;
+        if (!stopped && t_last < (double)tb) break;
+
+        if (stopped || (double)ta < ot->t0_ns)
+        {
+            /* machine stopped, or the data for this interval is gone */
+            if (stopped) ot->rpm_now = 0.0f;
+            restart_angle(ot);
+            ot->have_prev = !stopped;
+        }
+        else
+        {
+            const float rpm = (float)(60.0e9 / ((double)(tb - ta) * ot->cfg.pulses_per_rev));
+            if (ot->n_intervals == 0 || rpm < ot->rpm_min) ot->rpm_min = rpm;
+            if (ot->n_intervals == 0 || rpm > ot->rpm_max) ot->rpm_max = rpm;
+            ot->rpm_sum += rpm;
+            ot->n_intervals++;
+            ot->rpm_now = rpm;
+
+            resample_interval(ot, ta, tb);
+            ot->have_prev = true;
+        }
+
+        ot->prev_pulse = ta;
+        ot->p_head = (ot->p_head + 1) % ORDER_TRACK_MAX_PULSES;
+        ot->p_count--;
+
+        /* the next interval's averaging window reaches back half an angle step from tb : keep a
+           whole step of this interval, so a slowing shaft (longer next step) still fits */
+        const double m = (double)(ot->cfg.samples_per_rev / ot->cfg.pulses_per_rev);
+        const double keep_from = (double)tb - (double)(tb - ta) / m - ot->dt_ns;
+        if (keep_from > ot->t0_ns) discard(ot, (size_t)((keep_from - ot->t0_ns) / ot->dt_ns));
+
+        if (ot->fill == ot->n_ang)
+        {
+            compute_spectrum(ot, out);
+            restart_angle(ot);
+            *ready = 1;
+            return OK;
+        }
+    }
+
+    return OK;
+}
+
+const float* order_track_spectrum(const order_track_t *ot, int axis, size_t *n_bins)
+{
+    if (!ot || axis < 0 || axis >= ORDER_TRACK_AXES) return NULL;
+    if (n_bins) *n_bins = ot->n_ang / 2 + 1;
+
+    return ot->spectrum[axis];
+}
+
+int order_track_speed(const order_track_t *ot, float *rpm)
+{
+    if (!ot || !rpm) return ERROR;
+
+    *rpm = ot->rpm_now;
+
+    return OK;
+}
+
+int order_track_reset(order_track_t *ot)
+{
+    if (!ot) return ERROR;
+
+    ot->len = 0;
+    ot->have_time = false;
+    ot->p_head = 0;
+    ot->p_count = 0;
+    ot->have_prev = false;
+    ot->rpm_now = 0.0f;
+    restart_angle(ot);
+
+    return OK;
+}
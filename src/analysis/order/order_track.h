@@ -0,0 +1,75 @@
+/*
+Description : computed order tracking from a tachometer pulse train
+              - shaft angle between pulses follows a constant-acceleration fit
+                through three consecutive pulses
+              - SoA vibration frames are resampled to a fixed number of points per
+                revolution, so shaft-synchronous components stay in one order bin
+                while the speed changes
+              - streams incrementally : edges and frames arrive independently on
+                CLOCK_MONOTONIC, an interval is resampled once both cover it
+*/
+
+#pragma once
+
+#include "analysis/frame/vib_frame.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ORDER_TRACK_AXES            VIB_FRAME_AXES
+#define ORDER_TRACK_HARMONICS       4       /* orders 1x .. 4x reported in order_features_t */
+#define ORDER_TRACK_MAX_PULSES      64      /* tach pulses waiting for vibration data */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t samples_per_rev;       /* angular sampling, power of two; max order = samples_per_rev / 2 */
+    uint32_t revs_per_spectrum;     /* power of two; order resolution = 1 / revs_per_spectrum */
+    uint32_t pulses_per_rev;        /* tach marks per revolution, divides samples_per_rev */
+    float sample_rate_hz;           /* vibration rate, sizes the time buffer */
+    float min_rpm;                  /* slower is treated as stopped, sizes the time buffer */
+} order_track_cfg_t;
+
+/* one record per completed order spectrum, amplitudes in g (peak) */
+typedef struct
+{
+    uint64_t t_start_ns;            /* first and last resampled point */
+    uint64_t t_end_ns;
+    uint32_t spectrum_seq;
+    float rpm_mean;
+    float rpm_min;
+    float rpm_max;
+    float rms[ORDER_TRACK_AXES];                             /* AC RMS of the angle domain signal */
+    float order_amp[ORDER_TRACK_AXES][ORDER_TRACK_HARMONICS]; /* amplitude at orders 1 .. ORDER_TRACK_HARMONICS */
+} order_features_t;
+
+typedef struct order_track order_track_t;
+
+order_track_t* order_track_init(const order_track_cfg_t *cfg);
+
+int order_track_free(order_track_t *ot);
+
+/* one tach pulse, timestamps must increase */
+int order_track_add_edge(order_track_t *ot, uint64_t t_ns);
+
+/* append a frame; BLOCK_FLAG_GAP in frame->flags restarts the time and angle buffers */
+int order_track_add_frame(order_track_t *ot, const vib_frame_t *frame);
+
+/* resample whatever both streams cover; stops after a completed spectrum with 'ready'
+   set and 'out' filled, call again until 'ready' stays 0 */
+int order_track_process(order_track_t *ot, uint8_t *ready, order_features_t *out);
+
+/* amplitude spectrum of the last completed block for 'axis', bin k = order k / revs_per_spectrum */
+const float* order_track_spectrum(const order_track_t *ot, int axis, size_t *n_bins);
+
+/* speed over the latest pulse interval, 0 before two pulses or after a stop */
+int order_track_speed(const order_track_t *ot, float *rpm);
+
+int order_track_reset(order_track_t *ot);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,242 @@
+#include "demod_select.h"
+#include "analysis/frame/vib_frame.h"
+#include "sensors/vibration/vib_sensor.h"
+#include "utilities/trace/trace.h"
+#include "common_def.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#define DEMOD_SELECT_IDLE_US        1000
+
+struct demod_select
+{
+    demod_select_cfg_t cfg;
+    kurtogram_t *kg;
+    snapshot_t *snap;
+    uint64_t window_samples;
+
+    /* worker only */
+    vib_frame_t frame;              /* SoA view of the block being analysed */
+    bool active;                    /* a window is being analysed */
+    bool have_prev;
+    uint64_t next_seq;              /* expected block seq */
+    uint32_t gen;                   /* cfg_gen of the previous block */
+    uint64_t next_start_ns;         /* no window opens before this */
+    uint64_t win_start_ns;
+    uint64_t fed;                   /* samples of the window analysed so far */
+    uint32_t window_seq;
+
+    block_queue_t *queue;
+    pthread_t thread;
+    _Atomic bool run;
+
+    _Atomic uint64_t windows;
+    _Atomic uint64_t restarts;
+    _Atomic uint64_t blocks_analysed;
+    _Atomic uint64_t blocks_skipped;
+    _Atomic uint64_t busy_ns;
+};
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+demod_select_t* demod_select_init(const demod_select_cfg_t *cfg)
+{
+    if (!cfg || cfg->window_ms == 0 || cfg->window_ms > cfg->period_ms || cfg->axis >= DEMOD_SELECT_AXES) return NULL;
+
+    const kurtogram_cfg_t kg_cfg = { .levels = cfg->levels, .sample_rate_hz = cfg->sample_rate_hz };
+    const uint64_t window_samples = (uint64_t)((double)cfg->window_ms * cfg->sample_rate_hz / 1000.0);
+    if (window_samples < KURTOGRAM_CHUNK)
+    {
+        fprintf(stderr, "[DEMOD_SELECT] window shorter than one kurtogram chunk\n");
+        return NULL;
+    }
+
+    demod_select_t *ds = calloc(1, sizeof(demod_select_t));
+    if (!ds) return NULL;
+
+    ds->cfg = *cfg;
+    ds->window_samples = window_samples;
+    ds->kg = kurtogram_init(&kg_cfg);
+    ds->snap = ds->kg ? snapshot_init(sizeof(demod_band_t)) : NULL;
+    if (!ds->snap || vib_frame_init(&ds->frame, IIS3DWB_FIFO_MAX_WORDS) != OK)
+    {
+        fprintf(stderr, "[DEMOD_SELECT] init failed\n");
+        demod_select_free(ds);
+        return NULL;
+    }
+
+    return ds;
+}
+
+int demod_select_free(demod_select_t *ds)
+{
+    if (!ds) return ERROR;
+    if (atomic_load(&ds->run)) return ERROR;
+
+    kurtogram_free(ds->kg);
+    snapshot_free(ds->snap);
+    vib_frame_free(&ds->frame);
+    free(ds);
+
+    return OK;
+}
+
+static void window_open(demod_select_t *ds, const sample_block_t *blk)
+{
+    kurtogram_reset(ds->kg);
+    ds->active = true;
+    ds->win_start_ns = blk->t_first_ns;
+    ds->fed = 0;
+}
+
+/*
+ one axis of the block through the kurtogram, a frame at a time for blocks longer than the frame
+ - SK is scale free and a window never spans a generation, so one fixed full scale serves all
+*/
+static void analyse(demod_select_t *ds, const sample_block_t *blk)
+{
+    const vib_sensor_data_t *s = (const vib_sensor_data_t *)blk->data;
+    const uint64_t t0 = monotonic_ns();
+
+    for (uint32_t pos = 0; pos < blk->n_samples; )
+    {
+        uint32_t n = blk->n_samples - pos;
+        if (n > ds->frame.capacity) n = ds->frame.capacity;
+
+        vib_frame_load(&ds->frame, s + pos, n, IIS3DWB_FS_2G);
+        kurtogram_add(ds->kg, ds->frame.axis[ds->cfg.axis], ds->frame.n_samples);
+        pos += n;
+    }
+
+    atomic_fetch_add_explicit(&ds->busy_ns, monotonic_ns() - t0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ds->blocks_analysed, 1, memory_order_relaxed);
+    ds->fed += blk->n_samples;
+}
+
+static void process_block(demod_select_t *ds, const sample_block_t *blk)
+{
+    const bool discontinuity = ds->have_prev &&
+                               (blk->seq != ds->next_seq || blk->cfg_gen != ds->gen || (blk->flags & BLOCK_FLAG_GAP));
+    ds->have_prev = true;
+    ds->next_seq = blk->seq + 1;
+    ds->gen = blk->cfg_gen;
+
+    if (!ds->active)
+    {
+        if (blk->t_first_ns < ds->next_start_ns)
+        {
+            atomic_fetch_add_explicit(&ds->blocks_skipped, 1, memory_order_relaxed);
+            return;
+        }
+        window_open(ds, blk);
+    }
+    else if (discontinuity)
+    {
+        atomic_fetch_add_explicit(&ds->restarts, 1, memory_order_relaxed);
+        window_open(ds, blk);
+    }
+
+    TRACE_BEGIN(TRACE_KURTOGRAM, blk->seq);
+    analyse(ds, blk);
+    TRACE_END(TRACE_KURTOGRAM, blk->seq);
+    if (ds->fed < ds->window_samples) return;
+
+    demod_band_t out = {
+        .t_start_ns = ds->win_start_ns,
+        .t_end_ns = blk->t_first_ns + (uint64_t)(blk->n_samples - 1) * blk->dt_ns,
+        .window_seq = ds->window_seq++,
+        .axis = ds->cfg.axis,
+        .cfg_gen = blk->cfg_gen,
+    };
+    if (kurtogram_best(ds->kg, &out.band) == OK)
+    {
+        snapshot_publish(ds->snap, &out);
+        atomic_fetch_add_explicit(&ds->windows, 1, memory_order_relaxed);
+    }
+
+    /* scheduled from the window start, a restarted window pushes the next one back */
+    ds->active = false;
+    ds->next_start_ns = ds->win_start_ns + (uint64_t)ds->cfg.period_ms * 1000000ull;
+}
+
+static void *worker_thread(void *arg)
+{
+    demod_select_t *ds = (demod_select_t *)arg;
+    sample_block_t *blk = NULL;
+
+    trace_thread_register("demod_select");
+
+    while (atomic_load(&ds->run))
+    {
+        if (block_queue_pop(ds->queue, &blk) != OK)
+        {
+            usleep(DEMOD_SELECT_IDLE_US);
+            continue;
+        }
+        TRACE_INSTANT(TRACE_BLOCK_POP, blk->seq);
+        process_block(ds, blk);
+        block_release(blk);
+    }
+
+    trace_thread_unregister();
+    return NULL;
+}
+
+int demod_select_start(demod_select_t *ds, block_queue_t *queue)
+{
+    if (!ds || !queue || atomic_load(&ds->run)) return ERROR;
+
+    ds->queue = queue;
+    ds->active = false;
+    ds->have_prev = false;
+    ds->next_start_ns = 0;
+    atomic_store(&ds->run, true);
+
+    if (pthread_create(&ds->thread, NULL, worker_thread, ds) != 0)
+    {
+        atomic_store(&ds->run, false);
+        return ERROR;
+    }
+
+    return OK;
+}
+
+int demod_select_stop(demod_select_t *ds)
+{
+    if (!ds || !atomic_load(&ds->run)) return ERROR;
+
+    atomic_store(&ds->run, false);
+    if (pthread_join(ds->thread, NULL) != 0) return ERROR;
+
+    return OK;
+}
+
+snapshot_t* demod_select_band(demod_select_t *ds)
+{
+    return ds ? ds->snap : NULL;
+}
+
+int demod_select_stats(demod_select_t *ds, demod_select_stats_t *stats)
+{
+    if (!ds || !stats) return ERROR;
+
+    stats->windows = atomic_load(&ds->windows);
+    stats->restarts = atomic_load(&ds->restarts);
+    stats->blocks_analysed = atomic_load(&ds->blocks_analysed);
+    stats->blocks_skipped = atomic_load(&ds->blocks_skipped);
+    stats->busy_ns = atomic_load(&ds->busy_ns);
+
+    return OK;
+}
@@ -0,0 +1,77 @@
+/*
+Description : automatic demodulation band selection for envelope analysis
+              - a background worker on a block subscription runs the fast kurtogram over
+                one axis for window_ms out of every period_ms, and releases the blocks in
+                between unread
+              - each completed window publishes the most impulsive band as a demod_band_t
+                snapshot for the envelope stage
+              - a gap, lost block or configuration generation change restarts the window, so
+                an estimate never spans a discontinuity
+*/
+
+#pragma once
+
+#include "analysis/kurtogram/kurtogram.h"
+#include "utilities/block_pool/block_pool.h"
+#include "utilities/block_queue/block_queue.h"
+#include "utilities/snapshot/snapshot.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DEMOD_SELECT_AXES           3
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t period_ms;             /* window start to window start */
+    uint32_t window_ms;             /* signal analysed per window, <= period_ms */
+    uint32_t levels;                /* kurtogram depth, narrowest band sample_rate_hz / 2^(levels + 1) */
+    uint32_t axis;                  /* 0 = x, 1 = y, 2 = z of the vib_sensor_data_t samples */
+    float sample_rate_hz;
+} demod_select_cfg_t;
+
+/* published once per window */
+typedef struct
+{
+    uint64_t t_start_ns;            /* analysed span, CLOCK_MONOTONIC like the block timestamps */
+    uint64_t t_end_ns;
+    uint32_t window_seq;
+    uint32_t axis;
+    uint32_t cfg_gen;               /* acquisition generation of the analysed blocks */
+    kurtogram_band_t band;
+} demod_band_t;
+
+typedef struct
+{
+    uint64_t windows;               /* bands published */
+    uint64_t restarts;              /* windows restarted on a discontinuity */
+    uint64_t blocks_analysed;
+    uint64_t blocks_skipped;        /* released unread between windows */
+    uint64_t busy_ns;               /* worker time spent in the kurtogram */
+} demod_select_stats_t;
+
+typedef struct demod_select demod_select_t;
+
+demod_select_t* demod_select_init(const demod_select_cfg_t *cfg);
+
+/* stop first */
+int demod_select_free(demod_select_t *ds);
+
+/* start the worker on a block subscription carrying vib_sensor_data_t samples */
+int demod_select_start(demod_select_t *ds, block_queue_t *queue);
+
+/* the window in progress is dropped; the owner drains the queue */
+int demod_select_stop(demod_select_t *ds);
+
+/* latest demod_band_t, generation 0 until the first window completes */
+snapshot_t* demod_select_band(demod_select_t *ds);
+
+int demod_select_stats(demod_select_t *ds, demod_select_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,527 @@
+#include "event_capture.h"
+#include "sensors/vibration/vib_sensor.h"
+#include "common_def.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#define EVENT_CAPTURE_IDLE_US           500
+#define EVENT_CAPTURE_PATH_MAX          256
+
+enum
+{
+    EVENT_SLOT_FREE = 0,
+    EVENT_SLOT_COLLECTING,          /* stage thread appends post-trigger blocks */
+    EVENT_SLOT_STORING              /* owned by the writer until it is back to FREE */
+};
+
+typedef struct
+{
+    _Atomic int state;
+    uint64_t id;
+    uint64_t t_trigger_ns;
+    uint64_t post_end_ns;           /* collect until a block reaches this time */
+    uint64_t last_seq;              /* newest block appended */
+    uint32_t trigger;
+    uint32_t flags;
+    uint32_t n_blocks;
+    sample_block_t **blocks;        /* event_cap references */
+} event_slot_t;
+
+struct event_capture
+{
+    event_capture_cfg_t cfg;
+    char dir[EVENT_CAPTURE_PATH_MAX];
+    size_t hist_cap;
+    size_t event_cap;
+
+    /* stage thread only */
+    sample_block_t **hist;          /* circular, oldest at hist_head */
+    size_t hist_head;
+    size_t hist_count;
+    bool level_above;               /* level trigger re-arms once the signal drops back */
+    uint64_t next_id;
+
+    event_slot_t slots[EVENT_CAPTURE_MAX_EVENTS];
+
+    block_queue_t *queue;
+    pthread_t stage_thread;
+    pthread_t writer_thread;
+    _Atomic bool run;
+
+    /* triggers from other threads and the writer's queue of finished events */
+    pthread_mutex_t lock;
+    pthread_cond_t store_cond;
+    struct { uint32_t trigger; uint64_t t_ns; } pending[EVENT_CAPTURE_MAX_PENDING];
+    size_t n_pending;
+    bool level_change;              /* level_next applies from the first block of level_gen on */
+    int16_t level_next;
+    uint32_t level_gen;
+    size_t store_fifo[EVENT_CAPTURE_MAX_EVENTS];
+    size_t store_head;
+    size_t store_count;
+    bool writer_exit;
+
+    _Atomic uint64_t triggers[EVENT_TRIGGER_COUNT];
+    _Atomic uint64_t merged;
+    _Atomic uint64_t dropped;
+    _Atomic uint64_t refused;
+    _Atomic uint64_t written;
+    _Atomic uint64_t write_errors;
+    _Atomic uint32_t refs_held;
+    _Atomic uint32_t refs_held_max;
+};
+
+static size_t blocks_for(uint64_t ms, uint32_t block_ns)
+{
+    return (size_t)((ms * 1000000ull + block_ns - 1) / block_ns) + 1;
+}
+
+static uint64_t block_end_ns(const sample_block_t *blk)
+{
+    return blk->t_first_ns + (uint64_t)blk->n_samples * blk->dt_ns;
+}
+
+static void refs_account(event_capture_t *ec)
+{
+    uint32_t held = atomic_fetch_add_explicit(&ec->refs_held, 1, memory_order_relaxed) + 1;
+    uint32_t max = atomic_load_explicit(&ec->refs_held_max, memory_order_relaxed);
+    while (held > max && !atomic_compare_exchange_weak_explicit(&ec->refs_held_max, &max, held,
+                                                                memory_order_relaxed, memory_order_relaxed));
+}
+
+static void refs_add(event_capture_t *ec, sample_block_t *blk)
+{
+    block_ref(blk, 1);
+    refs_account(ec);
+}
+
+static void refs_drop(event_capture_t *ec, sample_block_t *blk)
+{
+    block_release(blk);
+    atomic_fetch_sub_explicit(&ec->refs_held, 1, memory_order_relaxed);
+}
+
+/* hand a finished event to the writer */
+static void event_finish(event_capture_t *ec, size_t idx)
+{
+    atomic_store_explicit(&ec->slots[idx].state, EVENT_SLOT_STORING, memory_order_release);
+
+    pthread_mutex_lock(&ec->lock);
+    ec->store_fifo[(ec->store_head + ec->store_count) % EVENT_CAPTURE_MAX_EVENTS] = idx;
+    ec->store_count++;
+    pthread_cond_signal(&ec->store_cond);
+    pthread_mutex_unlock(&ec->lock);
+}
+
+/* reference one more block into an event, a full event is stored truncated */
+static void event_append(event_capture_t *ec, size_t idx, sample_block_t *blk)
+{
+    event_slot_t *ev = &ec->slots[idx];
+    if (ev->n_blocks == ec->event_cap)
+    {
+        ev->flags |= EVENT_FLAG_TRUNCATED;
+        event_finish(ec, idx);
+        return;
+    }
+
+    refs_add(ec, blk);
+    ev->blocks[ev->n_blocks++] = blk;
+    ev->last_seq = blk->seq;
+}
+
+/* stage thread : start a new event at 't_ns' or extend one whose post window covers it */
+static void handle_trigger(event_capture_t *ec, uint32_t trigger, uint64_t t_ns)
+{
+    const uint64_t pre_ns = (uint64_t)ec->cfg.pre_ms * 1000000ull;
+    const uint64_t post_ns = (uint64_t)ec->cfg.post_ms * 1000000ull;
+
+    atomic_fetch_add_explicit(&ec->triggers[trigger], 1, memory_order_relaxed);
+
+    size_t free_idx = ec->cfg.max_events;
+    for (size_t i = 0; i < ec->cfg.max_events; i++)
+    {
+        event_slot_t *ev = &ec->slots[i];
+        const int state = atomic_load_explicit(&ev->state, memory_order_acquire);
+        if (state == EVENT_SLOT_COLLECTING && t_ns >= ev->t_trigger_ns && t_ns <= ev->post_end_ns)
+        {
+            if (t_ns + post_ns > ev->post_end_ns) ev->post_end_ns = t_ns + post_ns;
+            ev->flags |= EVENT_FLAG_MERGED;
+            atomic_fetch_add_explicit(&ec->merged, 1, memory_order_relaxed);
+            return;
+        }
+        if (state == EVENT_SLOT_FREE && free_idx == ec->cfg.max_events) free_idx = i;
+    }
+
+    if (free_idx == ec->cfg.max_events)
+    {
+        atomic_fetch_add_explicit(&ec->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    event_slot_t *ev = &ec->slots[free_idx];
+    ev->id = ec->next_id++;
+    ev->t_trigger_ns = t_ns;
+    ev->post_end_ns = t_ns + post_ns;
+    ev->trigger = trigger;
+    ev->flags = 0;
+    ev->n_blocks = 0;
+    atomic_store_explicit(&ev->state, EVENT_SLOT_COLLECTING, memory_order_relaxed);
+
+    /* freeze the history : share every block that reaches into the pre-trigger window */
+    for (size_t i = 0; i < ec->hist_count; i++)
+    {
+        sample_block_t *blk = ec->hist[(ec->hist_head + i) % ec->hist_cap];
+        if (block_end_ns(blk) + pre_ns <= t_ns) continue;
+        event_append(ec, free_idx, blk);
+    }
+}
+
+/* first sample of 'blk' at or above the level threshold on any axis, -1 if none */
+static long level_crossing(const event_capture_t *ec, const sample_block_t *blk)
+{
+    const vib_sensor_data_t *s = (const vib_sensor_data_t *)blk->data;
+    const int level = ec->cfg.level_lsb;
+    for (uint32_t i = 0; i < blk->n_samples; i++)
+    {
+        if (abs(s[i].accel_x) >= level || abs(s[i].accel_y) >= level || abs(s[i].accel_z) >= level) return (long)i;
+    }
+
+    return -1;
+}
+
+/* stage thread : the queue's reference on 'blk' moves into the history */
+static void process_block(event_capture_t *ec, sample_block_t *blk)
+{
+    if (ec->hist_count == ec->hist_cap)
+    {
+        refs_drop(ec, ec->hist[ec->hist_head]);
+        ec->hist_head = (ec->hist_head + 1) % ec->hist_cap;
+        ec->hist_count--;
+    }
+    ec->hist[(ec->hist_head + ec->hist_count++) % ec->hist_cap] = blk;
+    refs_account(ec);
+
+    /* requests from other threads */
+    struct { uint32_t trigger; uint64_t t_ns; } pending[EVENT_CAPTURE_MAX_PENDING];
+    size_t n_pending = 0;
+    pthread_mutex_lock(&ec->lock);
+    if (ec->n_pending)
+    {
+        n_pending = ec->n_pending;
+        memcpy(pending, ec->pending, n_pending * sizeof(pending[0]));
+        ec->n_pending = 0;
+    }
+    if (ec->level_change && blk->cfg_gen >= ec->level_gen)
+    {
+        ec->cfg.level_lsb = ec->level_next;
+        ec->level_change = false;
+    }
+    pthread_mutex_unlock(&ec->lock);
+    for (size_t i = 0; i < n_pending; i++) handle_trigger(ec, pending[i].trigger, pending[i].t_ns);
+
+    /* level trigger on the rising edge only, a sustained excursion is one event */
+    if (ec->cfg.level_lsb > 0)
+    {
+        const long at = level_crossing(ec, blk);
+        if (at >= 0 && !ec->level_above) handle_trigger(ec, EVENT_TRIGGER_LEVEL, blk->t_first_ns + (uint64_t)at * blk->dt_ns);
+        ec->level_above = (at >= 0);
+    }
+
+    /* post-trigger collection */
+    for (size_t i = 0; i < ec->cfg.max_events; i++)
+    {
+        event_slot_t *ev = &ec->slots[i];
+        if (atomic_load_explicit(&ev->state, memory_order_relaxed) != EVENT_SLOT_COLLECTING) continue;
+
+        /* nothing arrived before the window closed, e.g. acquisition was parked */
+        if (blk->t_first_ns >= ev->post_end_ns)
+        {
+            event_finish(ec, i);
+            continue;
+        }
+
+        if (ev->n_blocks == 0 || blk->seq > ev->last_seq) event_append(ec, i, blk);
+        if (atomic_load_explicit(&ev->state, memory_order_relaxed) == EVENT_SLOT_COLLECTING &&
+            block_end_ns(blk) >= ev->post_end_ns) event_finish(ec, i);
+    }
+}
+
+static void *stage_thread(void *arg)
+{
+    event_capture_t *ec = (event_capture_t *)arg;
+    sample_block_t *blk = NULL;
+
+    while (atomic_load(&ec->run))
+    {
+        if (block_queue_pop(ec->queue, &blk) != OK)
+        {
+            usleep(EVENT_CAPTURE_IDLE_US);
+            continue;
+        }
+        process_block(ec, blk);
+    }
+
+    /* store what is still collecting rather than lose it */
+    for (size_t i = 0; i < ec->cfg.max_events; i++)
+    {
+        if (atomic_load(&ec->slots[i].state) != EVENT_SLOT_COLLECTING) continue;
+        ec->slots[i].flags |= EVENT_FLAG_TRUNCATED;
+        event_finish(ec, i);
+    }
+
+    return NULL;
+}
+
+/* write to a temporary name and rename, readers never see a partial event */
+static int write_event(event_capture_t *ec, const event_slot_t *ev)
+{
+    char path[EVENT_CAPTURE_PATH_MAX + 32];
+    char tmp[EVENT_CAPTURE_PATH_MAX + 40];
+    snprintf(path, sizeof(path), "%s/event_%llu.vcap", ec->dir, (unsigned long long)ev->id);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    FILE *f = fopen(tmp, "wb");
+    if (!f)
+    {
+        fprintf(stderr, "[EVENT_CAPTURE] cannot create %s\n", tmp);
+        return ERROR;
+    }
+
+    const vcap_file_header_t hdr = {
+        .magic = EVENT_CAPTURE_FILE_MAGIC,
+        .version = EVENT_CAPTURE_FILE_VERSION,
+        .id = ev->id,
+        .t_trigger_ns = ev->t_trigger_ns,
+        .trigger = ev->trigger,
+        .flags = ev->flags,
+        .pre_ms = ec->cfg.pre_ms,
+        .post_ms = ec->cfg.post_ms,
+        .n_blocks = ev->n_blocks,
+        .sample_size = sizeof(vib_sensor_data_t),
+    };
+    int ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+
+    for (uint32_t i = 0; ok && i < ev->n_blocks; i++)
+    {
+        const sample_block_t *blk = ev->blocks[i];
+        const vcap_block_header_t bh = {
+            .seq = blk->seq,
+            .t_first_ns = blk->t_first_ns,
+            .dt_ns = blk->dt_ns,
+            .n_samples = blk->n_samples,
+            .flags = blk->flags,
+            .cfg_gen = blk->cfg_gen,
+        };
+        ok = fwrite(&bh, sizeof(bh), 1, f) == 1 &&
+             fwrite(blk->data, sizeof(vib_sensor_data_t), blk->n_samples, f) == blk->n_samples;
+    }
+
+    if (fclose(f) != 0) ok = 0;
+    if (!ok || rename(tmp, path) != 0)
+    {
+        fprintf(stderr, "[EVENT_CAPTURE] writing %s failed\n", path);
+        unlink(tmp);
+        return ERROR;
+    }
+
+    return OK;
+}
+
+static void *writer_thread(void *arg)
+{
+    event_capture_t *ec = (event_capture_t *)arg;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&ec->lock);
+        while (ec->store_count == 0 && !ec->writer_exit) pthread_cond_wait(&ec->store_cond, &ec->lock);
+        if (ec->store_count == 0)
+        {
+            pthread_mutex_unlock(&ec->lock);
+            break;
+        }
+        const size_t idx = ec->store_fifo[ec->store_head];
+        ec->store_head = (ec->store_head + 1) % EVENT_CAPTURE_MAX_EVENTS;
+        ec->store_count--;
+        pthread_mutex_unlock(&ec->lock);
+
+        event_slot_t *ev = &ec->slots[idx];
+        if (write_event(ec, ev) == OK) atomic_fetch_add(&ec->written, 1);
+        else atomic_fetch_add(&ec->write_errors, 1);
+
+        for (uint32_t i = 0; i < ev->n_blocks; i++) refs_drop(ec, ev->blocks[i]);
+        ev->n_blocks = 0;
+        atomic_store_explicit(&ev->state, EVENT_SLOT_FREE, memory_order_release);
+    }
+
+    return NULL;
+}
+
+size_t event_capture_blocks_needed(const event_capture_cfg_t *cfg)
+{
+    if (!cfg || cfg->block_ns == 0) return 0;
+
+    const size_t hist_cap = blocks_for((uint64_t)cfg->pre_ms + cfg->lag_ms, cfg->block_ns);
+    const size_t event_cap = hist_cap + blocks_for(cfg->post_ms, cfg->block_ns);
+
+    return hist_cap + cfg->max_events * event_cap;
+}
+
+event_capture_t* event_capture_init(const event_capture_cfg_t *cfg)
+{
+    if (!cfg || !cfg->dir || cfg->block_ns == 0 || cfg->level_lsb < 0) return NULL;
+    if (cfg->max_events == 0 || cfg->max_events > EVENT_CAPTURE_MAX_EVENTS) return NULL;
+    if (strlen(cfg->dir) >= EVENT_CAPTURE_PATH_MAX) return NULL;
+
+    event_capture_t *ec = calloc(1, sizeof(event_capture_t));
+    if (!ec) return NULL;
+
+    ec->cfg = *cfg;
+    strcpy(ec->dir, cfg->dir);
+    ec->cfg.dir = ec->dir;
+    ec->hist_cap = blocks_for((uint64_t)cfg->pre_ms + cfg->lag_ms, cfg->block_ns);
+    ec->event_cap = ec->hist_cap + blocks_for(cfg->post_ms, cfg->block_ns);
+
+    /* every reference array is sized here, triggers never allocate */
+    ec->hist = calloc(ec->hist_cap, sizeof(sample_block_t *));
+    bool ok = ec->hist != NULL;
+    for (size_t i = 0; ok && i < cfg->max_events; i++)
+    {
+        ec->slots[i].blocks = calloc(ec->event_cap, sizeof(sample_block_t *));
+        ok = ec->slots[i].blocks != NULL;
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "[EVENT_CAPTURE] alloc failure\n");
+        event_capture_free(ec);
+        return NULL;
+    }
+
+    pthread_mutex_init(&ec->lock, NULL);
+    pthread_cond_init(&ec->store_cond, NULL);
+
+    return ec;
+}
+
+int event_capture_free(event_capture_t *ec)
+{
+    if (!ec) return ERROR;
+    if (atomic_load(&ec->run)) return ERROR;
+
+    for (size_t i = 0; i < ec->hist_count; i++) refs_drop(ec, ec->hist[(ec->hist_head + i) % ec->hist_cap]);
+    for (size_t i = 0; i < EVENT_CAPTURE_MAX_EVENTS; i++) free(ec->slots[i].blocks);
+    free(ec->hist);
+
+    pthread_mutex_destroy(&ec->lock);
+    pthread_cond_destroy(&ec->store_cond);
+    free(ec);
+
+    return OK;
+}
+
+int event_capture_start(event_capture_t *ec, block_queue_t *queue)
+{
+    if (!ec || !queue || atomic_load(&ec->run)) return ERROR;
+
+    ec->queue = queue;
+    ec->writer_exit = false;
+    atomic_store(&ec->run, true);
+
+    if (pthread_create(&ec->writer_thread, NULL, writer_thread, ec) != 0)
+    {
+        atomic_store(&ec->run, false);
+        return ERROR;
+    }
+    if (pthread_create(&ec->stage_thread, NULL, stage_thread, ec) != 0)
+    {
+        atomic_store(&ec->run, false);
+        pthread_mutex_lock(&ec->lock);
+        ec->writer_exit = true;
+        pthread_cond_signal(&ec->store_cond);
+        pthread_mutex_unlock(&ec->lock);
+        pthread_join(ec->writer_thread, NULL);
+        return ERROR;
+    }
+
+    return OK;
+}
+
+int event_capture_stop(event_capture_t *ec)
+{
+    if (!ec || !atomic_load(&ec->run)) return ERROR;
+
+    atomic_store(&ec->run, false);
+    if (pthread_join(ec->stage_thread, NULL) != 0) return ERROR;
+
+    pthread_mutex_lock(&ec->lock);
+    ec->writer_exit = true;
+    pthread_cond_signal(&ec->store_cond);
+    pthread_mutex_unlock(&ec->lock);
+    if (pthread_join(ec->writer_thread, NULL) != 0) return ERROR;
+
+    /* the history goes back to the pool, the owner drains the queue */
+    for (size_t i = 0; i < ec->hist_count; i++) refs_drop(ec, ec->hist[(ec->hist_head + i) % ec->hist_cap]);
+    ec->hist_head = 0;
+    ec->hist_count = 0;
+    ec->n_pending = 0;
+
+    return OK;
+}
+
+int event_capture_trigger(event_capture_t *ec, event_trigger_t trigger, uint64_t t_ns)
+{
+    if (!ec || trigger < 0 || trigger >= EVENT_TRIGGER_COUNT) return ERROR;
+
+    int ret = OK;
+    pthread_mutex_lock(&ec->lock);
+    if (ec->n_pending < EVENT_CAPTURE_MAX_PENDING)
+    {
+        ec->pending[ec->n_pending].trigger = (uint32_t)trigger;
+        ec->pending[ec->n_pending].t_ns = t_ns;
+        ec->n_pending++;
+    }
+    else
+    {
+        ret = ERROR;
+    }
+    pthread_mutex_unlock(&ec->lock);
+
+    if (ret != OK) atomic_fetch_add_explicit(&ec->refused, 1, memory_order_relaxed);
+
+    return ret;
+}
+
+int event_capture_set_level(event_capture_t *ec, int16_t level_lsb, uint32_t from_gen)
+{
+    if (!ec || level_lsb < 0) return ERROR;
+
+    pthread_mutex_lock(&ec->lock);
+    ec->level_next = level_lsb;
+    ec->level_gen = from_gen;
+    ec->level_change = true;
+    pthread_mutex_unlock(&ec->lock);
+
+    return OK;
+}
+
+int event_capture_stats(event_capture_t *ec, event_capture_stats_t *stats)
+{
+    if (!ec || !stats) return ERROR;
+
+    for (int i = 0; i < EVENT_TRIGGER_COUNT; i++) stats->triggers[i] = atomic_load(&ec->triggers[i]);
+    stats->merged = atomic_load(&ec->merged);
+    stats->dropped = atomic_load(&ec->dropped);
+    stats->refused = atomic_load(&ec->refused);
+    stats->written = atomic_load(&ec->written);
+    stats->write_errors = atomic_load(&ec->write_errors);
+    stats->refs_held = atomic_load(&ec->refs_held);
+    stats->refs_held_max = atomic_load(&ec->refs_held_max);
+
+    return OK;
+}
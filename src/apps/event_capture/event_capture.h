@@ -0,0 +1,116 @@
+/*
+Description : event-triggered raw waveform capture with pre-trigger history
+              - keeps references to the most recent sample blocks, never copies them
+              - a trigger (level crossing, alarm, external request) freezes the
+                history before it and keeps collecting until the post-trigger window
+                is complete, then hands the snapshot to a storage writer thread
+              - the blocks held at any time are bounded by event_capture_blocks_needed()
+*/
+
+#pragma once
+
+#include "utilities/block_pool/block_pool.h"
+#include "utilities/block_queue/block_queue.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVENT_CAPTURE_MAX_EVENTS        8
+#define EVENT_CAPTURE_MAX_PENDING       8       /* triggers queued from other threads */
+#define EVENT_CAPTURE_FILE_MAGIC        0x50414356u     /* "VCAP" */
+#define EVENT_CAPTURE_FILE_VERSION      1
+
+/* vcap_file_header_t flags */
+#define EVENT_FLAG_TRUNCATED            0x01    /* post window cut short (capacity or stop) */
+#define EVENT_FLAG_MERGED               0x02    /* overlapping triggers extended this event */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    EVENT_TRIGGER_LEVEL = 0,        /* a sample crossed level_lsb on any axis */
+    EVENT_TRIGGER_ALARM = 1,        /* raised by the analysis stages */
+    EVENT_TRIGGER_EXTERNAL = 2,     /* operator / PLC request */
+    EVENT_TRIGGER_COUNT
+} event_trigger_t;
+
+typedef struct
+{
+    uint32_t pre_ms;                /* history kept before the trigger */
+    uint32_t post_ms;               /* collected after the trigger */
+    uint32_t lag_ms;                /* how late a trigger may arrive after its timestamp (alarm path) */
+    uint32_t block_ns;              /* expected span of one block, sizes the reference arrays */
+    uint32_t max_events;            /* events collecting or waiting for storage, <= EVENT_CAPTURE_MAX_EVENTS */
+    int16_t level_lsb;              /* |raw| threshold on vib_sensor_data_t samples, 0 = no level trigger */
+    const char *dir;                /* event files go to <dir>/event_<id>.vcap */
+} event_capture_cfg_t;
+
+typedef struct
+{
+    uint64_t triggers[EVENT_TRIGGER_COUNT];
+    uint64_t merged;                /* triggers folded into an event still collecting */
+    uint64_t dropped;               /* triggers lost because every event slot was busy */
+    uint64_t refused;               /* event_capture_trigger() calls refused, EVENT_CAPTURE_MAX_PENDING already queued */
+    uint64_t written;               /* events stored */
+    uint64_t write_errors;
+    uint32_t refs_held;             /* block references held right now (history + events) */
+    uint32_t refs_held_max;         /* never above event_capture_blocks_needed() */
+} event_capture_stats_t;
+
+/* on-disk event, followed by n_blocks of (vcap_block_header_t, n_samples * sample_size bytes) */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t id;
+    uint64_t t_trigger_ns;          /* CLOCK_MONOTONIC, same clock as block timestamps */
+    uint32_t trigger;               /* event_trigger_t of the first trigger */
+    uint32_t flags;                 /* EVENT_FLAG_* */
+    uint32_t pre_ms;
+    uint32_t post_ms;
+    uint32_t n_blocks;
+    uint32_t sample_size;
+} vcap_file_header_t;
+
+typedef struct
+{
+    uint64_t seq;
+    uint64_t t_first_ns;
+    uint32_t dt_ns;
+    uint32_t n_samples;
+    uint32_t flags;                 /* BLOCK_FLAG_* */
+    uint32_t cfg_gen;               /* acquisition configuration generation, see sample_block_t */
+} vcap_block_header_t;
+
+typedef struct event_capture event_capture_t;
+
+/* worst-case number of pool blocks the stage holds for 'cfg', the pool must have this many spare */
+size_t event_capture_blocks_needed(const event_capture_cfg_t *cfg);
+
+event_capture_t* event_capture_init(const event_capture_cfg_t *cfg);
+
+/* stop first, releases every reference still held */
+int event_capture_free(event_capture_t *ec);
+
+/* start the stage thread on a block subscription and the storage writer */
+int event_capture_start(event_capture_t *ec, block_queue_t *queue);
+
+/* events still collecting are stored truncated, waits for the writer to finish and
+   returns the history to the pool; the owner drains the queue */
+int event_capture_stop(event_capture_t *ec);
+
+/* request a capture around 't_ns' from any thread; ERROR (counted as refused) while
+   EVENT_CAPTURE_MAX_PENDING requests are still waiting for the stage thread */
+int event_capture_trigger(event_capture_t *ec, event_trigger_t trigger, uint64_t t_ns);
+
+/* new level threshold in raw counts, used from the first block with cfg_gen >= 'from_gen' on
+   (a full-scale change rescales the counts) */
+int event_capture_set_level(event_capture_t *ec, int16_t level_lsb, uint32_t from_gen);
+
+int event_capture_stats(event_capture_t *ec, event_capture_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,448 @@
+#define _GNU_SOURCE     /* accept4 */
+#include "modbus_server.h"
+#include "apps/vib_sensor_acq/vib_sensor_acq.h"
+#include "analysis/features/vib_features.h"
+#include "common_def.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define MODBUS_EVENT_LISTEN         0xFFFFFFFFu
+#define MODBUS_EVENT_WAKE           0xFFFFFFFEu
+#define MODBUS_EPOLL_BATCH          32
+#define MODBUS_TX_LEN               (4 * MODBUS_MAX_ADU_LEN)
+
+typedef struct
+{
+    int fd;                             /* -1 when slot is free */
+    uint8_t rx[MODBUS_MAX_ADU_LEN];     /* partial request bytes */
+    size_t rx_len;
+    uint8_t tx[MODBUS_TX_LEN];          /* responses the socket has not taken yet */
+    size_t tx_len;
+    uint32_t events;                    /* epoll events currently armed */
+} modbus_client_t;
+
+static modbus_client_t clients[MODBUS_MAX_CLIENTS];
+static snapshot_t *mb_features = NULL;
+static trend_store_t *mb_trend = NULL;
+
+static int listen_fd = -1;
+static int epoll_fd = -1;
+static int wake_fd = -1;
+static uint16_t bound_port = 0;
+
+static pthread_t mb_thread;
+static _Atomic bool mb_run = false;
+
+static inline void put_u16(uint8_t *dst, uint16_t val)
+{
+    dst[0] = (uint8_t)(val >> 8);
+    dst[1] = (uint8_t)(val & 0xFF);
+}
+
+static inline uint16_t get_u16(const uint8_t *src)
+{
+    return (uint16_t)((src[0] << 8) | src[1]);
+}
+
+static inline void put_reg_u32(uint16_t *regs, size_t idx, uint32_t val)
+{
+    regs[idx] = (uint16_t)(val >> 16);
+    regs[idx + 1] = (uint16_t)(val & 0xFFFF);
+}
+
+static inline void put_reg_f32(uint16_t *regs, size_t idx, float val)
+{
+    uint32_t raw;
+    memcpy(&raw, &val, sizeof(raw));
+    put_reg_u32(regs, idx, raw);
+}
+
+static void put_trend_rms(trend_store_t *trend, uint32_t tier, uint16_t *regs, size_t idx)
+{
+    trend_point_t point;
+    for (int a = 0; a < VIB_FEATURES_AXES; a++)
+    {
+        if (trend_store_latest(trend, tier, VIB_CH_RMS_X + a, &point) == OK)
+        {
+            put_reg_f32(regs, idx + 2 * a, point.mean);
+        }
+    }
+}
+
+/* copy the latest features (wait-free w.r.t. the publisher) into a register image */
+static void build_register_image(snapshot_t *features, trend_store_t *trend, uint16_t *regs)
+{
+    vib_features_t feat;
+    uint64_t generation = 0;
+
+    memset(regs, 0, MODBUS_REG_COUNT * sizeof(uint16_t));
+    regs[MODBUS_REG_PUBLISH_AGE_MS] = 0xFFFF;
+
+    if (trend)
+    {
+        put_trend_rms(trend, VIB_ACQ_TREND_TIER_1MIN, regs, MODBUS_REG_TREND_1MIN_RMS_X);
+        put_trend_rms(trend, VIB_ACQ_TREND_TIER_1H, regs, MODBUS_REG_TREND_1H_RMS_X);
+    }
+
+    if (!features || snapshot_read(features, &feat, &generation) != OK || generation == 0) return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t now_ns = (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+    uint64_t age_ms = (now_ns > feat.timestamp_ns) ? (now_ns - feat.timestamp_ns) / 1000000ull : 0;
+
+    put_reg_u32(regs, MODBUS_REG_BLOCK_SEQ, feat.block_seq);
+    regs[MODBUS_REG_ALARM_STATE] = (uint16_t)feat.alarm_state;
+    regs[MODBUS_REG_PUBLISH_AGE_MS] = (age_ms > 0xFFFF) ? 0xFFFF : (uint16_t)age_ms;
+
+    for (int a = 0; a < VIB_FEATURES_AXES; a++)
+    {
+        put_reg_f32(regs, MODBUS_REG_RMS_X + 2 * a, feat.rms[a]);
+        put_reg_f32(regs, MODBUS_REG_PEAK_X + 2 * a, feat.peak[a]);
+    }
+
+    for (int b = 0; b < VIB_FEATURES_BANDS; b++)
+    {
+        put_reg_f32(regs, MODBUS_REG_BAND_ENERGY_0 + 2 * b, feat.band_energy[b]);
+    }
+}
+
+static int exception_pdu(uint8_t fc, uint8_t code, uint8_t *resp)
+{
+    resp[0] = fc | 0x80;
+    resp[1] = code;
+    return 2;
+}
+
+int modbus_server_process_pdu(snapshot_t *features, 
+                              trend_store_t *trend,
+                              const uint8_t *req, 
+                              size_t req_len, 
+                              uint8_t *resp)
+{
+    if (!req || !resp || req_len < 1) return ERROR;
+
+    const uint8_t fc = req[0];
+    if (fc != MODBUS_FC_READ_HOLDING && fc != MODBUS_FC_READ_INPUT)
+    {
+        return exception_pdu(fc, MODBUS_EX_ILLEGAL_FUNCTION, resp);
+    }
+
+    if (req_len != 5) return exception_pdu(fc, MODBUS_EX_ILLEGAL_VALUE, resp);
+
+    const uint16_t start = get_u16(&req[1]);
+    const uint16_t qty = get_u16(&req[3]);
+
+    if (qty == 0 || qty > MODBUS_MAX_READ_REGS) return exception_pdu(fc, MODBUS_EX_ILLEGAL_VALUE, resp);
+    if ((uint32_t)start + qty > MODBUS_REG_COUNT) return exception_pdu(fc, MODBUS_EX_ILLEGAL_ADDRESS, resp);
+
+    uint16_t regs[MODBUS_REG_COUNT];
+    build_register_image(features, trend, regs);
+
+    resp[0] = fc;
+    resp[1] = (uint8_t)(qty * 2);
+    for (uint16_t i = 0; i < qty; i++)
+    {
+        put_u16(&resp[2 + 2 * i], regs[start + i]);
+    }
+
+    return 2 + 2 * qty;
+}
+
+static void client_close(uint32_t slot)
+{
+    modbus_client_t *c = &clients[slot];
+    if (c->fd < 0) return;
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+    c->rx_len = 0;
+    c->tx_len = 0;
+}
+
+static int client_set_events(uint32_t slot, uint32_t events)
+{
+    if (clients[slot].events == events) return OK;
+
+    struct epoll_event ev = { .events = events, .data.u32 = slot };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, clients[slot].fd, &ev) < 0) return ERROR;
+    clients[slot].events = events;
+
+    return OK;
+}
+
+/* push queued response bytes; returns ERROR if the peer is gone */
+static int client_flush(uint32_t slot)
+{
+    modbus_client_t *c = &clients[slot];
+
+    while (c->tx_len > 0)
+    {
+        ssize_t n = send(c->fd, c->tx, c->tx_len, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return ERROR;
+        }
+
+        memmove(c->tx, c->tx + n, c->tx_len - (size_t)n);
+        c->tx_len -= (size_t)n;
+    }
+
+    /* stop reading new requests while responses are backed up */
+    return client_set_events(slot, c->tx_len ? EPOLLOUT : EPOLLIN);
+}
+
+/* answer every complete ADU in the rx buffer, stopping if the tx buffer fills */
+static int client_process(uint32_t slot)
+{
+    modbus_client_t *c = &clients[slot];
+    size_t off = 0;
+
+    while (c->rx_len - off >= MODBUS_MBAP_LEN)
+    {
+        const uint8_t *adu = c->rx + off;
+        const uint16_t protocol = get_u16(&adu[2]);
+        const uint16_t length = get_u16(&adu[4]);   /* unit id + PDU */
+
+        if (protocol != 0 || length < 2 || length > MODBUS_MAX_ADU_LEN - 6) return ERROR;
+
+        const size_t adu_len = 6 + (size_t)length;
+        if (c->rx_len - off < adu_len) break;
+        if (MODBUS_TX_LEN - c->tx_len < MODBUS_MAX_ADU_LEN) break;  /* apply backpressure */
+
+        uint8_t *out = c->tx + c->tx_len;
+        int pdu_len = modbus_server_process_pdu(mb_features, mb_trend, &adu[MODBUS_MBAP_LEN], length - 1, &out[MODBUS_MBAP_LEN]);
+        if (pdu_len < 0) return ERROR;
+
+        memcpy(out, adu, 4);                        /* transaction id, protocol id */
+        put_u16(&out[4], (uint16_t)(pdu_len + 1));
+        out[6] = adu[6];                            /* unit id */
+        c->tx_len += MODBUS_MBAP_LEN + (size_t)pdu_len;
+
+        off += adu_len;
+    }
+
+    if (off > 0)
+    {
+        memmove(c->rx, c->rx + off, c->rx_len - off);
+        c->rx_len -= off;
+    }
+
+    return client_flush(slot);
+}
+
+static void client_readable(uint32_t slot)
+{
+    modbus_client_t *c = &clients[slot];
+
+    while (c->rx_len < sizeof(c->rx))
+    {
+        ssize_t n = recv(c->fd, c->rx + c->rx_len, sizeof(c->rx) - c->rx_len, MSG_DONTWAIT);
+        if (n == 0)
+        {
+            client_close(slot);
+            return;
+        }
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            client_close(slot);
+            return;
+        }
+        c->rx_len += (size_t)n;
+    }
+
+    if (client_process(slot) != OK) client_close(slot);
+}
+
+static void accept_clients(void)
+{
+    while (1)
+    {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR) continue;
+            return; /* EAGAIN or transient error, wait for the next event */
+        }
+
+        uint32_t slot = 0;
+        while (slot < MODBUS_MAX_CLIENTS && clients[slot].fd >= 0) slot++;
+        if (slot == MODBUS_MAX_CLIENTS)
+        {
+            fprintf(stderr, "MODBUS: client limit reached, rejecting connection\n");
+            close(fd);
+            continue;
+        }
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = slot };
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            close(fd);
+            continue;
+        }
+
+        clients[slot].fd = fd;
+        clients[slot].rx_len = 0;
+        clients[slot].tx_len = 0;
+        clients[slot].events = EPOLLIN;
+    }
+}
+
+/* Server Thread */
+static void *server_thread(void *arg)
+{
+    struct epoll_event events[MODBUS_EPOLL_BATCH];
+
+    while (atomic_load(&mb_run))
+    {
+        int n = epoll_wait(epoll_fd, events, MODBUS_EPOLL_BATCH, -1);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "MODBUS: epoll_wait failed\n");
+            break;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            uint32_t tag = events[i].data.u32;
+
+            if (tag == MODBUS_EVENT_WAKE) continue;
+            if (tag == MODBUS_EVENT_LISTEN)
+            {
+                accept_clients();
+                continue;
+            }
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                client_close(tag);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                /* backlog drained, resume any requests that were held back */
+                if (client_flush(tag) != OK || client_process(tag) != OK)
+                {
+                    client_close(tag);
+                    continue;
+                }
+            }
+            if (events[i].events & EPOLLIN) client_readable(tag);
+        }
+    }
+
+    return NULL;
+}
+
+static void server_cleanup(void)
+{
+    for (uint32_t i = 0; i < MODBUS_MAX_CLIENTS; i++) client_close(i);
+    if (listen_fd >= 0) close(listen_fd);
+    if (wake_fd >= 0) close(wake_fd);
+    if (epoll_fd >= 0) close(epoll_fd);
+    listen_fd = wake_fd = epoll_fd = -1;
+    bound_port = 0;
+}
+
+int modbus_server_start(uint16_t port, snapshot_t *features, trend_store_t *trend)
+{
+    if (!features || atomic_load(&mb_run)) return ERROR;
+
+    mb_features = features;
+    mb_trend = trend;
+    for (uint32_t i = 0; i < MODBUS_MAX_CLIENTS; i++) clients[i].fd = -1;
+
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (listen_fd < 0 || epoll_fd < 0 || wake_fd < 0)
+    {
+        fprintf(stderr, "MODBUS: failed to create server fds\n");
+        server_cleanup();
+        return ERROR;
+    }
+
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, MODBUS_MAX_CLIENTS) < 0)
+    {
+        fprintf(stderr, "MODBUS: failed to bind port %u\n", port);
+        server_cleanup();
+        return ERROR;
+    }
+
+    socklen_t addr_len = sizeof(addr);
+    getsockname(listen_fd, (struct sockaddr *)&addr, &addr_len);
+    bound_port = ntohs(addr.sin_port);
+
+    struct epoll_event ev = { .events = EPOLLIN, .data.u32 = MODBUS_EVENT_LISTEN };
+    struct epoll_event wake_ev = { .events = EPOLLIN, .data.u32 = MODBUS_EVENT_WAKE };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) < 0 ||
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_ev) < 0)
+    {
+        server_cleanup();
+        return ERROR;
+    }
+
+    atomic_store(&mb_run, true);
+    if (pthread_create(&mb_thread, NULL, server_thread, NULL) != 0)
+    {
+        atomic_store(&mb_run, false);
+        server_cleanup();
+        return ERROR;
+    }
+
+    fprintf(stdout, "MODBUS: serving features on port %u\n", bound_port);
+
+    return OK;
+}
+
+uint16_t modbus_server_port(void)
+{
+    return bound_port;
+}
+
+int modbus_server_stop(void)
+{
+    if (!atomic_load(&mb_run)) return ERROR;
+
+    atomic_store(&mb_run, false);
+
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) < 0) return ERROR;
+    if (pthread_join(mb_thread, NULL) != 0) return ERROR;
+
+    server_cleanup();
+    mb_features = NULL;
+    mb_trend = NULL;
+
+    return OK;
+}
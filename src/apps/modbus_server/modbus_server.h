@@ -0,0 +1,69 @@
+/* 
+Description : Modbus TCP server publishing live vibration features to PLC/SCADA pollers
+*/
+
+#pragma once
+
+#include "utilities/snapshot/snapshot.h"
+#include "utilities/trend_store/trend_store.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MODBUS_TCP_PORT                 502
+#define MODBUS_MAX_CLIENTS              64
+#define MODBUS_MBAP_LEN                 7       /* transaction, protocol, length, unit */
+#define MODBUS_MAX_ADU_LEN              260
+#define MODBUS_MAX_READ_REGS            125
+
+/* function codes */
+#define MODBUS_FC_READ_HOLDING          0x03
+#define MODBUS_FC_READ_INPUT            0x04
+
+/* exception codes */
+#define MODBUS_EX_ILLEGAL_FUNCTION      0x01
+#define MODBUS_EX_ILLEGAL_ADDRESS       0x02
+#define MODBUS_EX_ILLEGAL_VALUE         0x03
+
+/* register map, identical for holding (FC03) and input (FC04) registers
+ - u32 and float32 values take two registers, high word first
+*/
+#define MODBUS_REG_BLOCK_SEQ            0       /* u32 */
+#define MODBUS_REG_ALARM_STATE          2       /* u16, VIB_ALARM_* bits */
+#define MODBUS_REG_PUBLISH_AGE_MS       3       /* u16, ms since last publish, saturates */
+#define MODBUS_REG_RMS_X                4       /* float32 g, Y at +2, Z at +4 */
+#define MODBUS_REG_PEAK_X               10      /* float32 g, Y at +2, Z at +4 */
+#define MODBUS_REG_BAND_ENERGY_0        16      /* float32 g^2, VIB_FEATURES_BANDS entries */
+#define MODBUS_REG_TREND_1MIN_RMS_X     32      /* float32 g, mean RMS of last closed minute, Y/Z follow */
+#define MODBUS_REG_TREND_1H_RMS_X       38      /* float32 g, mean RMS of last closed hour, Y/Z follow */
+#define MODBUS_REG_COUNT                44
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ build the response PDU for a request PDU using a feature snapshot and
+ optional trend store (NULL leaves the trend registers at 0)
+ - req/req_len : PDU (function code + data), no MBAP header
+ - resp        : at least MODBUS_MAX_ADU_LEN bytes
+ - returns response PDU length, or ERROR if the request is malformed beyond reply
+*/
+int modbus_server_process_pdu(snapshot_t *features, 
+                              trend_store_t *trend,
+                              const uint8_t *req, 
+                              size_t req_len, 
+                              uint8_t *resp);
+
+/* start the epoll server thread on 'port' (0 = ephemeral) serving 'features' and 'trend' (optional) */
+int modbus_server_start(uint16_t port, snapshot_t *features, trend_store_t *trend);
+
+/* bound TCP port of the running server */
+uint16_t modbus_server_port(void);
+
+/* stop the server thread and close all client connections */
+int modbus_server_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
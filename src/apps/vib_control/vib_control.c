@@ -0,0 +1,458 @@
+#define _GNU_SOURCE     /* accept4 */
+#include "vib_control.h"
+#include "common_def.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define VIB_CONTROL_PATH_MAX        108     /* sun_path */
+#define VIB_CONTROL_INOTIFY_BUF     4096
+
+/* poll slots : wake, listen, inotify, then clients */
+#define VIB_CONTROL_SLOT_WAKE       0
+#define VIB_CONTROL_SLOT_LISTEN     1
+#define VIB_CONTROL_SLOT_INOTIFY    2
+#define VIB_CONTROL_SLOT_CLIENT     3
+
+typedef struct
+{
+    int fd;                             /* -1 when slot is free */
+    char rx[VIB_CONTROL_MAX_LINE];      /* partial command line */
+    size_t rx_len;
+} ctl_client_t;
+
+static ctl_client_t clients[VIB_CONTROL_MAX_CLIENTS];
+static vib_control_ops_t ctl_ops;
+
+static char sock_file[VIB_CONTROL_PATH_MAX];
+static char cfg_file[VIB_CONTROL_PATH_MAX];
+static const char *cfg_name = NULL;     /* basename inside cfg_file */
+
+static int listen_fd = -1;
+static int inotify_fd = -1;
+static int wake_fd = -1;
+
+static pthread_t ctl_thread;
+static _Atomic bool ctl_run = false;
+
+static const struct { const char *name; iis3dwb_fs_t fs; } fs_names[] = {
+    { "2", IIS3DWB_FS_2G }, { "4", IIS3DWB_FS_4G }, { "8", IIS3DWB_FS_8G }, { "16", IIS3DWB_FS_16G },
+};
+
+static const char* fs_name(iis3dwb_fs_t fs)
+{
+    for (size_t i = 0; i < sizeof(fs_names) / sizeof(fs_names[0]); i++)
+    {
+        if (fs_names[i].fs == fs) return fs_names[i].name;
+    }
+    return "?";
+}
+
+static int parse_uint(const char *val, unsigned long max, unsigned long *out)
+{
+    char *end = NULL;
+    errno = 0;
+    const unsigned long v = strtoul(val, &end, 10);
+    if (errno || end == val || *end != '\0' || v > max || val[0] == '-') return ERROR;
+
+    *out = v;
+    return OK;
+}
+
+static int parse_float(const char *val, float *out)
+{
+    char *end = NULL;
+    errno = 0;
+    const float v = strtof(val, &end);
+    if (errno || end == val || *end != '\0') return ERROR;
+
+    *out = v;
+    return OK;
+}
+
+static int apply_kv(vib_acq_cfg_t *cfg, const char *key, const char *val)
+{
+    unsigned long u = 0;
+
+    if (strcmp(key, "fs") == 0)
+    {
+        for (size_t i = 0; i < sizeof(fs_names) / sizeof(fs_names[0]); i++)
+        {
+            if (strcmp(val, fs_names[i].name) == 0)
+            {
+                cfg->fs = fs_names[i].fs;
+                return OK;
+            }
+        }
+        return ERROR;
+    }
+    if (strcmp(key, "lpf2") == 0)
+    {
+        if (parse_uint(val, 1, &u) != OK) return ERROR;
+        cfg->lpf2_en = (uint8_t)u;
+        return OK;
+    }
+    if (strcmp(key, "wtm") == 0)
+    {
+        if (parse_uint(val, UINT16_MAX, &u) != OK) return ERROR;
+        cfg->fifo_watermark = (uint16_t)u;
+        return OK;
+    }
+    if (strcmp(key, "rms_warning") == 0) return parse_float(val, &cfg->rms_warning_g);
+    if (strcmp(key, "rms_danger") == 0) return parse_float(val, &cfg->rms_danger_g);
+
+    return ERROR;
+}
+
+int vib_control_parse(const char *text, vib_acq_cfg_t *cfg)
+{
+    if (!text || !cfg) return ERROR;
+
+    vib_acq_cfg_t next = *cfg;
+    const char *p = text;
+    while (*p)
+    {
+        if (isspace((unsigned char)*p))
+        {
+            p++;
+            continue;
+        }
+        if (*p == '#')
+        {
+            while (*p && *p != '\n') p++;
+            continue;
+        }
+
+        /* one key=value token */
+        char tok[VIB_CONTROL_MAX_LINE];
+        size_t n = 0;
+        while (p[n] && !isspace((unsigned char)p[n]) && p[n] != '#') n++;
+        if (n >= sizeof(tok)) return ERROR;
+        memcpy(tok, p, n);
+        tok[n] = '\0';
+        p += n;
+
+        char *eq = strchr(tok, '=');
+        if (!eq || eq == tok) return ERROR;
+        *eq = '\0';
+        if (apply_kv(&next, tok, eq + 1) != OK) return ERROR;
+    }
+
+    *cfg = next;
+
+    return OK;
+}
+
+int vib_control_format(const vib_acq_cfg_t *cfg, uint32_t gen, char *buf, size_t len)
+{
+    if (!cfg || !buf || len == 0) return ERROR;
+
+    const int n = snprintf(buf, len, "gen=%u fs=%s lpf2=%u wtm=%u rms_warning=%.3f rms_danger=%.3f",
+                           gen, fs_name(cfg->fs), cfg->lpf2_en, cfg->fifo_watermark, cfg->rms_warning_g, cfg->rms_danger_g);
+    if (n < 0 || (size_t)n >= len) return ERROR;
+
+    return n;
+}
+
+int vib_control_process_line(const vib_control_ops_t *ops, const char *line, char *resp, size_t resp_len)
+{
+    if (!ops || !ops->get || !ops->apply || !line || !resp || resp_len < 2) return ERROR;
+
+    while (isspace((unsigned char)*line)) line++;
+
+    vib_acq_cfg_t cfg;
+    uint32_t gen = 0;
+    const char *reply = NULL;
+    char body[VIB_CONTROL_MAX_LINE];
+
+    if (ops->get(&cfg, &gen) != OK)
+    {
+        reply = "err unavailable";
+    }
+    else if (strncmp(line, "get", 3) == 0 && (line[3] == '\0' || isspace((unsigned char)line[3])))
+    {
+        if (vib_control_format(&cfg, gen, body, sizeof(body)) < 0) reply = "err format";
+    }
+    else if (strncmp(line, "set", 3) == 0 && isspace((unsigned char)line[3]))
+    {
+        if (vib_control_parse(line + 4, &cfg) != OK) reply = "err invalid setting";
+        else if (ops->apply(&cfg, &gen) != OK) reply = "err rejected";
+        else snprintf(body, sizeof(body), "gen=%u", gen);
+    }
+    else
+    {
+        reply = "err unknown command";
+    }
+
+    const int n = reply ? snprintf(resp, resp_len, "%s\n", reply) : snprintf(resp, resp_len, "ok %s\n", body);
+    if (n < 0 || (size_t)n >= resp_len) return ERROR;
+
+    return n;
+}
+
+/* whole file as one set of key=value tokens over the current configuration */
+static void reload_file(void)
+{
+    FILE *f = fopen(cfg_file, "r");
+    if (!f) return;
+
+    char text[VIB_CONTROL_MAX_FILE];
+    const size_t n = fread(text, 1, sizeof(text) - 1, f);
+    const bool truncated = !feof(f);
+    fclose(f);
+    text[n] = '\0';
+
+    vib_acq_cfg_t cfg;
+    uint32_t gen = 0;
+    if (truncated || ctl_ops.get(&cfg, &gen) != OK || vib_control_parse(text, &cfg) != OK)
+    {
+        fprintf(stderr, "CONTROL: %s not applied, invalid\n", cfg_file);
+        return;
+    }
+    if (ctl_ops.apply(&cfg, &gen) != OK)
+    {
+        fprintf(stderr, "CONTROL: %s rejected\n", cfg_file);
+        return;
+    }
+
+    fprintf(stdout, "CONTROL: %s applied, generation %u\n", cfg_file, gen);
+}
+
+static void client_close(ctl_client_t *c)
+{
+    close(c->fd);
+    c->fd = -1;
+    c->rx_len = 0;
+}
+
+/* answer every complete line received, a client overflowing one line is dropped */
+static void client_service(ctl_client_t *c)
+{
+    const ssize_t got = recv(c->fd, c->rx + c->rx_len, sizeof(c->rx) - 1 - c->rx_len, 0);
+    if (got <= 0)
+    {
+        if (got < 0 && (errno == EAGAIN || errno == EINTR)) return;
+        client_close(c);
+        return;
+    }
+    c->rx_len += (size_t)got;
+    c->rx[c->rx_len] = '\0';
+
+    char *line = c->rx;
+    char *nl = NULL;
+    while ((nl = strchr(line, '\n')) != NULL)
+    {
+        *nl = '\0';
+        if (nl > line && nl[-1] == '\r') nl[-1] = '\0';
+
+        char resp[VIB_CONTROL_MAX_LINE];
+        const int n = vib_control_process_line(&ctl_ops, line, resp, sizeof(resp));
+        if (n > 0 && send(c->fd, resp, (size_t)n, MSG_NOSIGNAL) != n)
+        {
+            client_close(c);
+            return;
+        }
+        line = nl + 1;
+    }
+
+    c->rx_len = strlen(line);
+    memmove(c->rx, line, c->rx_len);
+    if (c->rx_len == sizeof(c->rx) - 1) client_close(c);
+}
+
+static void inotify_service(void)
+{
+    char buf[VIB_CONTROL_INOTIFY_BUF] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+
+    ssize_t len;
+    while ((len = read(inotify_fd, buf, sizeof(buf))) > 0)
+    {
+        for (char *p = buf; p < buf + len; )
+        {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            if (ev->len && strcmp(ev->name, cfg_name) == 0) changed = true;
+            p += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+
+    if (changed) reload_file();
+}
+
+static void *control_thread(void *arg)
+{
+    (void)arg;
+    struct pollfd fds[VIB_CONTROL_SLOT_CLIENT + VIB_CONTROL_MAX_CLIENTS];
+
+    while (atomic_load(&ctl_run))
+    {
+        fds[VIB_CONTROL_SLOT_WAKE] = (struct pollfd){ .fd = wake_fd, .events = POLLIN };
+        fds[VIB_CONTROL_SLOT_LISTEN] = (struct pollfd){ .fd = listen_fd, .events = POLLIN };
+        fds[VIB_CONTROL_SLOT_INOTIFY] = (struct pollfd){ .fd = inotify_fd, .events = POLLIN };
+        for (size_t i = 0; i < VIB_CONTROL_MAX_CLIENTS; i++)
+        {
+            fds[VIB_CONTROL_SLOT_CLIENT + i] = (struct pollfd){ .fd = clients[i].fd, .events = POLLIN };
+        }
+
+        /* negative fds are ignored by poll */
+        if (poll(fds, VIB_CONTROL_SLOT_CLIENT + VIB_CONTROL_MAX_CLIENTS, -1) < 0)
+        {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "CONTROL: poll failed\n");
+            break;
+        }
+        if (fds[VIB_CONTROL_SLOT_WAKE].revents) break;
+
+        if (fds[VIB_CONTROL_SLOT_INOTIFY].revents & POLLIN) inotify_service();
+
+        for (size_t i = 0; i < VIB_CONTROL_MAX_CLIENTS; i++)
+        {
+            if (clients[i].fd >= 0 && fds[VIB_CONTROL_SLOT_CLIENT + i].revents) client_service(&clients[i]);
+        }
+
+        if (fds[VIB_CONTROL_SLOT_LISTEN].revents & POLLIN)
+        {
+            const int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) continue;
+
+            size_t slot = 0;
+            while (slot < VIB_CONTROL_MAX_CLIENTS && clients[slot].fd >= 0) slot++;
+            if (slot == VIB_CONTROL_MAX_CLIENTS)
+            {
+                close(fd);
+                continue;
+            }
+            clients[slot].fd = fd;
+            clients[slot].rx_len = 0;
+        }
+    }
+
+    return NULL;
+}
+
+static void control_cleanup(void)
+{
+    for (size_t i = 0; i < VIB_CONTROL_MAX_CLIENTS; i++)
+    {
+        if (clients[i].fd >= 0) client_close(&clients[i]);
+    }
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        unlink(sock_file);
+    }
+    if (inotify_fd >= 0) close(inotify_fd);
+    if (wake_fd >= 0) close(wake_fd);
+    listen_fd = -1;
+    inotify_fd = -1;
+    wake_fd = -1;
+}
+
+static int socket_open(const char *path)
+{
+    if (strlen(path) >= sizeof(sock_file)) return ERROR;
+    strcpy(sock_file, path);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) return ERROR;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strcpy(addr.sun_path, sock_file);
+
+    /* a stale socket file from an earlier run would fail the bind */
+    unlink(sock_file);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, VIB_CONTROL_MAX_CLIENTS) < 0)
+    {
+        fprintf(stderr, "CONTROL: failed to bind %s\n", sock_file);
+        return ERROR;
+    }
+
+    return OK;
+}
+
+/* watch the directory : editors and deploy tools replace the file by rename */
+static int watch_open(const char *path)
+{
+    if (strlen(path) >= sizeof(cfg_file)) return ERROR;
+    strcpy(cfg_file, path);
+
+    char dir[VIB_CONTROL_PATH_MAX];
+    const char *slash = strrchr(cfg_file, '/');
+    if (slash)
+    {
+        const size_t n = (slash == cfg_file) ? 1 : (size_t)(slash - cfg_file);
+        memcpy(dir, cfg_file, n);
+        dir[n] = '\0';
+        cfg_name = slash + 1;
+    }
+    else
+    {
+        strcpy(dir, ".");
+        cfg_name = cfg_file;
+    }
+
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0 || inotify_add_watch(inotify_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        fprintf(stderr, "CONTROL: failed to watch %s\n", dir);
+        return ERROR;
+    }
+
+    return OK;
+}
+
+int vib_control_start(const char *sock_path, const char *cfg_path, const vib_control_ops_t *ops)
+{
+    if (!ops || !ops->get || !ops->apply || (!sock_path && !cfg_path) || atomic_load(&ctl_run)) return ERROR;
+
+    ctl_ops = *ops;
+    for (size_t i = 0; i < VIB_CONTROL_MAX_CLIENTS; i++) clients[i].fd = -1;
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0 || (sock_path && socket_open(sock_path) != OK) || (cfg_path && watch_open(cfg_path) != OK))
+    {
+        control_cleanup();
+        return ERROR;
+    }
+
+    /* the file holds the settings to run with, not only changes made while running */
+    if (cfg_path) reload_file();
+
+    atomic_store(&ctl_run, true);
+    if (pthread_create(&ctl_thread, NULL, control_thread, NULL) != 0)
+    {
+        atomic_store(&ctl_run, false);
+        control_cleanup();
+        return ERROR;
+    }
+
+    return OK;
+}
+
+int vib_control_stop(void)
+{
+    if (!atomic_load(&ctl_run)) return ERROR;
+
+    atomic_store(&ctl_run, false);
+
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) < 0) return ERROR;
+    if (pthread_join(ctl_thread, NULL) != 0) return ERROR;
+
+    control_cleanup();
+
+    return OK;
+}
@@ -0,0 +1,51 @@
+/*
+Description : runtime control of the acquisition pipeline without stopping it
+              - local Unix stream socket, one text command per line :
+                  get                     -> ok gen=<n> fs=<g> lpf2=<0|1> wtm=<words> rms_warning=<g> rms_danger=<g>
+                  set <key>=<value> ...   -> ok gen=<n>  |  err <reason>
+              - a key=value config file ('#' comments) applied at start and whenever
+                it is rewritten or replaced (inotify on its directory)
+              - keys : fs (2, 4, 8, 16), lpf2, wtm, rms_warning, rms_danger
+*/
+
+#pragma once
+
+#include "apps/vib_sensor_acq/vib_sensor_acq.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define VIB_CONTROL_SOCKET              "/run/edge/vib_ctl.sock"
+#define VIB_CONTROL_CFG_FILE            "/etc/edge/vib_acq.conf"
+#define VIB_CONTROL_MAX_LINE            256
+#define VIB_CONTROL_MAX_CLIENTS         4
+#define VIB_CONTROL_MAX_FILE            4096
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* where settings come from and go to, normally vib_sensor_acq_config / vib_sensor_acq_reconfigure */
+typedef struct
+{
+    int (*get)(vib_acq_cfg_t *cfg, uint32_t *gen);
+    int (*apply)(const vib_acq_cfg_t *cfg, uint32_t *gen);
+} vib_control_ops_t;
+
+/* apply whitespace separated key=value tokens over 'cfg'; on ERROR 'cfg' is left untouched */
+int vib_control_parse(const char *text, vib_acq_cfg_t *cfg);
+
+/* "gen=<n> fs=..." as returned by get, returns the length or ERROR */
+int vib_control_format(const vib_acq_cfg_t *cfg, uint32_t gen, char *buf, size_t len);
+
+/* answer one command line (no newline needed), returns the response length including its newline */
+int vib_control_process_line(const vib_control_ops_t *ops, const char *line, char *resp, size_t resp_len);
+
+/* start the control thread; either path may be NULL to leave that interface out */
+int vib_control_start(const char *sock_path, const char *cfg_path, const vib_control_ops_t *ops);
+
+int vib_control_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
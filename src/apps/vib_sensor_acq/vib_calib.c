@@ -0,0 +1,274 @@
+#include "vib_calib.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define VIB_CALIB_MAGIC             0x5643414Cu     /* "VCAL" */
+#define VIB_CALIB_VERSION           2u              /* 2 : queue depth in blocks, was ring samples */
+#define VIB_CALIB_BURSTS            16              /* bursts timed per batch size */
+#define VIB_CALIB_QUEUE_BURSTS      4               /* subscriber queues hold this many FIFO bursts */
+
+/* candidate clocks, ascending */
+static const uint32_t sweep_speeds[VIB_CALIB_MAX_SPEEDS] = {
+    1000000, 2000000, 4000000, 5000000, 8000000, 10000000, 16000000, 20000000
+};
+
+/* candidate watermarks, ascending, all below IIS3DWB_FIFO_MAX_WORDS */
+static const uint16_t sweep_batches[VIB_CALIB_MAX_BATCHES] = {
+    16, 32, 64, 128, 192, 256
+};
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    char spi_path[64];
+    uint32_t max_speed_hz;
+    uint32_t target_latency_us;
+    vib_calib_profile_t profile;
+    uint32_t checksum;
+} vib_calib_file_t;
+
+static uint64_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000ull;
+}
+
+static uint32_t checksum(const void *data, size_t len)
+{
+    /* FNV-1a */
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*
+ clock choice : the last clock that passed sits next to the failure edge, so when the
+ sweep found a failing clock step back one more for cable/temperature margin.
+ Two cases keep the last clock that passed instead
+ - nothing failed : the sweep stopped at max_speed_hz, no edge was found to keep away from
+ - only the slowest clock passed : there is no step below it, it is also the safe clock
+ returns index into results->speed_hz or -1 if nothing passed
+*/
+static int pick_speed(const vib_calib_results_t *results)
+{
+    int first_fail = -1;
+    for (int i = 0; i < results->n_speeds; i++)
+    {
+        if (results->link_errors[i] != 0)
+        {
+            first_fail = i;
+            break;
+        }
+    }
+
+    if (first_fail < 0) return results->n_speeds - 1;
+    if (first_fail == 0) return -1;
+    return (first_fail >= 2) ? first_fail - 2 : first_fail - 1;
+}
+
+int vib_calib_measure(vib_sensor_t *dev, const vib_calib_cfg_t *cfg, vib_calib_results_t *results)
+{
+    if (!dev || !cfg || !results || cfg->link_rounds == 0) return ERROR;
+
+    memset(results, 0, sizeof(*results));
+
+    /* 1 : clock sweep, stop at the first clock that corrupts */
+    for (int i = 0; i < VIB_CALIB_MAX_SPEEDS && sweep_speeds[i] <= cfg->max_speed_hz; i++)
+    {
+        uint16_t errors = cfg->link_rounds;
+        if (spi_set_speed(dev->spi, sweep_speeds[i]) == OK) vib_sensor_link_test(dev, cfg->link_rounds, &errors);
+
+        results->speed_hz[i] = sweep_speeds[i];
+        results->link_errors[i] = errors;
+        results->n_speeds++;
+
+        fprintf(stdout, "VIB_CALIB: %8u Hz : %u/%u link errors\n", sweep_speeds[i], errors, cfg->link_rounds);
+        if (errors) break;
+    }
+
+    int speed_idx = pick_speed(results);
+    if (speed_idx < 0)
+    {
+        fprintf(stderr, "VIB_CALIB: no reliable SPI clock\n");
+        spi_set_speed(dev->spi, VIB_CALIB_SAFE_SPEED_HZ);
+        return ERROR;
+    }
+    if (spi_set_speed(dev->spi, results->speed_hz[speed_idx]) != OK) return ERROR;
+
+    /* 2 : burst timing per batch size at the chosen clock (FIFO in bypass, content ignored) */
+    static vib_sensor_data_t scratch[IIS3DWB_FIFO_MAX_WORDS];
+    for (int b = 0; b < VIB_CALIB_MAX_BATCHES; b++)
+    {
+        uint32_t worst = 0;
+        for (int k = 0; k < VIB_CALIB_BURSTS; k++)
+        {
+            uint16_t n = 0;
+            uint64_t t0 = monotonic_us();
+            if (vib_sensor_fifo_read(dev, scratch, sweep_batches[b], &n) != OK) return ERROR;
+            uint32_t dt = (uint32_t)(monotonic_us() - t0);
+            if (dt > worst) worst = dt;
+        }
+
+        results->batch_words[b] = sweep_batches[b];
+        results->batch_xfer_us[b] = worst;
+        results->n_batches++;
+
+        fprintf(stdout, "VIB_CALIB: batch %3u words : %u us worst\n", sweep_batches[b], worst);
+    }
+
+    return OK;
+}
+
+int vib_calib_choose(const vib_calib_cfg_t *cfg, const vib_calib_results_t *results, vib_calib_profile_t *profile)
+{
+    if (!cfg || !results || !profile || results->n_speeds == 0 || results->n_batches == 0) return ERROR;
+
+    int speed_idx = pick_speed(results);
+    if (speed_idx < 0) return ERROR;
+
+    /*
+     batch choice, per batch size b :
+      - latency  = time to fill b words at the ODR + burst transfer time
+      - headroom = transfer must take at most half the fill time, leaving CPU/bus for the rest
+     take the largest b within the latency budget (fewest transfers); if none fits, take the
+     smallest b that still keeps up and report the miss
+    */
+    int best = -1;
+    int fallback = -1;
+    for (int b = 0; b < results->n_batches; b++)
+    {
+        const uint32_t words = results->batch_words[b];
+        const uint32_t fill_us = (uint32_t)(((uint64_t)words * 1000000ull) / IIS3DWB_ODR_HZ);
+        const uint32_t xfer_us = results->batch_xfer_us[b];
+        if (xfer_us * 2 > fill_us) continue;
+
+        if (fallback < 0) fallback = b;
+        if (fill_us + xfer_us <= cfg->target_latency_us) best = b;
+    }
+
+    if (best < 0)
+    {
+        if (fallback < 0)
+        {
+            fprintf(stderr, "VIB_CALIB: no batch size keeps up with the ODR\n");
+            return ERROR;
+        }
+        fprintf(stderr, "VIB_CALIB: latency target %u us not reachable, using smallest sustainable batch\n", 
+            cfg->target_latency_us);
+        best = fallback;
+    }
+
+    profile->speed_hz = results->speed_hz[speed_idx];
+    profile->fifo_watermark = results->batch_words[best];
+    profile->queue_depth = VIB_CALIB_QUEUE_BURSTS;
+    profile->batch_xfer_us = results->batch_xfer_us[best];
+
+    return OK;
+}
+
+static void file_fill(vib_calib_file_t *file, const char *spi_path, const vib_calib_cfg_t *cfg)
+{
+    memset(file, 0, sizeof(*file));
+    file->magic = VIB_CALIB_MAGIC;
+    file->version = VIB_CALIB_VERSION;
+    strncpy(file->spi_path, spi_path, sizeof(file->spi_path) - 1);
+    file->max_speed_hz = cfg->max_speed_hz;
+    file->target_latency_us = cfg->target_latency_us;
+}
+
+int vib_calib_profile_load(const char *path, const char *spi_path, const vib_calib_cfg_t *cfg, vib_calib_profile_t *profile)
+{
+    if (!path || !spi_path || !cfg || !profile) return ERROR;
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return ERROR;
+
+    vib_calib_file_t file;
+    size_t n = fread(&file, 1, sizeof(file), fp);
+    fclose(fp);
+    if (n != sizeof(file)) return ERROR;
+
+    /* a profile is only valid for the same bus and the same calibration request */
+    vib_calib_file_t expect;
+    file_fill(&expect, spi_path, cfg);
+    if (file.magic != expect.magic || file.version != expect.version ||
+        strncmp(file.spi_path, expect.spi_path, sizeof(file.spi_path)) != 0 ||
+        file.max_speed_hz != expect.max_speed_hz || file.target_latency_us != expect.target_latency_us ||
+        file.checksum != checksum(&file, offsetof(vib_calib_file_t, checksum)))
+    {
+        return ERROR;
+    }
+
+    *profile = file.profile;
+
+    return OK;
+}
+
+int vib_calib_profile_save(const char *path, const char *spi_path, const vib_calib_cfg_t *cfg, const vib_calib_profile_t *profile)
+{
+    if (!path || !spi_path || !cfg || !profile) return ERROR;
+
+    vib_calib_file_t file;
+    file_fill(&file, spi_path, cfg);
+    file.profile = *profile;
+    file.checksum = checksum(&file, offsetof(vib_calib_file_t, checksum));
+
+    FILE *fp = fopen(path, "wb");
+    if (!fp)
+    {
+        fprintf(stderr, "VIB_CALIB: cannot write profile %s\n", path);
+        return ERROR;
+    }
+
+    size_t n = fwrite(&file, 1, sizeof(file), fp);
+    int ret = fclose(fp);
+
+    return (n == sizeof(file) && ret == 0) ? OK : ERROR;
+}
+
+int vib_calib_run(vib_sensor_t *dev, const char *spi_path, const vib_calib_cfg_t *cfg, vib_calib_profile_t *profile)
+{
+    if (!dev || !spi_path || !cfg || !profile) return ERROR;
+
+    /* stored profile : confirm the link still holds at its clock, else recalibrate */
+    if (!cfg->force && cfg->profile_path &&
+        vib_calib_profile_load(cfg->profile_path, spi_path, cfg, profile) == OK)
+    {
+        uint16_t errors = 1;
+        if (spi_set_speed(dev->spi, profile->speed_hz) == OK &&
+            vib_sensor_link_test(dev, cfg->link_rounds, &errors) == OK && errors == 0)
+        {
+            fprintf(stdout, "VIB_CALIB: using stored profile (%u Hz, watermark %u)\n", 
+                profile->speed_hz, profile->fifo_watermark);
+            return OK;
+        }
+
+        fprintf(stderr, "VIB_CALIB: stored profile failed link test, recalibrating\n");
+        spi_set_speed(dev->spi, VIB_CALIB_SAFE_SPEED_HZ);
+    }
+
+    vib_calib_results_t results;
+    if (vib_calib_measure(dev, cfg, &results) != OK) return ERROR;
+    if (vib_calib_choose(cfg, &results, profile) != OK) return ERROR;
+    if (spi_set_speed(dev->spi, profile->speed_hz) != OK) return ERROR;
+
+    fprintf(stdout, "VIB_CALIB: chose %u Hz, watermark %u, queues of %u blocks\n", 
+        profile->speed_hz, profile->fifo_watermark, profile->queue_depth);
+
+    /* not fatal, the next boot sweeps again */
+    if (cfg->profile_path && vib_calib_profile_save(cfg->profile_path, spi_path, cfg, profile) != OK)
+    {
+        fprintf(stderr, "VIB_CALIB: failed to save profile to %s, next start will recalibrate\n", cfg->profile_path);
+    }
+
+    return OK;
+}
@@ -0,0 +1,68 @@
+/* 
+Description : startup auto-calibration of SPI clock, FIFO watermark and subscriber queue depth
+              - sweeps SPI clocks upwards checking WHO_AM_I / register readback
+              - times FIFO burst transfers per batch size at the chosen clock
+              - picks the largest batch meeting a latency target, persists the result
+*/
+
+#pragma once
+
+#include "sensors/vibration/vib_sensor.h"
+#include "common_def.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define VIB_CALIB_SAFE_SPEED_HZ         1000000     /* sensor is opened here before the sweep */
+#define VIB_CALIB_PROFILE_PATH          "/var/lib/edge/vib_calib.prof"
+#define VIB_CALIB_MAX_SPEEDS            8
+#define VIB_CALIB_MAX_BATCHES           6
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t max_speed_hz;          /* upper bound of the clock sweep */
+    uint32_t target_latency_us;     /* sample-in-FIFO to sample-in-block budget */
+    uint16_t link_rounds;           /* link test rounds per clock */
+    const char *profile_path;       /* NULL : neither load nor store a profile */
+    uint8_t force;                  /* 1 : ignore a stored profile */
+} vib_calib_cfg_t;
+
+typedef struct
+{
+    uint32_t speed_hz;
+    uint16_t fifo_watermark;        /* words per FIFO burst */
+    uint16_t queue_depth;           /* blocks per subscriber queue, one FIFO burst each */
+    uint32_t batch_xfer_us;         /* worst measured burst at the chosen watermark */
+} vib_calib_profile_t;
+
+typedef struct
+{
+    uint8_t n_speeds;
+    uint32_t speed_hz[VIB_CALIB_MAX_SPEEDS];
+    uint16_t link_errors[VIB_CALIB_MAX_SPEEDS];     /* sweep stops after the first failing clock */
+
+    uint8_t n_batches;
+    uint16_t batch_words[VIB_CALIB_MAX_BATCHES];
+    uint32_t batch_xfer_us[VIB_CALIB_MAX_BATCHES];  /* worst of several bursts */
+} vib_calib_results_t;
+
+/* use a stored profile when it matches, otherwise measure, choose and store */
+int vib_calib_run(vib_sensor_t *dev, const char *spi_path, const vib_calib_cfg_t *cfg, vib_calib_profile_t *profile);
+
+/* hardware measurements, leaves the bus at the clock the batch timings were taken at */
+int vib_calib_measure(vib_sensor_t *dev, const vib_calib_cfg_t *cfg, vib_calib_results_t *results);
+
+/* pure decision step over measured results */
+int vib_calib_choose(const vib_calib_cfg_t *cfg, const vib_calib_results_t *results, vib_calib_profile_t *profile);
+
+int vib_calib_profile_load(const char *path, const char *spi_path, const vib_calib_cfg_t *cfg, vib_calib_profile_t *profile);
+
+int vib_calib_profile_save(const char *path, const char *spi_path, const vib_calib_cfg_t *cfg, const vib_calib_profile_t *profile);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,66 +1,624 @@
 #include "vib_sensor_acq.h"
 #include "drivers/SPI/spi_driver.h"
+#include "drivers/I2C/i2c_driver.h"
+#include "drivers/GPIO/gpio_driver.h"
 #include "sensors/vibration/vib_sensor.h"
-#include "utilities/ring_buffer/ring_buffer.h"
+#include "sensors/hal/sensor_hal.h"
+#include "utilities/block_pool/block_pool.h"
+#include "utilities/block_queue/block_queue.h"
+#include "utilities/snapshot/snapshot.h"
+#include "utilities/trend_store/trend_store.h"
+#include "utilities/latency_hist/latency_hist.h"
+#include "utilities/trace/trace.h"
+#include "utilities/timer_wheel/timer_wheel.h"
+#include "utilities/rcu_cfg/rcu_cfg.h"
+#include "analysis/features/vib_features.h"
+#include "analysis/frame/vib_frame.h"
+#include "analysis/inference/nn_model.h"
+#include "analysis/order/order_track.h"
+#include "apps/event_capture/event_capture.h"
+#include "apps/demod_select/demod_select.h"
 
 #include <pthread.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <string.h>
+#include <time.h>
 #include <stdatomic.h>
 #include <stdbool.h>
 
+#define VIB_ACQ_FEATURE_BLOCK_LEN       1024    /* ~38 ms at 26.667 kHz */
+#define VIB_ACQ_RMS_WARNING_G           0.7f
+#define VIB_ACQ_RMS_DANGER_G            1.8f
+#define VIB_ACQ_TREND_PATH              "/var/lib/edge/vib_trend.db"
+#define VIB_ACQ_MODEL_PATH              "/var/lib/edge/vib_model.nn8"
+#define VIB_ACQ_DEFAULT_WATERMARK       128     /* FIFO words per burst without calibration */
+#define VIB_ACQ_POOL_BLOCKS             64      /* one FIFO burst per block, ~200 KB */
+#define VIB_ACQ_MAX_SUBSCRIBERS         8
+#define VIB_ACQ_MIN_QUEUE_DEPTH         4
+#define VIB_ACQ_SAMPLE_PERIOD_NS        (1000000000u / IIS3DWB_ODR_HZ)
+#define VIB_ACQ_WHEEL_TICK_MS           10
+#define VIB_ACQ_COSENSOR_BUDGET         1       /* co-sensor reads per idle poll */
+#define VIB_ACQ_PARK_POLL_MS            100     /* parked producer : co-sensors, wake-up flag, stop */
+#define VIB_ACQ_CAPTURE_LAG_MS          ((VIB_ACQ_FEATURE_BLOCK_LEN * 1000 / IIS3DWB_ODR_HZ) + 1)  /* alarm decided after its block end */
+#define VIB_ACQ_LATENCY_PENDING         128     /* blocks awaiting an alarm decision, >= feature block / min watermark */
+#define VIB_ACQ_DEFAULT_FS              IIS3DWB_FS_2G
+#define VIB_ACQ_CFG_RETRY_MS            100     /* failed register update, FIFO stays in bypass until then */
+#define VIB_ACQ_RCU_PRODUCER            0       /* vib_cfg readers */
+#define VIB_ACQ_RCU_CONSUMER            1
+#define VIB_ACQ_RCU_READERS             2
+
+/* ~4 MB on disk : 1 h of seconds, 7 d of minutes, 90 d of hours, 2 y of days */
+static const trend_store_cfg_t vib_trend_cfg = {
+    .n_channels = VIB_CH_COUNT,
+    .n_tiers = 4,
+    .tier = {
+        [VIB_ACQ_TREND_TIER_1S]   = { .period_ms = 1000,     .slots = 3600 },
+        [VIB_ACQ_TREND_TIER_1MIN] = { .period_ms = 60000,    .slots = 10080 },
+        [VIB_ACQ_TREND_TIER_1H]   = { .period_ms = 3600000,  .slots = 2160 },
+        [VIB_ACQ_TREND_TIER_1D]   = { .period_ms = 86400000, .slots = 730 },
+    },
+};
+
+typedef struct
+{
+    block_queue_t *queue;
+    _Atomic uint64_t dropped;       /* blocks not delivered because the queue was full */
+} vib_subscriber_t;
+
+typedef struct
+{
+    sensor_dev_t *dev;
+    i2c_handle_t *i2c;
+    snapshot_t *snap;               /* latest vib_cosensor_sample_t */
+    _Atomic uint64_t reads;
+    _Atomic uint64_t errors;
+} vib_cosensor_t;
+
 static vib_sensor_t *vib_sensor = NULL; 
-static ring_buffer_t *vib_rb;
+static sensor_dev_t *vib_dev = NULL;           /* HAL view of vib_sensor for the FIFO path */
+static block_pool_t *vib_pool = NULL;
+static vib_subscriber_t vib_subs[VIB_ACQ_MAX_SUBSCRIBERS];
+static size_t vib_n_subs = 0;
+static block_queue_t *vib_feat_queue = NULL;   /* internal feature stage subscription */
+static size_t vib_queue_depth = VIB_ACQ_MIN_QUEUE_DEPTH;
+
+static _Atomic uint64_t vib_blocks = 0;
+static _Atomic uint64_t vib_samples = 0;
+static _Atomic uint64_t vib_dropped_samples = 0;
+static _Atomic uint64_t vib_fifo_overruns = 0;
+static _Atomic uint64_t vib_feature_gaps = 0;
+
+static vib_features_ctx_t *vib_features = NULL;
+static snapshot_t *vib_features_snap = NULL;
+static trend_store_t *vib_trend = NULL;
+static nn_model_t *vib_model = NULL;            /* optional fault model over the feature channels */
+static snapshot_t *vib_infer_snap = NULL;
+static latency_hist_t *vib_alarm_latency = NULL;   /* first sample of a block -> alarm decided on it */
+
+static uint16_t vib_fifo_wtm = VIB_ACQ_DEFAULT_WATERMARK;
+static vib_frame_t vib_frame;                   /* SoA view of the block being analysed, consumer only */
+static vib_sensor_data_t vib_fifo_scratch[IIS3DWB_FIFO_MAX_WORDS];    /* drain target when the pool is empty */
+
+static vib_cosensor_t vib_cosensors[VIB_ACQ_MAX_COSENSORS];
+static size_t vib_n_cosensors = 0;
+static timer_wheel_t *vib_wheel = NULL;        /* co-sensor schedule, driven by the producer loop */
+
+/* duty-cycled capture, period_ms 0 = continuous */
+static vib_duty_cfg_t vib_duty = {0};
+static pthread_mutex_t vib_park_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t vib_park_cond;
+static _Atomic bool vib_capturing = true;
+static _Atomic uint64_t vib_windows = 0;
+static _Atomic uint64_t vib_wake_triggers = 0;
+static _Atomic uint64_t vib_active_ns = 0;         /* closed capture windows */
+static _Atomic uint64_t vib_parked_ns = 0;         /* closed parked intervals */
+static _Atomic uint64_t vib_phase_since_ns = 0;    /* start of the current window / parked interval */
+
+static event_capture_t *vib_capture = NULL;      /* optional raw capture around events */
+static block_queue_t *vib_capture_queue = NULL;
+static float vib_capture_level_g = 0.0f;
+
+/* runtime configuration : published by vib_sensor_acq_reconfigure(), applied by the producer,
+   followed by the feature stage through the generation on each block */
+static rcu_cfg_t *vib_cfg = NULL;
+static pthread_mutex_t vib_cfg_lock = PTHREAD_MUTEX_INITIALIZER;   /* reconfigure callers */
+static vib_acq_cfg_t vib_cfg_req;                /* latest published, under vib_cfg_lock */
+static uint32_t vib_cfg_req_gen = 0;
+static uint16_t vib_fifo_wtm_min = VIB_ACQ_DEFAULT_WATERMARK;      /* pool and queue sizing assume at least this */
+static _Atomic uint32_t vib_cfg_applied = 0;
+static _Atomic uint64_t vib_cfg_errors = 0;
+static _Atomic uint64_t vib_cfg_skipped = 0;
+
+static demod_select_t *vib_demod = NULL;         /* optional kurtogram worker */
+static block_queue_t *vib_demod_queue = NULL;
+
+static gpio_handle_t *vib_tach = NULL;          /* optional tachometer, read by the consumer */
+static order_track_t *vib_orders = NULL;
+static snapshot_t *vib_orders_snap = NULL;      /* latest order_features_t */
+static _Atomic uint64_t vib_tach_pulses = 0;
+static _Atomic uint64_t vib_tach_lost = 0;
+static uint32_t vib_tach_seqno = 0;             /* last edge seqno, consumer only */
 
 static pthread_t vib_prod_thread;
 static pthread_t vib_cons_thread;
 
 static _Atomic bool v_run = false; 
 
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t monotonic_ms(void)
+{
+    return monotonic_ns() / 1000000ull;
+}
+
+/* timer wheel callback : one co-sensor reading */
+static void cosensor_poll(void *arg, uint64_t now_ms)
+{
+    vib_cosensor_t *cs = (vib_cosensor_t *)arg;
+    vib_cosensor_sample_t sample = {0};
+
+    if (sensor_read(cs->dev, sample.values) != OK)
+    {
+        atomic_fetch_add_explicit(&cs->errors, 1, memory_order_relaxed);
+        return;
+    }
+
+    sample.timestamp_ns = monotonic_ns();
+    snapshot_publish(cs->snap, &sample);
+    atomic_fetch_add_explicit(&cs->reads, 1, memory_order_relaxed);
+}
+
+/* sleep until 'deadline_ns' (CLOCK_MONOTONIC), a window opening or stop */
+static void park_until(uint64_t deadline_ns)
+{
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadline_ns / 1000000000ull),
+        .tv_nsec = (long)(deadline_ns % 1000000000ull),
+    };
+
+    pthread_mutex_lock(&vib_park_lock);
+    if (atomic_load(&v_run) && !atomic_load(&vib_capturing)) pthread_cond_timedwait(&vib_park_cond, &vib_park_lock, &ts);
+    pthread_mutex_unlock(&vib_park_lock);
+}
+
+static void park_wake_all(void)
+{
+    pthread_mutex_lock(&vib_park_lock);
+    pthread_cond_broadcast(&vib_park_cond);
+    pthread_mutex_unlock(&vib_park_lock);
+}
+
+/* move between capture and parked, accounting the time spent in the phase being left */
+static void duty_phase(bool capturing)
+{
+    const uint64_t now = monotonic_ns();
+    const uint64_t spent = now - atomic_exchange(&vib_phase_since_ns, now);
+    atomic_fetch_add(capturing ? &vib_parked_ns : &vib_active_ns, spent);
+    atomic_store(&vib_capturing, capturing);
+    if (capturing) park_wake_all();
+}
+
+/* power up (unless kept on for wake-up detection), settle, restart the FIFO empty */
+static int window_open(void)
+{
+    if (vib_duty.wake_threshold_g == 0.0f)
+    {
+        if (vib_sensor_power(vib_sensor, 1) != OK) return ERROR;
+        usleep(vib_duty.settle_ms * 1000u);
+    }
+
+    if (vib_sensor_fifo_config(vib_sensor, 0) != OK || vib_sensor_fifo_config(vib_sensor, vib_fifo_wtm) != OK) return ERROR;
+
+    atomic_fetch_add(&vib_windows, 1);
+    duty_phase(true);
+
+    return OK;
+}
+
+/* stop batching and power down; with a wake-up threshold the sensor stays on, only the FIFO stops */
+static void window_close(void)
+{
+    vib_sensor_fifo_config(vib_sensor, 0);
+    if (vib_duty.wake_threshold_g == 0.0f) vib_sensor_power(vib_sensor, 0);
+    else
+    {
+        /* WU_IA is latched : a crossing inside this window was captured already, reading the
+           source clears it so only crossings while parked open the next window early */
+        uint8_t stale = 0;
+        vib_sensor_wakeup_status(vib_sensor, &stale);
+    }
+
+    duty_phase(false);
+}
+
+/* hand one reference of 'blk' to every subscriber, the producer's own reference is consumed */
+static void fan_out(sample_block_t *blk)
+{
+    if (vib_n_subs == 0)
+    {
+        block_release(blk);
+        return;
+    }
+
+    block_ref(blk, (uint32_t)(vib_n_subs - 1));
+    for (size_t i = 0; i < vib_n_subs; i++)
+    {
+        if (block_queue_push(vib_subs[i].queue, blk) != OK)
+        {
+            atomic_fetch_add_explicit(&vib_subs[i].dropped, 1, memory_order_relaxed);
+            block_release(blk);
+        }
+    }
+}
+
+/*
+ move the sensor from 'from' to 'to' between two FIFO bursts
+ - scale / filter : FIFO to bypass first so no sample taken at the old setting is drained under
+   the new generation; an LPF2 switch also discards the filter settling time without sleeping
+ - on failure the FIFO is left in bypass, the caller retries the whole sequence
+*/
+static int apply_sensor_cfg(const vib_acq_cfg_t *from, const vib_acq_cfg_t *to, uint32_t *flags, uint64_t *settle_until_ns)
+{
+    if (to->fs != from->fs || to->lpf2_en != from->lpf2_en)
+    {
+        *flags |= BLOCK_FLAG_GAP;
+        if (vib_sensor_fifo_config(vib_sensor, 0) != OK) return ERROR;
+        if (vib_sensor_config(vib_sensor, to->fs, to->lpf2_en) != OK) return ERROR;
+
+        /* the wake-up threshold register counts in fractions of the full scale */
+        if (vib_duty.period_ms && vib_duty.wake_threshold_g > 0.0f &&
+            vib_sensor_wakeup_config(vib_sensor, vib_duty.wake_threshold_g) != OK) return ERROR;
+
+        if (to->lpf2_en != from->lpf2_en) *settle_until_ns = monotonic_ns() + IIS3DWB_SETTLE_MS * 1000000ull;
+    }
+    else if (to->fifo_watermark == from->fifo_watermark)
+    {
+        return OK;
+    }
+
+    if (vib_sensor_fifo_config(vib_sensor, to->fifo_watermark) != OK)
+    {
+        vib_sensor_fifo_config(vib_sensor, 0);
+        *flags |= BLOCK_FLAG_GAP;
+        return ERROR;
+    }
+    vib_fifo_wtm = to->fifo_watermark;
+
+    return OK;
+}
+
 /* Producer Thread */
 static void *producer_thread(void *arg)
 {
-    vib_sensor_data_t read_sample; 
+    /* poll at half the time the FIFO needs to reach the watermark */
+    useconds_t poll_us = (useconds_t)(((uint32_t)vib_fifo_wtm * 1000000u) / IIS3DWB_ODR_HZ / 2);
+    uint32_t pending_flags = 0;
+    uint64_t seq = 0;
+    const bool duty = vib_duty.period_ms > 0;
+    uint64_t window_start_ms = monotonic_ms();
+
+    /* configuration the sensor registers currently hold */
+    uint32_t applied_gen = 0;
+    vib_acq_cfg_t applied = *(const vib_acq_cfg_t *)rcu_cfg_read(vib_cfg, VIB_ACQ_RCU_PRODUCER, &applied_gen);
+    rcu_cfg_quiescent(vib_cfg, VIB_ACQ_RCU_PRODUCER);
+    uint64_t settle_until_ns = 0;
+    uint64_t cfg_retry_ms = 0;
+
+    trace_thread_register("vib_producer");
+
     while (atomic_load(&v_run))
     {
-        uint8_t ready = 0; 
-        vib_sensor_is_data_ready(vib_sensor, &ready); 
-        if (!ready)
+        /* parked between capture windows : only co-sensors and the wake-up flag are serviced */
+        if (duty && !atomic_load(&vib_capturing))
+        {
+            rcu_cfg_quiescent(vib_cfg, VIB_ACQ_RCU_PRODUCER);
+            const uint64_t now_ms = monotonic_ms();
+            const uint64_t next_ms = window_start_ms + vib_duty.period_ms;
+            uint8_t triggered = 0;
+            if (vib_duty.wake_threshold_g > 0.0f) vib_sensor_wakeup_status(vib_sensor, &triggered);
+
+            if (now_ms >= next_ms || triggered)
+            {
+                if (triggered) atomic_fetch_add(&vib_wake_triggers, 1);
+                if (window_open() != OK)
+                {
+                    fprintf(stderr, "[VIB_ACQ] capture window failed to open\n");
+                    window_start_ms = now_ms;
+                    continue;
+                }
+                window_start_ms = now_ms;
+                pending_flags |= BLOCK_FLAG_GAP;
+                continue;
+            }
+
+            if (vib_wheel) timer_wheel_advance(vib_wheel, now_ms, 0);
+            const uint64_t wait_ms = (next_ms - now_ms < VIB_ACQ_PARK_POLL_MS) ? next_ms - now_ms : VIB_ACQ_PARK_POLL_MS;
+            park_until(monotonic_ns() + wait_ms * 1000000ull);
+            continue;
+        }
+
+        if (duty && monotonic_ms() - window_start_ms >= vib_duty.settle_ms + vib_duty.capture_ms)
         {
-            usleep(200);
+            window_close();
+            continue;
+        }
+
+        /* configuration changes land between bursts, never inside one */
+        uint32_t gen = 0;
+        const vib_acq_cfg_t *want = rcu_cfg_read(vib_cfg, VIB_ACQ_RCU_PRODUCER, &gen);
+        if (gen != applied_gen && monotonic_ms() >= cfg_retry_ms)
+        {
+            if (apply_sensor_cfg(&applied, want, &pending_flags, &settle_until_ns) == OK)
+            {
+                applied = *want;
+                applied_gen = gen;
+                atomic_store(&vib_cfg_applied, gen);
+                poll_us = (useconds_t)(((uint32_t)vib_fifo_wtm * 1000000u) / IIS3DWB_ODR_HZ / 2);
+            }
+            else
+            {
+                atomic_fetch_add_explicit(&vib_cfg_errors, 1, memory_order_relaxed);
+                cfg_retry_ms = monotonic_ms() + VIB_ACQ_CFG_RETRY_MS;
+            }
+        }
+        rcu_cfg_quiescent(vib_cfg, VIB_ACQ_RCU_PRODUCER);
+
+        uint16_t level = 0;
+        uint8_t overrun = 0;
+        if (sensor_stream_level(vib_dev, &level, &overrun) != OK || level < vib_fifo_wtm)
+        {
+            /* low-rate sensors only get the idle time between FIFO bursts */
+            if (vib_wheel) timer_wheel_advance(vib_wheel, monotonic_ms(), VIB_ACQ_COSENSOR_BUDGET);
+            usleep(poll_us);
             continue; 
         }
 
-        /* read sensor */
-        if (vib_sensor_read(vib_sensor, &read_sample) == OK)
+        if (overrun)
+        {
+            atomic_fetch_add_explicit(&vib_fifo_overruns, 1, memory_order_relaxed);
+            pending_flags |= BLOCK_FLAG_OVERRUN | BLOCK_FLAG_GAP;
+        }
+
+        /* drain everything available in one burst straight into a pool block */
+        uint16_t words = (level > IIS3DWB_FIFO_MAX_WORDS) ? IIS3DWB_FIFO_MAX_WORDS : level;
+        uint16_t n_samples = 0;
+        TRACE_BEGIN(TRACE_FIFO_DRAIN, seq);
+        sample_block_t *blk = block_pool_acquire(vib_pool);
+        if (!blk)
+        {
+            /* pool exhausted : keep the FIFO from overrunning, account the loss on the next block */
+            if (sensor_stream_read(vib_dev, vib_fifo_scratch, words, &n_samples) == OK)
+            {
+                atomic_fetch_add_explicit(&vib_dropped_samples, n_samples, memory_order_relaxed);
+            }
+            TRACE_END(TRACE_FIFO_DRAIN, seq);
+            pending_flags |= BLOCK_FLAG_GAP;
+            continue;
+        }
+
+        if (sensor_stream_read(vib_dev, blk->data, words, &n_samples) != OK || n_samples == 0)
+        {
+            TRACE_END(TRACE_FIFO_DRAIN, seq);
+            block_release(blk);
+            continue;
+        }
+        TRACE_END(TRACE_FIFO_DRAIN, seq);
+
+        /* the newest sample left the FIFO just now, earlier ones are one ODR period apart */
+        blk->seq = seq++;
+        blk->n_samples = n_samples;
+        blk->dt_ns = VIB_ACQ_SAMPLE_PERIOD_NS;
+        blk->t_first_ns = monotonic_ns() - (uint64_t)(n_samples - 1) * VIB_ACQ_SAMPLE_PERIOD_NS;
+        blk->flags = pending_flags;
+        blk->cfg_gen = applied_gen;
+
+        /* the LPF2 output is still settling after a filter switch */
+        if (blk->t_first_ns < settle_until_ns)
         {
-            ring_buffer_push(vib_rb, &read_sample);
+            atomic_fetch_add_explicit(&vib_dropped_samples, n_samples, memory_order_relaxed);
+            block_release(blk);
+            continue;
         }
+        pending_flags = 0;
+
+        atomic_fetch_add_explicit(&vib_blocks, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&vib_samples, n_samples, memory_order_relaxed);
 
+        TRACE_BEGIN(TRACE_BLOCK_PUSH, blk->seq);
+        fan_out(blk);
+        TRACE_END(TRACE_BLOCK_PUSH, blk->seq);
     }
 
+    trace_thread_unregister();
     return NULL;
 }
 
+/* trend history spans reboots, so it is keyed on wall clock time */
+static uint64_t realtime_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
+}
+
+/* tach edges up to now, then the frame, then every order spectrum both now cover */
+static void order_update(const vib_frame_t *frame)
+{
+    gpio_edge_t edges[16];
+    size_t n = 0;
+
+    while (gpio_edge_read(vib_tach, edges, 16, &n) == OK && n > 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            /* a lost edge would read as half speed : restart from the next pulse */
+            if (vib_tach_seqno && edges[i].seqno != vib_tach_seqno + 1)
+            {
+                atomic_fetch_add_explicit(&vib_tach_lost, 1, memory_order_relaxed);
+                order_track_reset(vib_orders);
+            }
+            vib_tach_seqno = edges[i].seqno;
+            order_track_add_edge(vib_orders, edges[i].timestamp_ns);
+        }
+        atomic_fetch_add_explicit(&vib_tach_pulses, n, memory_order_relaxed);
+    }
+
+    if (order_track_add_frame(vib_orders, frame) != OK) return;
+
+    uint8_t ready = 0;
+    order_features_t orders;
+    while (order_track_process(vib_orders, &ready, &orders) == OK && ready) snapshot_publish(vib_orders_snap, &orders);
+}
+
 /* Consumer Thread */
 static void *consumer_thread(void *arg)
 {
-    vib_sensor_data_t write_sample; 
+    sample_block_t *blk = NULL;
+    vib_features_t features;
+    uint32_t prev_alarm = 0;
+
+    /* acquisition blocks whose samples have not all reached an alarm decision yet */
+    struct { uint64_t t_first_ns; uint64_t end_pos; } pending[VIB_ACQ_LATENCY_PENDING];
+    size_t p_head = 0, p_count = 0;
+    uint64_t pos = 0;               /* samples consumed so far */
+
+    /* configuration of the blocks being analysed, switched on the generation carried by each block */
+    uint32_t cfg_gen = 0;
+    vib_acq_cfg_t cfg = *(const vib_acq_cfg_t *)rcu_cfg_read(vib_cfg, VIB_ACQ_RCU_CONSUMER, &cfg_gen);
+    rcu_cfg_quiescent(vib_cfg, VIB_ACQ_RCU_CONSUMER);
+    bool cfg_gap = false;
+
+    /* blocks dropped on this stage's full queue leave a hole in seq only, the shared flags cannot say so */
+    uint64_t next_seq = 0;
+    bool have_seq = false;
+
+    trace_thread_register("vib_features");
+
     while (atomic_load(&v_run))
     {
-        if (ring_buffer_pop(vib_rb, &write_sample) == OK)
+        if (block_queue_pop(vib_feat_queue, &blk) != OK)
         {
-            /* TODO : user app logic here */
-            fprintf(stdout,"[VIB_ACQ : CONSUMER] X = %d ; Y = %d ; Z = %d\n", 
-                write_sample.accel_x, write_sample.accel_y, write_sample.accel_z);
+            rcu_cfg_quiescent(vib_cfg, VIB_ACQ_RCU_CONSUMER);
+            if (atomic_load(&vib_capturing)) usleep(500);
+            else park_until(monotonic_ns() + VIB_ACQ_PARK_POLL_MS * 1000000ull);
+            continue;
         }
-        else
+        TRACE_INSTANT(TRACE_BLOCK_POP, blk->seq);
+        const bool seq_gap = have_seq && blk->seq != next_seq;
+        have_seq = true;
+        next_seq = blk->seq + 1;
+
+        if (blk->cfg_gen != cfg_gen)
         {
-            usleep(500);
+            uint32_t gen = 0;
+            const vib_acq_cfg_t *next = rcu_cfg_read(vib_cfg, VIB_ACQ_RCU_CONSUMER, &gen);
+            if (gen != blk->cfg_gen)
+            {
+                /* captured under a generation replaced before this stage saw it : its settings are gone */
+                rcu_cfg_quiescent(vib_cfg, VIB_ACQ_RCU_CONSUMER);
+                atomic_fetch_add_explicit(&vib_cfg_skipped, 1, memory_order_relaxed);
+                cfg_gap = true;
+                block_release(blk);
+                continue;
+            }
+
+            /* scaling or filtering changed : nothing accumulated so far may mix with the new blocks */
+            cfg_gap |= (next->fs != cfg.fs || next->lpf2_en != cfg.lpf2_en);
+            cfg = *next;
+            cfg_gen = gen;
+            rcu_cfg_quiescent(vib_cfg, VIB_ACQ_RCU_CONSUMER);
+            vib_features_set_levels(vib_features, cfg.rms_warning_g, cfg.rms_danger_g);
         }
+        /* blocks are shared with the other subscribers, the flags are extended locally */
+        const uint32_t flags = blk->flags | ((cfg_gap || seq_gap) ? BLOCK_FLAG_GAP : 0);
+        cfg_gap = false;
+
+        /* never let a feature block span a discontinuity (window boundary, overrun, pool exhaustion,
+           configuration change, blocks dropped on the feature queue) */
+        if (flags & BLOCK_FLAG_GAP)
+        {
+            vib_features_reset(vib_features);
+            atomic_fetch_add_explicit(&vib_feature_gaps, 1, memory_order_relaxed);
+            p_count = 0;
+        }
+
+        if (p_count < VIB_ACQ_LATENCY_PENDING)
+        {
+            size_t slot = (p_head + p_count++) % VIB_ACQ_LATENCY_PENDING;
+            pending[slot].t_first_ns = blk->t_first_ns;
+            pending[slot].end_pos = pos + blk->n_samples;
+        }
+
+        /* one de-interleave-and-scale pass per block, the analysis stages only see the SoA frame */
+        TRACE_BEGIN(TRACE_FEATURES, blk->seq);
+        if (vib_frame_load(&vib_frame, (const vib_sensor_data_t *)blk->data, blk->n_samples, cfg.fs) != OK)
+        {
+            TRACE_END(TRACE_FEATURES, blk->seq);
+            pos += blk->n_samples;
+            block_release(blk);
+            continue;
+        }
+        vib_frame.t_first_ns = blk->t_first_ns;
+        vib_frame.dt_ns = blk->dt_ns;
+        vib_frame.flags = flags;
+
+        if (vib_orders) order_update(&vib_frame);
+
+        /* feature extraction, publish each completed block to snapshot readers */
+        size_t frame_pos = 0;
+        while (frame_pos < vib_frame.n_samples)
+        {
+            uint8_t ready = 0;
+            if (vib_features_add_frame(vib_features, &vib_frame, &frame_pos, &ready, &features) != OK) break;
+            if (!ready) continue;
+
+            snapshot_publish(vib_features_snap, &features);
+            TRACE_INSTANT(TRACE_ALARM, features.alarm_state);
+
+            /* a newly raised alarm level captures the waveform around it */
+            if (vib_capture && (features.alarm_state & ~prev_alarm))
+            {
+                event_capture_trigger(vib_capture, EVENT_TRIGGER_ALARM, features.timestamp_ns);
+            }
+            prev_alarm = features.alarm_state;
+
+            /* every block fully covered by this decision is done */
+            const uint64_t now_ns = monotonic_ns();
+            const uint64_t done = pos + frame_pos;
+            while (p_count > 0 && pending[p_head].end_pos <= done)
+            {
+                latency_hist_record(vib_alarm_latency, now_ns - pending[p_head].t_first_ns);
+                p_head = (p_head + 1) % VIB_ACQ_LATENCY_PENDING;
+                p_count--;
+            }
+
+            float channels[VIB_CH_COUNT];
+            if (vib_features_to_channels(&features, channels) != OK) continue;
+
+            if (vib_trend) trend_store_add(vib_trend, realtime_ms(), channels);
+
+            if (vib_model)
+            {
+                vib_inference_t inf = { .block_seq = features.block_seq };
+                TRACE_BEGIN(TRACE_INFERENCE, features.block_seq);
+                if (nn_model_run(vib_model, channels, &inf.result) == OK) snapshot_publish(vib_infer_snap, &inf);
+                TRACE_END(TRACE_INFERENCE, features.block_seq);
+            }
+        }
+
+        TRACE_END(TRACE_FEATURES, blk->seq);
+
+        pos += blk->n_samples;
+        block_release(blk);
     }
 
+    trace_thread_unregister();
     return NULL;
 }
 
@@ -69,25 +627,444 @@ int (vib_sensor_acq_init(const char *spi_path,
                          uint8_t mode, 
                          uint32_t speed,
                          uint8_t bits, 
-                         size_t rb_capacity))
+                         size_t queue_depth,
+                         const vib_calib_cfg_t *calib))
 {
-    if (!spi_path || rb_capacity == 0) return ERROR; 
+    if (!spi_path || queue_depth == 0) return ERROR; 
 
-    /* open sensor */
-    vib_sensor = vib_sensor_init(spi_path, mode, speed, bits);
+    /* open sensor, at a safe clock when calibration will pick the real one */
+    vib_sensor = vib_sensor_init(spi_path, mode, calib ? VIB_CALIB_SAFE_SPEED_HZ : speed, bits);
     if (!vib_sensor) return ERROR; 
 
+    vib_fifo_wtm = VIB_ACQ_DEFAULT_WATERMARK;
+    if (calib)
+    {
+        vib_calib_profile_t profile;
+        if (vib_calib_run(vib_sensor, spi_path, calib, &profile) != OK) return ERROR;
+        vib_fifo_wtm = profile.fifo_watermark;
+        queue_depth = profile.queue_depth;
+    }
+
     /* configure vibration sensor */
-    if (vib_sensor_config(vib_sensor, IIS3DWB_FS_2G, 0) != OK) return ERROR; 
+    if (vib_sensor_config(vib_sensor, VIB_ACQ_DEFAULT_FS, 0) != OK) return ERROR; 
+    if (vib_sensor_fifo_config(vib_sensor, vib_fifo_wtm) != OK) return ERROR;
+
+    /* the FIFO path goes through the HAL, the calibration above stays device specific */
+    const sensor_bus_t vib_bus = { .type = SENSOR_BUS_SPI, .spi = vib_sensor->spi };
+    vib_dev = sensor_attach(&iis3dwb_driver, &vib_bus, vib_sensor);
+    if (!vib_dev) return ERROR;
+
+    /* block pool : each FIFO burst lands in one block shared by every stage */
+    const block_pool_cfg_t pool_cfg = {
+        .n_blocks = VIB_ACQ_POOL_BLOCKS,
+        .payload_size = IIS3DWB_FIFO_MAX_WORDS * iis3dwb_driver.map->sample_size,
+        .policy = BLOCK_POOL_EXHAUST_DROP,
+        .wait_timeout_us = 0,
+    };
+    vib_pool = block_pool_init(&pool_cfg);
+    if (!vib_pool) return ERROR;
+
+    /* per-subscriber queue depth in blocks, deeper than the pool buys nothing */
+    vib_queue_depth = queue_depth;
+    if (vib_queue_depth < VIB_ACQ_MIN_QUEUE_DEPTH) vib_queue_depth = VIB_ACQ_MIN_QUEUE_DEPTH;
+    if (vib_queue_depth > VIB_ACQ_POOL_BLOCKS) vib_queue_depth = VIB_ACQ_POOL_BLOCKS;
+
+    vib_n_subs = 0;
+    vib_feat_queue = vib_sensor_acq_subscribe(vib_queue_depth);
+    if (!vib_feat_queue) return ERROR;
 
-    /* ring buffer init */
-    if (ring_buffer_init(vib_rb, rb_capacity, sizeof(vib_sensor_t)) != OK) return ERROR;
+    /* feature extraction + snapshot published to readers (modbus, dashboard) */
+    vib_features_cfg_t feat_cfg = {
+        .block_len = VIB_ACQ_FEATURE_BLOCK_LEN,
+        .lsb_to_g = IIS3DWB_LSB_TO_G(VIB_ACQ_DEFAULT_FS),
+        .rms_warning_g = VIB_ACQ_RMS_WARNING_G,
+        .rms_danger_g = VIB_ACQ_RMS_DANGER_G,
+    };
+    vib_features = vib_features_init(&feat_cfg);
+    if (!vib_features) return ERROR;
+
+    vib_features_snap = snapshot_init(sizeof(vib_features_t));
+    if (!vib_features_snap) return ERROR;
+
+    if (vib_frame_init(&vib_frame, IIS3DWB_FIFO_MAX_WORDS) != OK) return ERROR;
+
+    /* generation 1 : the settings above, later changes go through vib_sensor_acq_reconfigure() */
+    vib_fifo_wtm_min = vib_fifo_wtm;
+    vib_cfg_req = (vib_acq_cfg_t){
+        .fs = VIB_ACQ_DEFAULT_FS,
+        .lpf2_en = 0,
+        .fifo_watermark = vib_fifo_wtm,
+        .rms_warning_g = VIB_ACQ_RMS_WARNING_G,
+        .rms_danger_g = VIB_ACQ_RMS_DANGER_G,
+    };
+    vib_cfg = rcu_cfg_init(sizeof(vib_acq_cfg_t), &vib_cfg_req, VIB_ACQ_RCU_READERS);
+    if (!vib_cfg) return ERROR;
+    vib_cfg_req_gen = 1;
+    atomic_store(&vib_cfg_applied, 1);
+
+    vib_alarm_latency = latency_hist_init();
+    if (!vib_alarm_latency) return ERROR;
+
+    /* trending is optional, acquisition runs without it */
+    vib_trend = trend_store_open(VIB_ACQ_TREND_PATH, &vib_trend_cfg);
+    if (!vib_trend) fprintf(stderr, "[VIB_ACQ] trend store unavailable, trending disabled\n");
+
+    /* inference is optional as well, the model must take the feature channels as input */
+    vib_model = nn_model_open(VIB_ACQ_MODEL_PATH);
+    if (vib_model && nn_model_input_len(vib_model) != VIB_CH_COUNT)
+    {
+        fprintf(stderr, "[VIB_ACQ] model input is not the %d feature channels, inference disabled\n", VIB_CH_COUNT);
+        nn_model_close(vib_model);
+        vib_model = NULL;
+    }
+    if (vib_model)
+    {
+        vib_infer_snap = snapshot_init(sizeof(vib_inference_t));
+        if (!vib_infer_snap) return ERROR;
+    }
+
+    vib_n_cosensors = 0;
+    vib_wheel = timer_wheel_init(VIB_ACQ_WHEEL_TICK_MS, monotonic_ms());
+    if (!vib_wheel) return ERROR;
+
+    return OK;
+}
+
+block_queue_t* vib_sensor_acq_subscribe(size_t depth)
+{
+    if (!vib_pool || atomic_load(&v_run) || vib_n_subs == VIB_ACQ_MAX_SUBSCRIBERS) return NULL;
+
+    block_queue_t *q = block_queue_init(depth ? depth : vib_queue_depth);
+    if (!q) return NULL;
+
+    vib_subs[vib_n_subs].queue = q;
+    atomic_store(&vib_subs[vib_n_subs].dropped, 0);
+    vib_n_subs++;
+
+    return q;
+}
+
+int vib_sensor_acq_add_cosensor(const sensor_driver_t *drv, const char *i2c_path, uint16_t addr, uint32_t period_ms)
+{
+    if (!drv || !i2c_path || !vib_wheel || atomic_load(&v_run) || vib_n_cosensors == VIB_ACQ_MAX_COSENSORS) return ERROR;
+    if (!drv->ops->read || drv->map->n_channels > SENSOR_MAX_CHANNELS) return ERROR;
+
+    vib_cosensor_t *cs = &vib_cosensors[vib_n_cosensors];
+    memset(cs, 0, sizeof(vib_cosensor_t));
+
+    cs->i2c = i2c_init(i2c_path);
+    if (!cs->i2c) return ERROR;
+
+    const sensor_bus_t bus = { .type = SENSOR_BUS_I2C, .i2c = cs->i2c, .i2c_addr = addr };
+    cs->dev = sensor_open(drv, &bus);
+    cs->snap = snapshot_init(sizeof(vib_cosensor_sample_t));
+    if (!cs->dev || !cs->snap ||
+        timer_wheel_add(vib_wheel, period_ms ? period_ms : drv->map->period_ms, cosensor_poll, cs) < 0)
+    {
+        fprintf(stderr, "[VIB_ACQ] co-sensor %s at 0x%02X not added\n", drv->map->name, addr);
+        sensor_close(cs->dev);
+        snapshot_free(cs->snap);
+        i2c_close(cs->i2c);
+        memset(cs, 0, sizeof(vib_cosensor_t));
+        return ERROR;
+    }
+
+    return (int)vib_n_cosensors++;
+}
+
+snapshot_t* vib_sensor_acq_cosensor(int idx)
+{
+    if (idx < 0 || (size_t)idx >= vib_n_cosensors) return NULL;
+
+    return vib_cosensors[idx].snap;
+}
+
+int vib_sensor_acq_set_duty(const vib_duty_cfg_t *cfg)
+{
+    if (!cfg || !vib_sensor || atomic_load(&v_run)) return ERROR;
+    if (cfg->period_ms && (cfg->capture_ms == 0 || cfg->settle_ms + cfg->capture_ms >= cfg->period_ms)) return ERROR;
+    if (cfg->wake_threshold_g < 0.0f) return ERROR;
+
+    if (vib_sensor_wakeup_config(vib_sensor, cfg->period_ms ? cfg->wake_threshold_g : 0.0f) != OK) return ERROR;
+
+    vib_duty = *cfg;
+
+    return OK;
+}
+
+int vib_sensor_acq_set_capture(const vib_capture_cfg_t *cfg)
+{
+    if (!cfg || !vib_pool || vib_capture || atomic_load(&v_run) || cfg->level_g < 0.0f) return ERROR;
+
+    pthread_mutex_lock(&vib_cfg_lock);
+    const float lsb_to_g = IIS3DWB_LSB_TO_G(vib_cfg_req.fs);
+    pthread_mutex_unlock(&vib_cfg_lock);
+    const float level_lsb = cfg->level_g / lsb_to_g;
+    const event_capture_cfg_t ec_cfg = {
+        .pre_ms = cfg->pre_ms,
+        .post_ms = cfg->post_ms,
+        .lag_ms = VIB_ACQ_CAPTURE_LAG_MS,
+        .block_ns = (uint32_t)vib_fifo_wtm * VIB_ACQ_SAMPLE_PERIOD_NS,      /* a burst is at least one watermark */
+        .max_events = cfg->max_events,
+        .level_lsb = (level_lsb > INT16_MAX) ? INT16_MAX : (int16_t)level_lsb,
+        .dir = cfg->dir,
+    };
+
+    /* nothing is in flight before start, so the pool can be rebuilt with room for the capture budget */
+    const size_t needed = event_capture_blocks_needed(&ec_cfg);
+    block_pool_stats_t pool_stats;
+    if (needed == 0 || block_pool_stats(vib_pool, &pool_stats) != OK || pool_stats.in_use != 0) return ERROR;
+
+    const block_pool_cfg_t pool_cfg = {
+        .n_blocks = VIB_ACQ_POOL_BLOCKS + needed,
+        .payload_size = IIS3DWB_FIFO_MAX_WORDS * iis3dwb_driver.map->sample_size,
+        .policy = BLOCK_POOL_EXHAUST_DROP,
+        .wait_timeout_us = 0,
+    };
+    block_pool_t *pool = block_pool_init(&pool_cfg);
+    if (!pool) return ERROR;
+
+    vib_capture = event_capture_init(&ec_cfg);
+    vib_capture_queue = vib_capture ? vib_sensor_acq_subscribe(vib_queue_depth) : NULL;
+    if (!vib_capture_queue)
+    {
+        fprintf(stderr, "[VIB_ACQ] event capture not enabled\n");
+        event_capture_free(vib_capture);
+        vib_capture = NULL;
+        block_pool_free(pool);
+        return ERROR;
+    }
+
+    block_pool_free(vib_pool);
+    vib_pool = pool;
+    vib_capture_level_g = cfg->level_g;
+
+    return OK;
+}
+
+event_capture_t* vib_sensor_acq_capture(void)
+{
+    return vib_capture;
+}
+
+int vib_sensor_acq_set_tach(const vib_tach_cfg_t *cfg)
+{
+    if (!cfg || !cfg->chip || !vib_pool || vib_tach || atomic_load(&v_run)) return ERROR;
+
+    const order_track_cfg_t ot_cfg = {
+        .samples_per_rev = cfg->samples_per_rev,
+        .revs_per_spectrum = cfg->revs_per_spectrum,
+        .pulses_per_rev = cfg->pulses_per_rev,
+        .sample_rate_hz = (float)IIS3DWB_ODR_HZ,
+        .min_rpm = cfg->min_rpm,
+    };
+    vib_orders = order_track_init(&ot_cfg);
+    vib_orders_snap = vib_orders ? snapshot_init(sizeof(order_features_t)) : NULL;
+    vib_tach = vib_orders_snap ? gpio_edge_open(cfg->chip, cfg->line, GPIO_EDGE_RISING, cfg->debounce_us) : NULL;
+    if (!vib_tach)
+    {
+        fprintf(stderr, "[VIB_ACQ] order tracking not enabled\n");
+        snapshot_free(vib_orders_snap);
+        order_track_free(vib_orders);
+        vib_orders_snap = NULL;
+        vib_orders = NULL;
+        return ERROR;
+    }
 
     return OK;
 }
 
+snapshot_t* vib_sensor_acq_orders(void)
+{
+    return vib_orders_snap;
+}
+
+int vib_sensor_acq_set_demod(const vib_demod_cfg_t *cfg)
+{
+    if (!cfg || !vib_pool || vib_demod || atomic_load(&v_run)) return ERROR;
+
+    const demod_select_cfg_t ds_cfg = {
+        .period_ms = cfg->period_ms,
+        .window_ms = cfg->window_ms,
+        .levels = cfg->levels,
+        .axis = cfg->axis,
+        .sample_rate_hz = (float)IIS3DWB_ODR_HZ,
+    };
+    vib_demod = demod_select_init(&ds_cfg);
+    vib_demod_queue = vib_demod ? vib_sensor_acq_subscribe(vib_queue_depth) : NULL;
+    if (!vib_demod_queue)
+    {
+        fprintf(stderr, "[VIB_ACQ] demodulation band selection not enabled\n");
+        demod_select_free(vib_demod);
+        vib_demod = NULL;
+        return ERROR;
+    }
+
+    return OK;
+}
+
+demod_select_t* vib_sensor_acq_demod(void)
+{
+    return vib_demod;
+}
+
+static bool cfg_equal(const vib_acq_cfg_t *a, const vib_acq_cfg_t *b)
+{
+    return a->fs == b->fs && a->lpf2_en == b->lpf2_en && a->fifo_watermark == b->fifo_watermark &&
+           a->rms_warning_g == b->rms_warning_g && a->rms_danger_g == b->rms_danger_g;
+}
+
+int vib_sensor_acq_reconfigure(const vib_acq_cfg_t *cfg, uint32_t *gen)
+{
+    if (!cfg) return ERROR;
+    if ((unsigned)cfg->fs > IIS3DWB_FS_8G || cfg->lpf2_en > 1) return ERROR;
+    if (cfg->fifo_watermark < vib_fifo_wtm_min || cfg->fifo_watermark >= IIS3DWB_FIFO_MAX_WORDS) return ERROR;
+    if (!(cfg->rms_warning_g >= 0.0f) || !(cfg->rms_danger_g >= 0.0f)) return ERROR;
+
+    pthread_mutex_lock(&vib_cfg_lock);
+    if (!vib_cfg)
+    {
+        pthread_mutex_unlock(&vib_cfg_lock);
+        return ERROR;
+    }
+
+    int ret = OK;
+    const bool rescale = cfg->fs != vib_cfg_req.fs;
+    if (!cfg_equal(cfg, &vib_cfg_req))
+    {
+        uint32_t next = 0;
+        ret = rcu_cfg_publish(vib_cfg, cfg, &next);
+        if (ret == OK)
+        {
+            vib_cfg_req = *cfg;
+            vib_cfg_req_gen = next;
+        }
+        else
+        {
+            fprintf(stderr, "[VIB_ACQ] reconfiguration refused, earlier generations still in use\n");
+        }
+    }
+
+    /* the capture level trigger compares raw counts */
+    if (ret == OK && rescale && vib_capture && vib_capture_level_g > 0.0f)
+    {
+        const float level_lsb = vib_capture_level_g / IIS3DWB_LSB_TO_G(cfg->fs);
+        event_capture_set_level(vib_capture, (level_lsb > INT16_MAX) ? INT16_MAX : (int16_t)level_lsb, vib_cfg_req_gen);
+    }
+    if (gen) *gen = vib_cfg_req_gen;
+
+    pthread_mutex_unlock(&vib_cfg_lock);
+
+    return ret;
+}
+
+int vib_sensor_acq_config(vib_acq_cfg_t *cfg, uint32_t *gen)
+{
+    if (!cfg) return ERROR;
+
+    pthread_mutex_lock(&vib_cfg_lock);
+    if (!vib_cfg)
+    {
+        pthread_mutex_unlock(&vib_cfg_lock);
+        return ERROR;
+    }
+    *cfg = vib_cfg_req;
+    if (gen) *gen = vib_cfg_req_gen;
+    pthread_mutex_unlock(&vib_cfg_lock);
+
+    return OK;
+}
+
+int vib_sensor_acq_stats(vib_acq_stats_t *stats)
+{
+    if (!stats) return ERROR;
+
+    stats->blocks = atomic_load(&vib_blocks);
+    stats->samples = atomic_load(&vib_samples);
+    stats->dropped_samples = atomic_load(&vib_dropped_samples);
+    stats->fifo_overruns = atomic_load(&vib_fifo_overruns);
+    stats->queue_drops = 0;
+    stats->feature_gaps = atomic_load(&vib_feature_gaps);
+    for (size_t i = 0; i < vib_n_subs; i++) stats->queue_drops += atomic_load(&vib_subs[i].dropped);
+    /* duty cycle, including the phase in progress */
+    const uint64_t in_phase = monotonic_ns() - atomic_load(&vib_phase_since_ns);
+    const bool capturing = atomic_load(&vib_capturing);
+    stats->windows = atomic_load(&vib_windows);
+    stats->wake_triggers = atomic_load(&vib_wake_triggers);
+    stats->active_ms = (atomic_load(&vib_active_ns) + (capturing ? in_phase : 0)) / 1000000ull;
+    stats->parked_ms = (atomic_load(&vib_parked_ns) + (capturing ? 0 : in_phase)) / 1000000ull;
+    stats->duty_cycle = (stats->active_ms + stats->parked_ms) ?
+                        (float)stats->active_ms / (float)(stats->active_ms + stats->parked_ms) : 1.0f;
+
+    stats->cfg_gen = atomic_load(&vib_cfg_applied);
+    stats->cfg_errors = atomic_load(&vib_cfg_errors);
+    stats->cfg_skipped = atomic_load(&vib_cfg_skipped);
+    stats->tach_pulses = atomic_load(&vib_tach_pulses);
+    stats->tach_lost = atomic_load(&vib_tach_lost);
+    stats->trend_rejected = 0;
+    if (vib_trend) trend_store_rejected(vib_trend, &stats->trend_rejected);
+
+    stats->cosensor_reads = 0;
+    stats->cosensor_errors = 0;
+    for (size_t i = 0; i < vib_n_cosensors; i++)
+    {
+        stats->cosensor_reads += atomic_load(&vib_cosensors[i].reads);
+        stats->cosensor_errors += atomic_load(&vib_cosensors[i].errors);
+    }
+
+    return block_pool_stats(vib_pool, &stats->pool);
+}
+
+block_pool_t* vib_sensor_acq_pool(void)
+{
+    return vib_pool;
+}
+
+snapshot_t* vib_sensor_acq_features(void)
+{
+    return vib_features_snap;
+}
+
+trend_store_t* vib_sensor_acq_trend(void)
+{
+    return vib_trend;
+}
+
+snapshot_t* vib_sensor_acq_inference(void)
+{
+    return vib_infer_snap;
+}
+
+latency_hist_t* vib_sensor_acq_alarm_latency(void)
+{
+    return vib_alarm_latency;
+}
+
 int vib_sensor_acq_start(void)
 {
+    /* parked threads wait on the monotonic clock */
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&vib_park_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    atomic_store(&vib_windows, 0);
+    atomic_store(&vib_wake_triggers, 0);
+    atomic_store(&vib_active_ns, 0);
+    atomic_store(&vib_parked_ns, 0);
+    atomic_store(&vib_phase_since_ns, monotonic_ns());
+    atomic_store(&vib_capturing, true);     /* the first window opens right away, the sensor is already on */
+    if (vib_duty.period_ms) atomic_store(&vib_windows, 1);
+    atomic_store(&vib_tach_pulses, 0);
+    atomic_store(&vib_tach_lost, 0);
+    atomic_store(&vib_cfg_errors, 0);
+    atomic_store(&vib_cfg_skipped, 0);
+    vib_tach_seqno = 0;
+
+    if (vib_capture && event_capture_start(vib_capture, vib_capture_queue) != OK) return ERROR;
+    if (vib_demod && demod_select_start(vib_demod, vib_demod_queue) != OK) return ERROR;
+
     atomic_store(&v_run, true); /* TODO: confirm atomic works here */
 
     /* init threads */
@@ -100,14 +1077,92 @@ int vib_sensor_acq_start(void)
 int vib_sensor_acq_stop(void)
 {
     atomic_store(&v_run, false);
+    park_wake_all();
 
     if (pthread_join(vib_prod_thread, NULL) != 0) return ERROR; 
     if (pthread_join(vib_cons_thread, NULL) != 0) return ERROR; 
+    pthread_cond_destroy(&vib_park_cond);
+    vib_duty = (vib_duty_cfg_t){0};
 
-    ring_buffer_free(vib_rb);
+    /* pending events are flushed to storage before their blocks go back */
+    if (vib_capture)
+    {
+        event_capture_stop(vib_capture);
+        event_capture_free(vib_capture);
+        vib_capture = NULL;
+        vib_capture_queue = NULL;
+    }
 
+    if (vib_demod)
+    {
+        demod_select_stop(vib_demod);
+        demod_select_free(vib_demod);
+        vib_demod = NULL;
+        vib_demod_queue = NULL;
+    }
+
+    /* give back whatever the subscribers left queued, then tear down */
+    for (size_t i = 0; i < vib_n_subs; i++)
+    {
+        sample_block_t *blk = NULL;
+        while (block_queue_pop(vib_subs[i].queue, &blk) == OK) block_release(blk);
+        block_queue_free(vib_subs[i].queue);
+        vib_subs[i].queue = NULL;
+    }
+    vib_n_subs = 0;
+    vib_feat_queue = NULL;
+
+    block_pool_free(vib_pool);
+    vib_pool = NULL;
+
+    for (size_t i = 0; i < vib_n_cosensors; i++)
+    {
+        sensor_close(vib_cosensors[i].dev);
+        i2c_close(vib_cosensors[i].i2c);
+        snapshot_free(vib_cosensors[i].snap);
+        memset(&vib_cosensors[i], 0, sizeof(vib_cosensor_t));
+    }
+    vib_n_cosensors = 0;
+    timer_wheel_free(vib_wheel);
+    vib_wheel = NULL;
+
+    sensor_close(vib_dev);
+    vib_dev = NULL;
     vib_sensor_close(vib_sensor);
 
+    pthread_mutex_lock(&vib_cfg_lock);
+    rcu_cfg_free(vib_cfg);
+    vib_cfg = NULL;
+    vib_capture_level_g = 0.0f;
+    pthread_mutex_unlock(&vib_cfg_lock);
+
+    vib_features_free(vib_features);
+    snapshot_free(vib_features_snap);
+    vib_frame_free(&vib_frame);
+    vib_features = NULL;
+    vib_features_snap = NULL;
+
+    if (vib_model) nn_model_close(vib_model);
+    if (vib_infer_snap) snapshot_free(vib_infer_snap);
+    vib_model = NULL;
+    vib_infer_snap = NULL;
+
+    latency_hist_free(vib_alarm_latency);
+    vib_alarm_latency = NULL;
+
+    if (vib_tach)
+    {
+        gpio_edge_close(vib_tach);
+        order_track_free(vib_orders);
+        snapshot_free(vib_orders_snap);
+        vib_tach = NULL;
+        vib_orders = NULL;
+        vib_orders_snap = NULL;
+    }
+
+    if (vib_trend) trend_store_close(vib_trend);
+    vib_trend = NULL;
+
     return OK; 
 }
 
@@ -1,17 +1,228 @@
 #pragma once
 
+#include "utilities/snapshot/snapshot.h"
+#include "utilities/trend_store/trend_store.h"
+#include "utilities/block_pool/block_pool.h"
+#include "utilities/block_queue/block_queue.h"
+#include "utilities/latency_hist/latency_hist.h"
+#include "sensors/hal/sensor_hal.h"
+#include "analysis/inference/nn_model.h"
+#include "analysis/order/order_track.h"
+#include "apps/event_capture/event_capture.h"
+#include "apps/demod_select/demod_select.h"
+#include "vib_calib.h"
+
 #include <stddef.h>
 #include <stdint.h>
 
-/* Initialize spi driver, vib sensor and ring buffer */
+/* trend store tiers, channels follow VIB_CH_* from vib_features.h */
+#define VIB_ACQ_TREND_TIER_1S           0
+#define VIB_ACQ_TREND_TIER_1MIN         1
+#define VIB_ACQ_TREND_TIER_1H           2
+#define VIB_ACQ_TREND_TIER_1D           3
+
+#define VIB_ACQ_MAX_COSENSORS           4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* latest reading of a low-rate co-sensor, values follow the driver's channel order */
+typedef struct
+{
+    uint64_t timestamp_ns;          /* CLOCK_MONOTONIC, same clock as block timestamps */
+    float values[SENSOR_MAX_CHANNELS];
+} vib_cosensor_sample_t;
+
+/* scheduled burst capture, see vib_sensor_acq_set_duty() */
+typedef struct
+{
+    uint32_t period_ms;             /* window start to window start, 0 = continuous capture */
+    uint32_t capture_ms;            /* FIFO capture per window, after settling */
+    uint32_t settle_ms;             /* power-up to first kept sample, IIS3DWB_SETTLE_MS is the minimum */
+    float wake_threshold_g;         /* > 0 : open a window early on a wake-up event; keeps the
+                                       sensor powered between windows (FIFO and SPI still idle) */
+} vib_duty_cfg_t;
+
+/* raw waveform capture around alarms, level crossings and external requests */
+typedef struct
+{
+    uint32_t pre_ms;                /* history stored before the trigger */
+    uint32_t post_ms;               /* stored after the trigger */
+    uint32_t max_events;            /* events collecting or queued for storage at once */
+    float level_g;                  /* any axis at or above this level triggers, 0 = off */
+    const char *dir;                /* event files, see event_capture.h for the format */
+} vib_capture_cfg_t;
+
+/* settings that can change while acquiring, see vib_sensor_acq_reconfigure() */
+typedef struct
+{
+    iis3dwb_fs_t fs;                /* full scale */
+    uint8_t lpf2_en;                /* output from the LPF2 stage */
+    uint16_t fifo_watermark;        /* words per FIFO burst, not below the watermark chosen at init */
+    float rms_warning_g;            /* feature stage alarm levels, 0 disables */
+    float rms_danger_g;
+} vib_acq_cfg_t;
+
+/* once-per-rev tachometer on a GPIO line, drives order tracking */
+typedef struct
+{
+    const char *chip;               /* GPIO character device, e.g. GPIO_CHIP_0 */
+    uint32_t line;
+    uint32_t debounce_us;           /* 0 = none */
+    uint32_t pulses_per_rev;
+    uint32_t samples_per_rev;       /* angle domain resolution, power of two */
+    uint32_t revs_per_spectrum;     /* order spectrum length in revolutions, power of two */
+    float min_rpm;                  /* slower is treated as stopped */
+} vib_tach_cfg_t;
+
+/* background demodulation band selection, see demod_select.h */
+typedef struct
+{
+    uint32_t period_ms;             /* window start to window start */
+    uint32_t window_ms;             /* signal analysed per window */
+    uint32_t levels;                /* kurtogram depth, 1 .. KURTOGRAM_MAX_LEVELS */
+    uint32_t axis;                  /* 0 = x, 1 = y, 2 = z */
+} vib_demod_cfg_t;
+
+/* model output for one feature record */
+typedef struct
+{
+    uint32_t block_seq;             /* vib_features_t.block_seq the result belongs to */
+    nn_result_t result;
+} vib_inference_t;
+
+typedef struct
+{
+    uint64_t blocks;                /* blocks produced */
+    uint64_t samples;               /* samples produced */
+    uint64_t dropped_samples;       /* drained and discarded while the pool was exhausted */
+    uint64_t fifo_overruns;         /* sensor FIFO overran between bursts */
+    uint64_t queue_drops;           /* block deliveries lost to full subscriber queues */
+    uint64_t feature_gaps;          /* partial feature blocks dropped at a discontinuity */
+    uint64_t windows;               /* capture windows opened (duty-cycled mode) */
+    uint64_t wake_triggers;         /* windows opened early by the wake-up threshold */
+    uint64_t active_ms;             /* time capturing */
+    uint64_t parked_ms;             /* time parked with the sensor powered down / FIFO idle */
+    float duty_cycle;               /* active / (active + parked) */
+    uint32_t cfg_gen;               /* configuration generation the producer is capturing under */
+    uint64_t cfg_errors;            /* register updates that failed and were retried */
+    uint64_t cfg_skipped;           /* blocks of a superseded configuration the feature stage never saw */
+    uint64_t tach_pulses;           /* tachometer edges read */
+    uint64_t tach_lost;             /* kernel edge queue overflows, order tracking restarted */
+    uint64_t trend_rejected;        /* trend records refused after the wall clock stepped back */
+    uint64_t cosensor_reads;
+    uint64_t cosensor_errors;
+    block_pool_stats_t pool;
+} vib_acq_stats_t;
+
+/* Initialize spi driver, vib sensor, block pool and the feature stage
+ - queue_depth : blocks per subscriber queue (one FIFO burst each), at least 4 and at most the pool
+ - calib : NULL uses 'speed' and 'queue_depth' as given; otherwise the SPI clock,
+           FIFO watermark and queue depth come from a stored or fresh calibration
+           and 'speed' is ignored in favour of calib->max_speed_hz
+*/
 int (vib_sensor_acq_init(const char *spi_path, 
                          uint8_t mode, 
                          uint32_t speed,
                          uint8_t bits, 
-                         size_t rb_capacity));
+                         size_t queue_depth,
+                         const vib_calib_cfg_t *calib));
 
 /* start producer consumer threads */
 int vib_sensor_acq_start(void);
 
 /* stop producer consumer threads */
 int vib_sensor_acq_stop(void);
+
+/*
+ subscribe a stage to the block stream, between init and start
+ - each produced block is pushed by handle (blocks hold vib_sensor_data_t samples)
+ - the subscriber owns one reference per popped block and must block_release() it
+ - depth 0 uses the queue depth chosen at init
+*/
+block_queue_t* vib_sensor_acq_subscribe(size_t depth);
+
+/*
+ add a low-rate I2C sensor (TMP117, INA219, ...) between init and start
+ - polled from the producer's idle time on a timer wheel, no extra thread
+ - period_ms 0 uses the driver default; returns the co-sensor index or ERROR
+*/
+int vib_sensor_acq_add_cosensor(const sensor_driver_t *drv, const char *i2c_path, uint16_t addr, uint32_t period_ms);
+
+/* latest vib_cosensor_sample_t of co-sensor 'idx', valid between init and stop */
+snapshot_t* vib_sensor_acq_cosensor(int idx);
+
+/*
+ duty-cycled capture, between init and start
+ - each window powers the sensor up (CTRL1_XL), waits settle_ms, captures capture_ms through the
+   FIFO path, then powers it down and parks the producer and feature threads until the next window
+ - the first block of every window carries BLOCK_FLAG_GAP
+*/
+int vib_sensor_acq_set_duty(const vib_duty_cfg_t *cfg);
+
+/*
+ event capture, between init and start
+ - the block pool grows by the capture budget so history references never starve acquisition
+ - alarms raised by the feature stage trigger automatically, external requests go
+   through event_capture_trigger() on vib_sensor_acq_capture()
+*/
+int vib_sensor_acq_set_capture(const vib_capture_cfg_t *cfg);
+
+/* NULL unless vib_sensor_acq_set_capture() succeeded */
+event_capture_t* vib_sensor_acq_capture(void);
+
+/*
+ order tracking, between init and start
+ - rising edges on the tach line are read by the feature thread before each block, the block
+   stream is resampled to the shaft angle and an order spectrum published every revs_per_spectrum
+*/
+int vib_sensor_acq_set_tach(const vib_tach_cfg_t *cfg);
+
+/* latest order_features_t, NULL unless vib_sensor_acq_set_tach() succeeded */
+snapshot_t* vib_sensor_acq_orders(void);
+
+/*
+ demodulation band selection, between init and start
+ - a worker thread of its own subscribes to the block stream and runs the fast kurtogram for
+   window_ms of every period_ms, the feature thread is not involved
+ - the most impulsive band is published per window for the envelope stage
+*/
+int vib_sensor_acq_set_demod(const vib_demod_cfg_t *cfg);
+
+/* NULL unless vib_sensor_acq_set_demod() succeeded, demod_select_band() has the latest demod_band_t */
+demod_select_t* vib_sensor_acq_demod(void);
+
+/*
+ hot reconfiguration, from one control thread at a time between init and stop
+ - sensor registers (fs, lpf2, watermark) are written by the producer between FIFO bursts; a
+   scale or filter change restarts the FIFO and flags the next block BLOCK_FLAG_GAP
+ - every accepted change is a new generation : blocks carry the generation they were captured
+   under and each stage switches scaling and parameters exactly at that block
+ - ERROR on an invalid setting, or while too many replaced generations are still in use
+*/
+int vib_sensor_acq_reconfigure(const vib_acq_cfg_t *cfg, uint32_t *gen);
+
+/* latest accepted configuration and its generation (may not be applied yet) */
+int vib_sensor_acq_config(vib_acq_cfg_t *cfg, uint32_t *gen);
+
+int vib_sensor_acq_stats(vib_acq_stats_t *stats);
+
+block_pool_t* vib_sensor_acq_pool(void);
+
+/* live feature snapshot (vib_features_t), valid between init and stop */
+snapshot_t* vib_sensor_acq_features(void);
+
+/* feature trend history, NULL if the store could not be opened */
+trend_store_t* vib_sensor_acq_trend(void);
+
+/* latest vib_inference_t, NULL when no model is installed */
+snapshot_t* vib_sensor_acq_inference(void);
+
+/* sensor-to-alarm latency per block : first sample timestamp until the alarm state covering
+   the whole block is published, valid between init and stop */
+latency_hist_t* vib_sensor_acq_alarm_latency(void);
+
+#ifdef __cplusplus
+}
+#endif
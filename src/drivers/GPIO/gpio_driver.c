@@ -0,0 +1,133 @@
+#include "gpio_driver.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#define GPIO_CONSUMER           "edge_tach"
+#define GPIO_READ_BATCH         16
+
+gpio_handle_t* gpio_edge_open(const char *chip, uint32_t line, uint8_t edges, uint32_t debounce_us)
+{
+    if (!chip || !(edges & (GPIO_EDGE_RISING | GPIO_EDGE_FALLING)))
+    {
+        fprintf(stderr, "GPIO: Invalid parameters\n"); 
+        return NULL; 
+    }
+
+    gpio_handle_t *handle = (gpio_handle_t*)calloc(1, sizeof(gpio_handle_t)); 
+    if (!handle)
+    {
+        fprintf(stderr, "GPIO: mem alloc failed\n"); 
+        return NULL; 
+    }
+
+    handle->chip_fd = open(chip, O_RDWR | O_CLOEXEC);
+    if (handle->chip_fd < 0)
+    {
+        fprintf(stderr, "GPIO: failed to open chip\n"); 
+        free(handle);
+        return NULL;
+    }
+
+    /* input with edge detection, kernel timestamps default to CLOCK_MONOTONIC */
+    struct gpio_v2_line_request req;
+    memset(&req, 0, sizeof(req));
+    req.offsets[0] = line;
+    req.num_lines = 1;
+    req.event_buffer_size = GPIO_EVENT_BUFFER;
+    strncpy(req.consumer, GPIO_CONSUMER, sizeof(req.consumer) - 1);
+    req.config.flags = GPIO_V2_LINE_FLAG_INPUT;
+    if (edges & GPIO_EDGE_RISING) req.config.flags |= GPIO_V2_LINE_FLAG_EDGE_RISING;
+    if (edges & GPIO_EDGE_FALLING) req.config.flags |= GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    if (debounce_us)
+    {
+        req.config.num_attrs = 1;
+        req.config.attrs[0].mask = 1;       // applies to offsets[0]
+        req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+        req.config.attrs[0].attr.debounce_period_us = debounce_us;
+    }
+
+    if (ioctl(handle->chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0 || req.fd < 0)
+    {
+        fprintf(stderr, "GPIO: failed to request line %u\n", line); 
+        close(handle->chip_fd);
+        free(handle);
+        return NULL;
+    }
+
+    /* edges are polled from the acquisition loops, never wait on them */
+    int fl = fcntl(req.fd, F_GETFL);
+    if (fl < 0 || fcntl(req.fd, F_SETFL, fl | O_NONBLOCK) < 0)
+    {
+        fprintf(stderr, "GPIO: failed to set line non-blocking\n"); 
+        close(req.fd);
+        close(handle->chip_fd);
+        free(handle);
+        return NULL;
+    }
+
+    handle->line_fd = req.fd;
+    handle->line = line;
+
+    return handle; 
+}
+
+int gpio_edge_close(gpio_handle_t *handle)
+{
+    if (!handle)
+    {
+        fprintf(stderr, "GPIO: Invalid handle\n"); 
+        return ERROR; 
+    }
+
+    int ret = close(handle->line_fd);
+    if (close(handle->chip_fd) < 0) ret = ERROR;
+    free(handle);
+
+    return ret; 
+}
+
+int gpio_edge_read(gpio_handle_t *handle, gpio_edge_t *edges, size_t max, size_t *n)
+{
+    if (!handle || !edges || !n || max == 0)
+    {
+        fprintf(stderr, "GPIO: Invalid parameters\n"); 
+        return ERROR; 
+    }
+
+    *n = 0;
+    struct gpio_v2_line_event ev[GPIO_READ_BATCH];
+    while (*n < max)
+    {
+        size_t want = max - *n;
+        if (want > GPIO_READ_BATCH) want = GPIO_READ_BATCH;
+
+        /* the kernel only hands out whole events */
+        ssize_t got = read(handle->line_fd, ev, want * sizeof(ev[0]));
+        if (got < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            fprintf(stderr, "GPIO: edge read failed\n"); 
+            return ERROR;
+        }
+
+        const size_t count = (size_t)got / sizeof(ev[0]);
+        for (size_t i = 0; i < count; i++)
+        {
+            edges[*n].timestamp_ns = ev[i].timestamp_ns;
+            edges[*n].seqno = ev[i].line_seqno;
+            edges[*n].rising = (ev[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE);
+            (*n)++;
+        }
+        if (count < want) break;
+    }
+
+    return OK;
+}
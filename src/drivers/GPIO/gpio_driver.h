@@ -0,0 +1,47 @@
+/* 
+Description : User-space GPIO edge event driver based on the GPIO character device (uAPI v2)
+              - one input line per handle, edges are timestamped by the kernel on
+                CLOCK_MONOTONIC, the same clock as the acquisition block timestamps
+              - events queue in the kernel until read, reads never block
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define GPIO_CHIP_0             "/dev/gpiochip0"    // RPi header GPIOs
+#define GPIO_EVENT_BUFFER       64                  // kernel-side edge queue per line
+
+#define GPIO_EDGE_RISING        0x01
+#define GPIO_EDGE_FALLING       0x02
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    int chip_fd;
+    int line_fd;            // line request, edge events are read from here
+    uint32_t line;
+} gpio_handle_t;
+
+typedef struct
+{
+    uint64_t timestamp_ns;  // CLOCK_MONOTONIC
+    uint32_t seqno;         // per line, gaps mean the kernel queue overflowed
+    uint8_t rising;
+} gpio_edge_t;
+
+/* request 'line' as an input with edge detection; debounce_us 0 = none */
+gpio_handle_t* gpio_edge_open(const char *chip, uint32_t line, uint8_t edges, uint32_t debounce_us);
+
+int gpio_edge_close(gpio_handle_t *handle);
+
+/* drain up to 'max' pending edges into 'edges', *n = 0 when none are pending */
+int gpio_edge_read(gpio_handle_t *handle, gpio_edge_t *edges, size_t max, size_t *n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,152 @@
+#include "i2c_driver.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+i2c_handle_t* i2c_init(const char *device)
+{
+    if (!device)
+    {
+        fprintf(stderr, "I2C: Invalid device path\n"); 
+        return NULL; 
+    }
+
+    i2c_handle_t *handle = (i2c_handle_t*)calloc(1, sizeof(i2c_handle_t)); 
+    if (!handle)
+    {
+        fprintf(stderr, "I2C: mem alloc failed\n"); 
+        return NULL; 
+    }
+
+    /* open I2C adapter, slave addresses travel with each message */
+    handle->fd = open(device, O_RDWR);
+    if (handle->fd < 0)
+    {
+        fprintf(stderr, "I2C: failed to open device\n"); 
+        free(handle);
+        return NULL;
+    }
+
+    /* adapter must support combined (repeated start) transactions */
+    unsigned long funcs = 0;
+    if (ioctl(handle->fd, I2C_FUNCS, &funcs) < 0 || !(funcs & I2C_FUNC_I2C))
+    {
+        fprintf(stderr, "I2C: failed to query adapter\n"); 
+        close(handle->fd);
+        free(handle);
+        return NULL;
+    }
+
+    return handle; 
+}
+
+int i2c_close(i2c_handle_t *handle)
+{
+    if (!handle)
+    {
+        fprintf(stderr, "I2C: Invalid handle\n"); 
+        return ERROR; 
+    }
+
+    int ret = close(handle->fd); 
+    free(handle);
+
+    return ret; 
+}
+
+int i2c_transfer(i2c_handle_t *handle, i2c_msg_t *msgs, size_t n)
+{
+    if (!handle || !msgs || n == 0 || n > I2C_MAX_MSGS)
+    {
+        fprintf(stderr, "I2C: Invalid parameters\n"); 
+        return ERROR; 
+    }
+
+    struct i2c_msg kmsgs[I2C_MAX_MSGS];
+    for (size_t i = 0; i < n; i++)
+    {
+        if (!msgs[i].buf || msgs[i].len == 0) return ERROR;
+
+        kmsgs[i].addr = msgs[i].addr;
+        kmsgs[i].flags = (msgs[i].flags & I2C_MSG_READ) ? I2C_M_RD : 0;
+        kmsgs[i].len = msgs[i].len;
+        kmsgs[i].buf = msgs[i].buf;
+    }
+
+    struct i2c_rdwr_ioctl_data xfer = {
+        .msgs = kmsgs,
+        .nmsgs = (uint32_t)n,
+    };
+
+    if (ioctl(handle->fd, I2C_RDWR, &xfer) < 0)
+    {
+        fprintf(stderr, "I2C: transfer failed\n"); 
+        return ERROR; 
+    }
+
+    return OK;
+}
+
+int i2c_write_reg8(i2c_handle_t *handle, uint16_t addr, uint8_t reg, uint8_t data)
+{
+    uint8_t buf[2] = {reg, data};
+    i2c_msg_t msg = { .addr = addr, .flags = I2C_MSG_WRITE, .len = sizeof(buf), .buf = buf };
+
+    return i2c_transfer(handle, &msg, 1);
+}
+
+int i2c_read_reg8(i2c_handle_t *handle, uint16_t addr, uint8_t reg, uint8_t *data)
+{
+    if (!data) return ERROR;
+
+    i2c_msg_t msgs[2] = {
+        { .addr = addr, .flags = I2C_MSG_WRITE, .len = 1, .buf = &reg },
+        { .addr = addr, .flags = I2C_MSG_READ,  .len = 1, .buf = data },
+    };
+
+    return i2c_transfer(handle, msgs, 2);
+}
+
+int i2c_write_reg16(i2c_handle_t *handle, uint16_t addr, uint8_t reg, uint16_t data)
+{
+    uint8_t buf[3] = {reg, (uint8_t)(data >> 8), (uint8_t)(data & 0xFF)};
+    i2c_msg_t msg = { .addr = addr, .flags = I2C_MSG_WRITE, .len = sizeof(buf), .buf = buf };
+
+    return i2c_transfer(handle, &msg, 1);
+}
+
+int i2c_read_reg16(i2c_handle_t *handle, uint16_t addr, uint8_t reg, uint16_t *data)
+{
+    return i2c_read_regs16(handle, addr, &reg, data, 1);
+}
+
+int i2c_read_regs16(i2c_handle_t *handle, uint16_t addr, const uint8_t *regs, uint16_t *data, size_t n)
+{
+    if (!regs || !data || n == 0 || n > I2C_MAX_BATCH_REGS) return ERROR;
+
+    /* pointer write + 2 byte read per register, all under one bus lock */
+    uint8_t ptr[I2C_MAX_BATCH_REGS];
+    uint8_t raw[I2C_MAX_BATCH_REGS][2];
+    i2c_msg_t msgs[I2C_MAX_MSGS];
+    for (size_t i = 0; i < n; i++)
+    {
+        ptr[i] = regs[i];
+        raw[i][0] = 0;
+        raw[i][1] = 0;
+        msgs[2 * i]     = (i2c_msg_t){ .addr = addr, .flags = I2C_MSG_WRITE, .len = 1, .buf = &ptr[i] };
+        msgs[2 * i + 1] = (i2c_msg_t){ .addr = addr, .flags = I2C_MSG_READ,  .len = 2, .buf = raw[i] };
+    }
+
+    if (i2c_transfer(handle, msgs, 2 * n) != OK) return ERROR;
+
+    for (size_t i = 0; i < n; i++) data[i] = (uint16_t)((raw[i][0] << 8) | raw[i][1]);
+
+    return OK;
+}
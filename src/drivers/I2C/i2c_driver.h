@@ -0,0 +1,56 @@
+/* 
+Description : User-space I2C driver header file based on the i2c-dev interface
+              - every transaction is a single I2C_RDWR ioctl (repeated start between messages)
+              - register helpers assume 8-bit register pointers, 16-bit registers are big endian
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define I2C_BUS_1           "/dev/i2c-1"        // RPi header pins 3/5
+#define I2C_MAX_MSGS        42                  // I2C_RDWR_IOCTL_MAX_MSGS
+#define I2C_MAX_BATCH_REGS  (I2C_MAX_MSGS / 2)  // pointer write + read per register
+
+#define I2C_MSG_WRITE       0x00
+#define I2C_MSG_READ        0x01
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    int fd;
+} i2c_handle_t;
+
+typedef struct
+{
+    uint16_t addr;          // 7-bit slave address
+    uint16_t flags;         // I2C_MSG_WRITE / I2C_MSG_READ
+    uint16_t len;
+    uint8_t *buf;
+} i2c_msg_t;
+
+i2c_handle_t* i2c_init(const char *device);
+
+int i2c_close(i2c_handle_t *handle);
+
+/* run 'n' messages as one combined transaction, n <= I2C_MAX_MSGS */
+int i2c_transfer(i2c_handle_t *handle, i2c_msg_t *msgs, size_t n);
+
+int i2c_write_reg8(i2c_handle_t *handle, uint16_t addr, uint8_t reg, uint8_t data);
+
+int i2c_read_reg8(i2c_handle_t *handle, uint16_t addr, uint8_t reg, uint8_t *data);
+
+int i2c_write_reg16(i2c_handle_t *handle, uint16_t addr, uint8_t reg, uint16_t data);
+
+int i2c_read_reg16(i2c_handle_t *handle, uint16_t addr, uint8_t reg, uint16_t *data);
+
+/* read 'n' 16-bit registers of one device in a single transaction, n <= I2C_MAX_BATCH_REGS */
+int i2c_read_regs16(i2c_handle_t *handle, uint16_t addr, const uint8_t *regs, uint16_t *data, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,6 @@
 #include "spi_driver.h"
 #include "common_def.h"
+#include "utilities/trace/trace.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -102,7 +103,10 @@ int spi_write(spi_handle_t *handle, const uint8_t *data, size_t len)
         .bits_per_word = handle->bits,
     };
 
-    if (ioctl(handle->fd, SPI_IOC_MESSAGE(1), &tr) < 0)
+    TRACE_BEGIN(TRACE_SPI_XFER, len);
+    const int rc = ioctl(handle->fd, SPI_IOC_MESSAGE(1), &tr);
+    TRACE_END(TRACE_SPI_XFER, len);
+    if (rc < 0)
     {
         fprintf(stderr, "SPI: write failed\n"); 
         return ERROR; 
@@ -128,7 +132,10 @@ int spi_read(spi_handle_t *handle, uint8_t *data, size_t len)
         .bits_per_word = handle->bits,
     };
 
-    if (ioctl(handle->fd, SPI_IOC_MESSAGE(1), &tr) < 0)
+    TRACE_BEGIN(TRACE_SPI_XFER, len);
+    const int rc = ioctl(handle->fd, SPI_IOC_MESSAGE(1), &tr);
+    TRACE_END(TRACE_SPI_XFER, len);
+    if (rc < 0)
     {
         fprintf(stderr, "SPI: read failed\n"); 
         return ERROR; 
@@ -154,7 +161,10 @@ int spi_transfer(spi_handle_t *handle, const uint8_t *tx_data, uint8_t *rx_data,
         .bits_per_word = handle->bits,
     };
 
-    if (ioctl(handle->fd, SPI_IOC_MESSAGE(1), &tr) < 0)
+    TRACE_BEGIN(TRACE_SPI_XFER, len);
+    const int rc = ioctl(handle->fd, SPI_IOC_MESSAGE(1), &tr);
+    TRACE_END(TRACE_SPI_XFER, len);
+    if (rc < 0)
     {
         fprintf(stderr, "SPI: transfer failed\n"); 
         return ERROR; 
@@ -197,3 +207,22 @@ int spi_read_reg(spi_handle_t *handle, uint8_t reg, uint8_t *data)
 
     return OK;
 }
+
+int spi_set_speed(spi_handle_t *handle, uint32_t speed)
+{
+    if (!handle || speed == 0)
+    {
+        fprintf(stderr, "SPI: Invalid parameters\n"); 
+        return ERROR; 
+    }
+
+    if (ioctl(handle->fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) < 0)
+    {
+        fprintf(stderr, "SPI: failed to set speed\n"); 
+        return ERROR;
+    }
+
+    handle->speed = speed;
+
+    return OK;
+}
@@ -50,6 +50,9 @@ int spi_write_reg(spi_handle_t *handle, uint8_t reg, uint8_t data);
 
 int spi_read_reg(spi_handle_t *handle, uint8_t reg, uint8_t *data);
 
+/* change the bus clock of an open handle */
+int spi_set_speed(spi_handle_t *handle, uint32_t speed);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -5,21 +5,129 @@ Author      : Swapnil Barot
 
 #include "common_def.h"
 #include "apps/vib_sensor_acq/vib_sensor_acq.h"
+#include "apps/modbus_server/modbus_server.h"
+#include "apps/vib_control/vib_control.h"
 #include "sensors/vibration/vib_sensor.h"
+#include "sensors/temperature/tmp117.h"
+#include "sensors/current/ina219.h"
 #include "drivers/SPI/spi_driver.h"
+#include "drivers/GPIO/gpio_driver.h"
+#include "utilities/trace/trace.h"
 
 #include <stdio.h>
 #include <unistd.h>
+#include <stdlib.h>
+#include <stdbool.h>
 
 int main(void)
 {
     fprintf(stdout, "[TRACE] running main\n");
 
-    /* start vib sensor */
-    if (vib_sensor_acq_init(SPI_DEVICE_0, 0, 8000000, 8, 512) != OK) return ERROR; 
+    /* EDGE_TRACE=<file> records spans and dumps them on exit, see scripts/trace_to_json.py */
+    const char *trace_path = getenv("EDGE_TRACE");
+    if (trace_path) trace_enable(1);
+
+    /* start vib sensor, SPI clock / FIFO batch / queue depth tuned on first boot */
+    const vib_calib_cfg_t calib = {
+        .max_speed_hz = 8000000,
+        .target_latency_us = 10000,
+        .link_rounds = 64,
+        .profile_path = VIB_CALIB_PROFILE_PATH,
+        .force = 0,
+    };
+    if (vib_sensor_acq_init(SPI_DEVICE_0, 0, 8000000, 8, 4, &calib) != OK) return ERROR; 
+
+    /* temperature and motor current to correlate with vibration, both optional */
+    if (vib_sensor_acq_add_cosensor(&tmp117_driver, I2C_BUS_1, TMP117_I2C_ADDR, 0) < 0)
+    {
+        fprintf(stderr, "[TRACE] no TMP117 temperature sensor\n");
+    }
+    if (vib_sensor_acq_add_cosensor(&ina219_driver, I2C_BUS_1, INA219_I2C_ADDR, 0) < 0)
+    {
+        fprintf(stderr, "[TRACE] no INA219 current sensor\n");
+    }
+
+    /* EDGE_DUTY=<period_ms>:<capture_ms>[:<wake_g>] captures in bursts instead of continuously */
+    const char *duty_env = getenv("EDGE_DUTY");
+    if (duty_env)
+    {
+        vib_duty_cfg_t duty = { .settle_ms = IIS3DWB_SETTLE_MS };
+        if (sscanf(duty_env, "%u:%u:%f", &duty.period_ms, &duty.capture_ms, &duty.wake_threshold_g) < 2 ||
+            vib_sensor_acq_set_duty(&duty) != OK)
+        {
+            fprintf(stderr, "[TRACE] invalid EDGE_DUTY '%s', capturing continuously\n", duty_env);
+        }
+    }
+
+    /* EDGE_CAPTURE=<dir> stores the raw waveform around alarms, ~3 MB of extra pool blocks */
+    const char *capture_dir = getenv("EDGE_CAPTURE");
+    if (capture_dir)
+    {
+        const vib_capture_cfg_t capture = { .pre_ms = 1000, .post_ms = 500, .max_events = 2, .level_g = 0.0f, .dir = capture_dir };
+        if (vib_sensor_acq_set_capture(&capture) != OK) fprintf(stderr, "[TRACE] event capture to %s not enabled\n", capture_dir);
+    }
+
+    /* EDGE_TACH=<line>[:<pulses_per_rev>] resamples to shaft angle and publishes order spectra */
+    const char *tach_env = getenv("EDGE_TACH");
+    if (tach_env)
+    {
+        vib_tach_cfg_t tach = { .chip = GPIO_CHIP_0, .pulses_per_rev = 1, .debounce_us = 50,
+                                .samples_per_rev = 64, .revs_per_spectrum = 16, .min_rpm = 60.0f };
+        if (sscanf(tach_env, "%u:%u", &tach.line, &tach.pulses_per_rev) < 1 || vib_sensor_acq_set_tach(&tach) != OK)
+        {
+            fprintf(stderr, "[TRACE] order tracking on '%s' not enabled\n", tach_env);
+        }
+    }
+
+    /* EDGE_DEMOD=<period_ms>[:<window_ms>] picks the envelope demodulation band from the z axis kurtogram */
+    const char *demod_env = getenv("EDGE_DEMOD");
+    if (demod_env)
+    {
+        vib_demod_cfg_t demod = { .window_ms = 1000, .levels = 6, .axis = 2 };
+        if (sscanf(demod_env, "%u:%u", &demod.period_ms, &demod.window_ms) < 1 || vib_sensor_acq_set_demod(&demod) != OK)
+        {
+            fprintf(stderr, "[TRACE] demodulation band selection '%s' not enabled\n", demod_env);
+        }
+    }
     vib_sensor_acq_start();
+
+    /* runtime reconfiguration : Unix socket commands and the watched config file */
+    const vib_control_ops_t control_ops = { .get = vib_sensor_acq_config, .apply = vib_sensor_acq_reconfigure };
+    const bool control = vib_control_start(VIB_CONTROL_SOCKET, VIB_CONTROL_CFG_FILE, &control_ops) == OK;
+    if (!control) fprintf(stderr, "[TRACE] control interface not started\n");
+
+    /* serve live features to PLC/SCADA pollers */
+    if (modbus_server_start(MODBUS_TCP_PORT, vib_sensor_acq_features(), vib_sensor_acq_trend()) != OK)
+    {
+        fprintf(stderr, "[TRACE] modbus server not started\n");
+    }
+
     usleep(1000);  /* let threads run */
+    modbus_server_stop();
+
+    latency_summary_t lat;
+    if (latency_hist_summary(vib_sensor_acq_alarm_latency(), &lat) == OK)
+    {
+        fprintf(stdout, "[TRACE] sensor-to-alarm latency : n %llu, p50 %llu us, p99 %llu us, max %llu us\n",
+                (unsigned long long)lat.count, (unsigned long long)(lat.p50_ns / 1000),
+                (unsigned long long)(lat.p99_ns / 1000), (unsigned long long)(lat.max_ns / 1000));
+    }
+
+    vib_acq_stats_t stats;
+    if (duty_env && vib_sensor_acq_stats(&stats) == OK)
+    {
+        fprintf(stdout, "[TRACE] duty cycle : %.1f %% over %llu windows (%llu woken early)\n",
+                stats.duty_cycle * 100.0f, (unsigned long long)stats.windows, (unsigned long long)stats.wake_triggers);
+    }
+
+    if (control) vib_control_stop();
     vib_sensor_acq_stop();
 
+    if (trace_path)
+    {
+        trace_enable(0);
+        if (trace_dump(trace_path) != OK) fprintf(stderr, "[TRACE] trace dump to %s failed\n", trace_path);
+    }
+
     return 0;
 }
\ No newline at end of file
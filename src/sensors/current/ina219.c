@@ -0,0 +1,54 @@
+#include "ina219.h"
+
+float ina219_raw_to_current(uint16_t raw)
+{
+    return (float)(int16_t)raw * INA219_CURRENT_LSB_A;
+}
+
+float ina219_raw_to_bus_v(uint16_t raw)
+{
+    return (float)(raw >> 3) * INA219_BUS_V_LSB;
+}
+
+/* current and bus voltage in one transaction so both describe the same conversion */
+static int ina219_read(sensor_dev_t *dev, float *values)
+{
+    static const uint8_t regs[2] = { INA219_CURRENT_REG, INA219_BUS_V_REG };
+    uint16_t raw[2] = {0};
+    if (sensor_regs_read(dev, regs, raw, 2) != OK) return ERROR;
+
+    values[INA219_CH_CURRENT_A] = ina219_raw_to_current(raw[0]);
+    values[INA219_CH_BUS_V] = ina219_raw_to_bus_v(raw[1]);
+
+    return OK;
+}
+
+/* no ID register : a reset restores the documented CONFIG default */
+static const sensor_regmap_t ina219_map = {
+    .name = "INA219",
+    .reg_width = 2,
+    .has_reset = 1,
+    .reset = { INA219_CONFIG_REG, INA219_CONFIG_RESET },
+    .reset_delay_us = 100,
+    .id_reg = INA219_CONFIG_REG,
+    .id_mask = 0xFFFF,
+    .id_value = INA219_CONFIG_DEFAULT,
+    .n_init = 2,
+    .init = {
+        { INA219_CONFIG_REG, INA219_CONFIG_32V_320MV_AVG128 },
+        { INA219_CALIBRATION_REG, INA219_CALIBRATION },
+    },
+    .n_channels = 2,
+    .channel = { [INA219_CH_CURRENT_A] = "current", [INA219_CH_BUS_V] = "bus_voltage" },
+    .unit = { [INA219_CH_CURRENT_A] = "A", [INA219_CH_BUS_V] = "V" },
+    .period_ms = 100,
+};
+
+static const sensor_ops_t ina219_ops = {
+    .read = ina219_read,
+};
+
+const sensor_driver_t ina219_driver = {
+    .map = &ina219_map,
+    .ops = &ina219_ops,
+};
@@ -0,0 +1,43 @@
+/* 
+Description : TI INA219 current / power monitor (I2C, 16-bit big endian registers)
+              - calibration is fixed at compile time from the shunt value and current LSB
+*/
+
+#pragma once
+
+#include "sensors/hal/sensor_hal.h"
+
+#define INA219_I2C_ADDR             0x40        // A0 = A1 = GND
+#define INA219_CONFIG_REG           0x00
+#define INA219_SHUNT_V_REG          0x01
+#define INA219_BUS_V_REG            0x02
+#define INA219_POWER_REG            0x03
+#define INA219_CURRENT_REG          0x04
+#define INA219_CALIBRATION_REG      0x05
+
+#define INA219_CONFIG_RESET         0x8000
+#define INA219_CONFIG_DEFAULT       0x399F      // value after reset, used as the probe signature
+
+/* 32 V bus range, /8 shunt gain (320 mV), 12-bit x128 averaging on both ADCs, continuous */
+#define INA219_CONFIG_32V_320MV_AVG128  ((1u << 13) | (0x3u << 11) | (0xFu << 7) | (0xFu << 3) | 0x7u)
+
+#define INA219_SHUNT_OHMS           0.1f
+#define INA219_CURRENT_LSB_A        0.0001f     // 100 uA per LSB, 3.2 A full scale
+#define INA219_CALIBRATION          4096        // trunc(0.04096 / (CURRENT_LSB * SHUNT_OHMS))
+#define INA219_BUS_V_LSB            0.004f      // 4 mV per LSB, value in bits [15:3]
+
+#define INA219_CH_CURRENT_A         0
+#define INA219_CH_BUS_V             1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const sensor_driver_t ina219_driver;
+
+float ina219_raw_to_current(uint16_t raw);
+float ina219_raw_to_bus_v(uint16_t raw);
+
+#ifdef __cplusplus
+}
+#endif
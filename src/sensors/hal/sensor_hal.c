@@ -0,0 +1,188 @@
+#include "sensor_hal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+int sensor_reg_read(sensor_dev_t *dev, uint8_t reg, uint16_t *value)
+{
+    return sensor_regs_read(dev, &reg, value, 1);
+}
+
+int sensor_reg_write(sensor_dev_t *dev, uint8_t reg, uint16_t value)
+{
+    if (!dev) return ERROR;
+
+    const sensor_regmap_t *map = dev->drv->map;
+    if (dev->bus.type == SENSOR_BUS_I2C)
+    {
+        if (map->reg_width == 2) return i2c_write_reg16(dev->bus.i2c, dev->bus.i2c_addr, reg, value);
+        return i2c_write_reg8(dev->bus.i2c, dev->bus.i2c_addr, reg, (uint8_t)value);
+    }
+
+    if (map->reg_width == 2)
+    {
+        uint8_t buf[3] = {reg, (uint8_t)(value >> 8), (uint8_t)(value & 0xFF)};
+        return spi_write(dev->bus.spi, buf, sizeof(buf));
+    }
+
+    return spi_write_reg(dev->bus.spi, reg, (uint8_t)value);
+}
+
+int sensor_regs_read(sensor_dev_t *dev, const uint8_t *regs, uint16_t *values, size_t n)
+{
+    if (!dev || !regs || !values || n == 0) return ERROR;
+
+    const sensor_regmap_t *map = dev->drv->map;
+    if (dev->bus.type == SENSOR_BUS_I2C)
+    {
+        if (map->reg_width == 2)
+        {
+            /* batches of I2C_MAX_BATCH_REGS per ioctl */
+            for (size_t i = 0; i < n; i += I2C_MAX_BATCH_REGS)
+            {
+                size_t chunk = (n - i > I2C_MAX_BATCH_REGS) ? I2C_MAX_BATCH_REGS : n - i;
+                if (i2c_read_regs16(dev->bus.i2c, dev->bus.i2c_addr, &regs[i], &values[i], chunk) != OK) return ERROR;
+            }
+            return OK;
+        }
+
+        for (size_t i = 0; i < n; i++)
+        {
+            uint8_t v = 0;
+            if (i2c_read_reg8(dev->bus.i2c, dev->bus.i2c_addr, regs[i], &v) != OK) return ERROR;
+            values[i] = v;
+        }
+        return OK;
+    }
+
+    /* SPI : address byte then reg_width data bytes clocked in full duplex */
+    for (size_t i = 0; i < n; i++)
+    {
+        uint8_t tx[3] = {(uint8_t)(regs[i] | map->spi_read_mask), 0, 0};
+        uint8_t rx[3] = {0};
+        const size_t len = 1 + (map->reg_width == 2 ? 2 : 1);
+        if (spi_transfer(dev->bus.spi, tx, rx, len) != OK) return ERROR;
+        values[i] = (map->reg_width == 2) ? (uint16_t)((rx[1] << 8) | rx[2]) : rx[1];
+    }
+
+    return OK;
+}
+
+/* regmap driven defaults */
+static int default_probe(sensor_dev_t *dev)
+{
+    const sensor_regmap_t *map = dev->drv->map;
+
+    if (map->has_reset)
+    {
+        if (sensor_reg_write(dev, map->reset.reg, map->reset.value) != OK) return ERROR;
+        if (map->reset_delay_us) usleep(map->reset_delay_us);
+    }
+
+    uint16_t id = 0;
+    if (sensor_reg_read(dev, map->id_reg, &id) != OK) return ERROR;
+    if ((id & map->id_mask) != map->id_value)
+    {
+        fprintf(stderr, "SENSOR: %s id mismatch (0x%04X)\n", map->name, id);
+        return ERROR;
+    }
+
+    return OK;
+}
+
+static int default_configure(sensor_dev_t *dev)
+{
+    const sensor_regmap_t *map = dev->drv->map;
+    for (size_t i = 0; i < map->n_init; i++)
+    {
+        if (sensor_reg_write(dev, map->init[i].reg, map->init[i].value) != OK) return ERROR;
+    }
+
+    return OK;
+}
+
+static sensor_dev_t* sensor_alloc(const sensor_driver_t *drv, const sensor_bus_t *bus)
+{
+    if (!drv || !drv->map || !drv->ops || !bus) return NULL;
+    if (bus->type == SENSOR_BUS_SPI && !bus->spi) return NULL;
+    if (bus->type == SENSOR_BUS_I2C && !bus->i2c) return NULL;
+
+    sensor_dev_t *dev = (sensor_dev_t*)calloc(1, sizeof(sensor_dev_t));
+    if (!dev)
+    {
+        fprintf(stderr, "SENSOR: alloc failure\n");
+        return NULL;
+    }
+
+    dev->drv = drv;
+    dev->bus = *bus;
+
+    return dev;
+}
+
+sensor_dev_t* sensor_open(const sensor_driver_t *drv, const sensor_bus_t *bus)
+{
+    sensor_dev_t *dev = sensor_alloc(drv, bus);
+    if (!dev) return NULL;
+
+    int ret = drv->ops->probe ? drv->ops->probe(dev) : default_probe(dev);
+    if (ret != OK)
+    {
+        fprintf(stderr, "SENSOR: %s not detected\n", drv->map->name);
+        free(dev);
+        return NULL;
+    }
+
+    ret = drv->ops->configure ? drv->ops->configure(dev) : default_configure(dev);
+    if (ret != OK)
+    {
+        fprintf(stderr, "SENSOR: %s configuration failed\n", drv->map->name);
+        free(dev);
+        return NULL;
+    }
+
+    fprintf(stdout, "SENSOR: %s ready\n", drv->map->name);
+
+    return dev;
+}
+
+sensor_dev_t* sensor_attach(const sensor_driver_t *drv, const sensor_bus_t *bus, void *priv)
+{
+    sensor_dev_t *dev = sensor_alloc(drv, bus);
+    if (!dev) return NULL;
+
+    dev->priv = priv;
+
+    return dev;
+}
+
+int sensor_close(sensor_dev_t *dev)
+{
+    if (!dev) return ERROR;
+
+    free(dev);
+
+    return OK;
+}
+
+int sensor_read(sensor_dev_t *dev, float *values)
+{
+    if (!dev || !values || !dev->drv->ops->read) return ERROR;
+
+    return dev->drv->ops->read(dev, values);
+}
+
+int sensor_stream_level(sensor_dev_t *dev, uint16_t *level, uint8_t *overrun)
+{
+    if (!dev || !level || !overrun || !dev->drv->ops->stream_level) return ERROR;
+
+    return dev->drv->ops->stream_level(dev, level, overrun);
+}
+
+int sensor_stream_read(sensor_dev_t *dev, void *data, uint16_t words, uint16_t *n_samples)
+{
+    if (!dev || !data || !n_samples || !dev->drv->ops->stream_read) return ERROR;
+
+    return dev->drv->ops->stream_read(dev, data, words, n_samples);
+}
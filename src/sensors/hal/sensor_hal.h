@@ -0,0 +1,119 @@
+/* 
+Description : sensor abstraction layer
+              - each sensor driver is a static const register map + ops table (no runtime tables)
+              - the HAL owns bus access so drivers only describe registers and conversions
+              - low-rate sensors implement read(), FIFO sensors implement the stream ops
+*/
+
+#pragma once
+
+#include "drivers/SPI/spi_driver.h"
+#include "drivers/I2C/i2c_driver.h"
+#include "common_def.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SENSOR_MAX_CHANNELS         4
+#define SENSOR_MAX_INIT_REGS        8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    SENSOR_BUS_SPI = 0,
+    SENSOR_BUS_I2C
+} sensor_bus_type_t;
+
+typedef struct
+{
+    sensor_bus_type_t type;
+    spi_handle_t *spi;
+    i2c_handle_t *i2c;
+    uint16_t i2c_addr;
+} sensor_bus_t;
+
+typedef struct
+{
+    uint8_t reg;
+    uint16_t value;
+} sensor_reg_val_t;
+
+/* compile-time description of a device */
+typedef struct
+{
+    const char *name;
+    uint8_t reg_width;                      /* register size in bytes : 1, or 2 (big endian) */
+    uint8_t spi_read_mask;                  /* OR'ed into the address for SPI reads */
+
+    /* probe : optional reset write, then (id_reg & id_mask) == id_value */
+    uint8_t has_reset;
+    sensor_reg_val_t reset;
+    uint32_t reset_delay_us;
+    uint8_t id_reg;
+    uint16_t id_mask;
+    uint16_t id_value;
+
+    /* written in order by sensor_open() after a successful probe */
+    size_t n_init;
+    sensor_reg_val_t init[SENSOR_MAX_INIT_REGS];
+
+    /* low-rate output : channel names / units, default poll period */
+    uint8_t n_channels;
+    const char *channel[SENSOR_MAX_CHANNELS];
+    const char *unit[SENSOR_MAX_CHANNELS];
+    uint32_t period_ms;
+
+    /* streaming output : bytes per sample, 0 when the device has no FIFO */
+    size_t sample_size;
+} sensor_regmap_t;
+
+typedef struct sensor_dev sensor_dev_t;
+
+/* every op is optional, NULL falls back to the regmap driven default or ERROR */
+typedef struct
+{
+    int (*probe)(sensor_dev_t *dev);
+    int (*configure)(sensor_dev_t *dev);
+    int (*read)(sensor_dev_t *dev, float *values);          /* map->n_channels values */
+    int (*stream_level)(sensor_dev_t *dev, uint16_t *level, uint8_t *overrun);
+    int (*stream_read)(sensor_dev_t *dev, void *data, uint16_t words, uint16_t *n_samples);
+} sensor_ops_t;
+
+typedef struct
+{
+    const sensor_regmap_t *map;
+    const sensor_ops_t *ops;
+} sensor_driver_t;
+
+struct sensor_dev
+{
+    const sensor_driver_t *drv;
+    sensor_bus_t bus;
+    void *priv;                             /* driver private state, not owned by the HAL */
+};
+
+/* probe + configure a device on an open bus, the bus handle stays owned by the caller */
+sensor_dev_t* sensor_open(const sensor_driver_t *drv, const sensor_bus_t *bus);
+
+/* wrap an already configured device (no probe / configure), e.g. to expose a driver's own handle */
+sensor_dev_t* sensor_attach(const sensor_driver_t *drv, const sensor_bus_t *bus, void *priv);
+
+int sensor_close(sensor_dev_t *dev);
+
+int sensor_read(sensor_dev_t *dev, float *values);
+int sensor_stream_level(sensor_dev_t *dev, uint16_t *level, uint8_t *overrun);
+int sensor_stream_read(sensor_dev_t *dev, void *data, uint16_t words, uint16_t *n_samples);
+
+/* register access through the device's bus and register width */
+int sensor_reg_read(sensor_dev_t *dev, uint8_t reg, uint16_t *value);
+int sensor_reg_write(sensor_dev_t *dev, uint8_t reg, uint16_t value);
+
+/* several registers in one bus transaction where the bus allows it (I2C_RDWR) */
+int sensor_regs_read(sensor_dev_t *dev, const uint8_t *regs, uint16_t *values, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
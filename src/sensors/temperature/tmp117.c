@@ -0,0 +1,41 @@
+#include "tmp117.h"
+
+float tmp117_raw_to_c(uint16_t raw)
+{
+    return (float)(int16_t)raw * TMP117_LSB_C;
+}
+
+static int tmp117_read(sensor_dev_t *dev, float *values)
+{
+    uint16_t raw = 0;
+    if (sensor_reg_read(dev, TMP117_TEMP_RESULT_REG, &raw) != OK) return ERROR;
+
+    values[TMP117_CH_TEMP_C] = tmp117_raw_to_c(raw);
+
+    return OK;
+}
+
+static const sensor_regmap_t tmp117_map = {
+    .name = "TMP117",
+    .reg_width = 2,
+    .id_reg = TMP117_DEVICE_ID_REG,
+    .id_mask = TMP117_DEVICE_ID_MASK,
+    .id_value = TMP117_DEVICE_ID_VAL,
+    .n_init = 1,
+    .init = {
+        { TMP117_CONFIG_REG, TMP117_CONFIG_1HZ_AVG8 },
+    },
+    .n_channels = 1,
+    .channel = { [TMP117_CH_TEMP_C] = "temperature" },
+    .unit = { [TMP117_CH_TEMP_C] = "C" },
+    .period_ms = 1000,
+};
+
+static const sensor_ops_t tmp117_ops = {
+    .read = tmp117_read,
+};
+
+const sensor_driver_t tmp117_driver = {
+    .map = &tmp117_map,
+    .ops = &tmp117_ops,
+};
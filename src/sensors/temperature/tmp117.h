@@ -0,0 +1,33 @@
+/* 
+Description : TI TMP117 digital temperature sensor (I2C, 16-bit big endian registers)
+*/
+
+#pragma once
+
+#include "sensors/hal/sensor_hal.h"
+
+#define TMP117_I2C_ADDR             0x48        // ADD0 tied to GND
+#define TMP117_TEMP_RESULT_REG      0x00
+#define TMP117_CONFIG_REG           0x01
+#define TMP117_DEVICE_ID_REG        0x0F
+#define TMP117_DEVICE_ID_VAL        0x0117      // DID[11:0], REV[15:12] masked out
+#define TMP117_DEVICE_ID_MASK       0x0FFF
+#define TMP117_LSB_C                0.0078125f  // 7.8125 m°C per LSB
+
+/* continuous conversion, 8 averages, 1 s cycle */
+#define TMP117_CONFIG_1HZ_AVG8      ((0x4u << 7) | (0x1u << 5))
+
+#define TMP117_CH_TEMP_C            0
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const sensor_driver_t tmp117_driver;
+
+/* raw TEMP_RESULT to degrees C */
+float tmp117_raw_to_c(uint16_t raw);
+
+#ifdef __cplusplus
+}
+#endif
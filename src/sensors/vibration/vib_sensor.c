@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <math.h>
 
 /* Static Functions */
 static int vib_write_reg(vib_sensor_t *dev, uint8_t reg, uint8_t value)
@@ -61,11 +62,26 @@ vib_sensor_t* vib_sensor_init(const char *spi_dev_path, uint8_t mode, uint32_t s
         return NULL;
     }
 
+    /* FIFO burst buffers, sized once so the acquisition path never allocates */
+    const size_t fifo_xfer_len = 1 + IIS3DWB_FIFO_MAX_WORDS * IIS3DWB_FIFO_WORD_LEN;
+    dev->fifo_tx = (uint8_t*)calloc(1, fifo_xfer_len);
+    dev->fifo_rx = (uint8_t*)calloc(1, fifo_xfer_len);
+    if (!dev->fifo_tx || !dev->fifo_rx)
+    {
+        fprintf(stderr, "VIB: alloc failure\n");
+        free(dev->fifo_tx);
+        free(dev->fifo_rx);
+        free(dev);
+        return NULL;
+    }
+
     /* open SPI device */
     dev->spi = spi_init(spi_dev_path, mode, speed, bits); 
     if (!dev->spi)
     {
         fprintf(stderr, "VIB: spi_init() failure\n");
+        free(dev->fifo_tx);
+        free(dev->fifo_rx);
         free(dev); 
         return NULL;
     }
@@ -76,6 +92,8 @@ vib_sensor_t* vib_sensor_init(const char *spi_dev_path, uint8_t mode, uint32_t s
     {
         fprintf(stderr, "VIB: WHOAMI sensor error\n"); 
         spi_close(dev->spi);
+        free(dev->fifo_tx);
+        free(dev->fifo_rx);
         free(dev);
         return NULL;
     }
@@ -87,6 +105,8 @@ vib_sensor_t* vib_sensor_init(const char *spi_dev_path, uint8_t mode, uint32_t s
     {
         fprintf(stderr, "VIB: sensor reset failed\n");
         spi_close(dev->spi);
+        free(dev->fifo_tx);
+        free(dev->fifo_rx);
         free(dev);
         return NULL;
     }
@@ -105,6 +125,8 @@ int vib_sensor_close(vib_sensor_t *dev)
         return ERROR;
     }
 
+    free(dev->fifo_tx);
+    free(dev->fifo_rx);
     free(dev);
 
     return OK;
@@ -127,20 +149,25 @@ int vib_sensor_reset(vib_sensor_t *dev)
     return OK;
 }
 
+/* CTRL1_XL value for the stored fs / filter, XL_EN = 000 powers the sensor down */
+static uint8_t ctrl1_xl(const vib_sensor_t *dev, uint8_t on)
+{
+    uint8_t reg = 0;
+    const uint8_t enable_sensor_val = 0x5; 
+    if (on) reg |= (enable_sensor_val << 5);        // enable sensor 
+    reg |= ((uint8_t)(dev->fs & 0x3) << 2);              
+    if (dev->lpf2_en == 1) reg |= (1 << 1);
+
+    return reg;
+}
+
 int vib_sensor_config(vib_sensor_t *dev, iis3dwb_fs_t fs, uint8_t lpf2_en)
 {
     if (!dev) return ERROR; 
     dev->fs = fs;
     dev->lpf2_en = lpf2_en;
 
-    uint8_t reg = 0;
-    const uint8_t enable_sensor_val = 0x5; 
-    reg |= (enable_sensor_val << 5);        // enable sensor 
-    //reg |= (fs << 2);
-    reg |= ((uint8_t)(fs & 0x3) << 2);              
-    if (lpf2_en == 1) reg |= (1 << 1);
-
-    if (vib_write_reg(dev, IIS3DWB_CTRL1_XL_REG, reg) < 0)
+    if (vib_write_reg(dev, IIS3DWB_CTRL1_XL_REG, ctrl1_xl(dev, 1)) < 0)
     {
         fprintf(stderr, "VIB: sensor config write reg error\n");
         return ERROR;
@@ -197,3 +224,190 @@ int vib_sensor_read(vib_sensor_t *dev, vib_sensor_data_t *data)
 
     return OK; 
 }
+
+float vib_sensor_lsb_to_g(iis3dwb_fs_t fs)
+{
+    return IIS3DWB_LSB_TO_G(fs);
+}
+
+int vib_sensor_power(vib_sensor_t *dev, uint8_t on)
+{
+    if (!dev) return ERROR;
+
+    if (vib_write_reg(dev, IIS3DWB_CTRL1_XL_REG, ctrl1_xl(dev, on)) < 0)
+    {
+        fprintf(stderr, "VIB: sensor power write reg error\n");
+        return ERROR;
+    }
+
+    return OK;
+}
+
+int vib_sensor_wakeup_config(vib_sensor_t *dev, float threshold_g)
+{
+    if (!dev || threshold_g < 0.0f) return ERROR;
+
+    if (threshold_g == 0.0f)
+    {
+        if (vib_write_reg(dev, IIS3DWB_MD1_CFG_REG, 0x00) < 0 ||
+            vib_write_reg(dev, IIS3DWB_INTERRUPTS_EN_REG, 0x00) < 0) return ERROR;
+        return OK;
+    }
+
+    /* full scale in g for the fs encoding (2, 16, 4, 8) */
+    static const float fs_g[4] = {2.0f, 16.0f, 4.0f, 8.0f};
+    const float full_scale = fs_g[dev->fs & 0x3];
+
+    /* fine weight (FS/256, WAKE_THS_W = 1) while the threshold fits in the 6 bit field, else coarse (FS/64) */
+    const uint8_t weight_coarse = (threshold_g > full_scale / 256.0f * 63.0f) ? 1 : 0;
+    const uint8_t wake_dur = weight_coarse ? 0x00 : 0x10;     // bit 7 must stay 0
+    const float lsb = weight_coarse ? full_scale / 64.0f : full_scale / 256.0f;
+    long ths = lroundf(threshold_g / lsb);
+    if (ths < 1) ths = 1;
+    if (ths > 63) ths = 63;
+
+    if (vib_write_reg(dev, IIS3DWB_WAKE_UP_DUR_REG, wake_dur) < 0 ||
+        vib_write_reg(dev, IIS3DWB_WAKE_UP_THS_REG, (uint8_t)ths) < 0 ||
+        vib_write_reg(dev, IIS3DWB_SLOPE_EN_REG, 0x01) < 0 ||                 // latch until WAKE_UP_SRC is read
+        vib_write_reg(dev, IIS3DWB_MD1_CFG_REG, 0x20) < 0 ||                  // INT1_WU
+        vib_write_reg(dev, IIS3DWB_INTERRUPTS_EN_REG, 0x80) < 0)
+    {
+        fprintf(stderr, "VIB: wake-up config write reg error\n");
+        return ERROR;
+    }
+
+    return OK;
+}
+
+int vib_sensor_wakeup_status(vib_sensor_t *dev, uint8_t *triggered)
+{
+    if (!dev || !triggered) return ERROR;
+
+    uint8_t src = 0;
+    if (vib_read_reg(dev, IIS3DWB_WAKE_UP_SRC_REG, &src) < 0) return ERROR;
+
+    *triggered = (src & 0x08) ? 1 : 0;     // WU_IA
+
+    return OK;
+}
+
+int vib_sensor_fifo_config(vib_sensor_t *dev, uint16_t watermark)
+{
+    if (!dev || watermark >= IIS3DWB_FIFO_MAX_WORDS) return ERROR;
+
+    const uint8_t bdr_xl_26k = 0x0A;        // batch accel at 26.667 kHz
+    const uint8_t mode_continuous = 0x06;
+    const uint8_t mode_bypass = 0x00;
+
+    if (vib_write_reg(dev, IIS3DWB_FIFO_CTRL1_REG, (uint8_t)(watermark & 0xFF)) < 0 ||
+        vib_write_reg(dev, IIS3DWB_FIFO_CTRL2_REG, (uint8_t)((watermark >> 8) & 0x01)) < 0 ||
+        vib_write_reg(dev, IIS3DWB_FIFO_CTRL3_REG, watermark ? bdr_xl_26k : 0x00) < 0 ||
+        vib_write_reg(dev, IIS3DWB_FIFO_CTRL4_REG, watermark ? mode_continuous : mode_bypass) < 0)
+    {
+        fprintf(stderr, "VIB: FIFO config write reg error\n");
+        return ERROR;
+    }
+
+    return OK;
+}
+
+int vib_sensor_fifo_level(vib_sensor_t *dev, uint16_t *level, uint8_t *overrun)
+{
+    if (!dev || !level) return ERROR;
+
+    /* polled every producer cycle : FIFO_STATUS1/2 on the stack, not through burst_read() */
+    uint8_t tx[3] = {IIS3DWB_FIFO_STATUS1_REG | IIS3DWB_READ_MASK, 0, 0};
+    uint8_t rx[3] = {0};
+    if (spi_transfer(dev->spi, tx, rx, sizeof(tx)) < 0)
+    {
+        fprintf(stderr, "VIB: FIFO status read error\n");
+        return ERROR;
+    }
+
+    *level = (uint16_t)(((rx[2] & 0x03) << 8) | rx[1]);
+    if (overrun) *overrun = (rx[2] & 0x40) ? 1 : 0;    // FIFO_OVR_IA
+
+    return OK;
+}
+
+int vib_sensor_fifo_read(vib_sensor_t *dev, vib_sensor_data_t *data, uint16_t words, uint16_t *n_samples)
+{
+    if (!dev || !data || !n_samples || words == 0 || words > IIS3DWB_FIFO_MAX_WORDS) return ERROR;
+
+    /* FIFO_DATA_OUT address wraps back to the tag register every word */
+    const size_t len = 1 + (size_t)words * IIS3DWB_FIFO_WORD_LEN;
+    dev->fifo_tx[0] = IIS3DWB_FIFO_DATA_OUT_TAG_REG | IIS3DWB_READ_MASK;
+    if (spi_transfer(dev->spi, dev->fifo_tx, dev->fifo_rx, len) < 0) return ERROR;
+
+    uint16_t n = 0;
+    const uint8_t *word = &dev->fifo_rx[1];
+    for (uint16_t i = 0; i < words; i++, word += IIS3DWB_FIFO_WORD_LEN)
+    {
+        if ((word[0] >> 3) != IIS3DWB_FIFO_TAG_XL) continue;   // skip temperature / timestamp words
+
+        data[n].accel_x = (int16_t)(word[2] << 8 | word[1]);
+        data[n].accel_y = (int16_t)(word[4] << 8 | word[3]);
+        data[n].accel_z = (int16_t)(word[6] << 8 | word[5]);
+        n++;
+    }
+
+    *n_samples = n;
+
+    return OK;
+}
+
+int vib_sensor_link_test(vib_sensor_t *dev, uint16_t rounds, uint16_t *errors)
+{
+    if (!dev || !errors || rounds == 0) return ERROR;
+
+    /* FIFO_CTRL1 is a plain r/w byte with no side effect while the FIFO is in bypass */
+    static const uint8_t patterns[] = {0x55, 0xAA, 0xFF, 0x00, 0x5A, 0xA5, 0x0F, 0xF0};
+    uint16_t err = 0;
+
+    for (uint16_t r = 0; r < rounds; r++)
+    {
+        uint8_t who = 0;
+        if (vib_read_reg(dev, IIS3DWB_WHO_AM_I_REG, &who) < 0 || who != IIS3DWB_WHO_AM_I_VAL) err++;
+
+        uint8_t pattern = patterns[r % sizeof(patterns)];
+        uint8_t readback = (uint8_t)~pattern;
+        if (vib_write_reg(dev, IIS3DWB_FIFO_CTRL1_REG, pattern) < 0 ||
+            vib_read_reg(dev, IIS3DWB_FIFO_CTRL1_REG, &readback) < 0 || readback != pattern) err++;
+    }
+
+    vib_write_reg(dev, IIS3DWB_FIFO_CTRL1_REG, 0x00);
+    *errors = err;
+
+    return OK;
+}
+
+/* HAL glue : samples are vib_sensor_data_t, one FIFO word each */
+static int iis3dwb_stream_level(sensor_dev_t *dev, uint16_t *level, uint8_t *overrun)
+{
+    return vib_sensor_fifo_level((vib_sensor_t *)dev->priv, level, overrun);
+}
+
+static int iis3dwb_stream_read(sensor_dev_t *dev, void *data, uint16_t words, uint16_t *n_samples)
+{
+    return vib_sensor_fifo_read((vib_sensor_t *)dev->priv, (vib_sensor_data_t *)data, words, n_samples);
+}
+
+static const sensor_regmap_t iis3dwb_map = {
+    .name = "IIS3DWB",
+    .reg_width = 1,
+    .spi_read_mask = IIS3DWB_READ_MASK,
+    .id_reg = IIS3DWB_WHO_AM_I_REG,
+    .id_mask = 0xFF,
+    .id_value = IIS3DWB_WHO_AM_I_VAL,
+    .sample_size = sizeof(vib_sensor_data_t),
+};
+
+static const sensor_ops_t iis3dwb_ops = {
+    .stream_level = iis3dwb_stream_level,
+    .stream_read = iis3dwb_stream_read,
+};
+
+const sensor_driver_t iis3dwb_driver = {
+    .map = &iis3dwb_map,
+    .ops = &iis3dwb_ops,
+};
@@ -5,6 +5,7 @@ Author      : Swapnil Barot
 
 #pragma once
 #include "drivers/SPI/spi_driver.h"
+#include "sensors/hal/sensor_hal.h"
 #include "common_def.h"
 
 /* IIS3DWB Register Addresses
@@ -16,9 +17,36 @@ Author      : Swapnil Barot
 #define IIS3DWB_CTRL1_XL_REG            0x10    // output data rate
 #define IIS3DWB_CTRL3_C_REG             0x12    // control boot, reset, etc.
 #define IIS3DWB_OUT_X_L_REG             0X28    // x-axis accel data
+#define IIS3DWB_FIFO_CTRL1_REG          0x07    // FIFO watermark [7:0]
+#define IIS3DWB_FIFO_CTRL2_REG          0x08    // FIFO watermark [8]
+#define IIS3DWB_FIFO_CTRL3_REG          0x09    // accel batch data rate
 #define IIS3DWB_FIFO_CTRL4_REG          0x0A    // FIFO configuration
+#define IIS3DWB_FIFO_STATUS1_REG        0x3A    // unread FIFO words [7:0]
+#define IIS3DWB_FIFO_STATUS2_REG        0x3B    // FIFO flags, unread words [9:8]
+#define IIS3DWB_FIFO_DATA_OUT_TAG_REG   0x78    // tag byte followed by 6 data bytes
+#define IIS3DWB_WAKE_UP_SRC_REG         0x1B    // WU_IA [3]
+#define IIS3DWB_SLOPE_EN_REG            0x56    // LIR latched interrupts [0]
+#define IIS3DWB_INTERRUPTS_EN_REG       0x58    // INTERRUPTS_ENABLE [7]
+#define IIS3DWB_WAKE_UP_THS_REG         0x5B    // WK_THS [5:0]
+#define IIS3DWB_WAKE_UP_DUR_REG         0x5C    // WAKE_THS_W [4] : 0 = FS/2^6, 1 = FS/2^8 per LSB
+#define IIS3DWB_MD1_CFG_REG             0x5E    // INT1_WU [5]
 #define IIS3DWB_READ_MASK               0x80    // MSB = 1 for read
 
+/* FIFO */
+#define IIS3DWB_ODR_HZ                  26667   // fixed output data rate
+#define IIS3DWB_FIFO_WORD_LEN           7       // tag + X/Y/Z
+#define IIS3DWB_FIFO_MAX_WORDS          512
+#define IIS3DWB_FIFO_TAG_XL             0x02    // accelerometer sample tag
+
+/* power-down -> valid data, covers turn-on and the digital filter chain */
+#define IIS3DWB_SETTLE_MS               10
+
+/* datasheet sensitivity in g/LSB, a constant expression for a constant iis3dwb_fs_t */
+#define IIS3DWB_LSB_TO_G(fs)            ((fs) == IIS3DWB_FS_2G  ? 0.061f / 1000.0f : \
+                                         (fs) == IIS3DWB_FS_4G  ? 0.122f / 1000.0f : \
+                                         (fs) == IIS3DWB_FS_8G  ? 0.244f / 1000.0f : \
+                                         (fs) == IIS3DWB_FS_16G ? 0.488f / 1000.0f : 0.0f)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -43,6 +71,8 @@ typedef struct
     spi_handle_t *spi; 
     uint8_t fs;             // full scale msrment rate
     uint8_t lpf2_en;        // filter output from stage 1 filter (0 val) or stage 2 filer (1 val)
+    uint8_t *fifo_tx;       // preallocated FIFO burst buffers, IIS3DWB_FIFO_MAX_WORDS words
+    uint8_t *fifo_rx;
 } vib_sensor_t;
 
 /* Function definitions */
@@ -52,6 +82,27 @@ int vib_sensor_reset(vib_sensor_t *dev);
 int vib_sensor_config(vib_sensor_t *dev, iis3dwb_fs_t fs, uint8_t lpf2_en);
 int vib_sensor_is_data_ready(vib_sensor_t *dev, uint8_t *ready);
 int vib_sensor_read(vib_sensor_t *dev, vib_sensor_data_t *data);
+float vib_sensor_lsb_to_g(iis3dwb_fs_t fs);
+
+/* CTRL1_XL XL_EN : 0 = power-down (FIFO and configuration kept), 1 = on at the configured fs / filter */
+int vib_sensor_power(vib_sensor_t *dev, uint8_t on);
+
+/* wake-up interrupt on any axis above 'threshold_g' (latched, routed to INT1), 0 disables; sensor must be on */
+int vib_sensor_wakeup_config(vib_sensor_t *dev, float threshold_g);
+
+/* read and clear the latched wake-up event */
+int vib_sensor_wakeup_status(vib_sensor_t *dev, uint8_t *triggered);
+
+/* FIFO : continuous mode, accel batched at the full ODR; watermark 0 puts the FIFO in bypass */
+int vib_sensor_fifo_config(vib_sensor_t *dev, uint16_t watermark);
+int vib_sensor_fifo_level(vib_sensor_t *dev, uint16_t *level, uint8_t *overrun);
+int vib_sensor_fifo_read(vib_sensor_t *dev, vib_sensor_data_t *data, uint16_t words, uint16_t *n_samples);
+
+/* bus integrity check : WHO_AM_I reads and register write/readback, 'errors' counts mismatches */
+int vib_sensor_link_test(vib_sensor_t *dev, uint16_t rounds, uint16_t *errors);
+
+/* HAL driver, stream ops take the vib_sensor_t as priv : sensor_attach(&iis3dwb_driver, &bus, dev) */
+extern const sensor_driver_t iis3dwb_driver;
 
 #ifdef __cplusplus
 }
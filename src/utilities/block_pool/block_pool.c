@@ -0,0 +1,199 @@
+#include "block_pool.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+
+#define BLOCK_POOL_NIL              0xFFFFFFFFu
+#define BLOCK_POOL_ALIGN            64
+#define BLOCK_POOL_WAIT_STEP_US     50
+
+/*
+ free list : Treiber stack of block indices, the head packs
+ (tag << 32 | index) so a block popped and pushed back between our
+ load and CAS cannot be mistaken for the same head (ABA)
+*/
+struct block_pool
+{
+    sample_block_t *blocks;
+    uint8_t *payload;
+    size_t payload_stride;
+    size_t payload_bytes;
+    block_pool_cfg_t cfg;
+    _Atomic uint64_t free_head;
+    _Atomic uint64_t acquired;
+    _Atomic uint64_t exhausted;
+    _Atomic uint32_t in_use;
+    _Atomic uint32_t in_use_max;
+};
+
+static void free_push(block_pool_t *pool, uint32_t idx)
+{
+    uint64_t head = atomic_load_explicit(&pool->free_head, memory_order_relaxed);
+    uint64_t next;
+    do
+    {
+        __atomic_store_n(&pool->blocks[idx].next, (uint32_t)head, __ATOMIC_RELAXED);
+        next = ((head >> 32) + 1) << 32 | idx;
+    } while (!atomic_compare_exchange_weak_explicit(&pool->free_head, &head, next, 
+                                                     memory_order_release, memory_order_relaxed));
+}
+
+static uint32_t free_pop(block_pool_t *pool)
+{
+    uint64_t head = atomic_load_explicit(&pool->free_head, memory_order_acquire);
+    uint64_t next;
+    do
+    {
+        uint32_t idx = (uint32_t)head;
+        if (idx == BLOCK_POOL_NIL) return BLOCK_POOL_NIL;
+        uint32_t after = __atomic_load_n(&pool->blocks[idx].next, __ATOMIC_RELAXED);
+        next = ((head >> 32) + 1) << 32 | after;
+    } while (!atomic_compare_exchange_weak_explicit(&pool->free_head, &head, next, 
+                                                     memory_order_acquire, memory_order_acquire));
+
+    return (uint32_t)head;
+}
+
+block_pool_t* block_pool_init(const block_pool_cfg_t *cfg)
+{
+    if (!cfg || cfg->n_blocks == 0 || cfg->n_blocks >= BLOCK_POOL_NIL || cfg->payload_size == 0) return NULL;
+
+    block_pool_t *pool = calloc(1, sizeof(block_pool_t));
+    if (!pool) return NULL;
+
+    pool->cfg = *cfg;
+    pool->payload_stride = (cfg->payload_size + BLOCK_POOL_ALIGN - 1) & ~(size_t)(BLOCK_POOL_ALIGN - 1);
+    pool->payload_bytes = pool->payload_stride * cfg->n_blocks;
+
+    pool->blocks = calloc(cfg->n_blocks, sizeof(sample_block_t));
+    if (!pool->blocks || posix_memalign((void **)&pool->payload, BLOCK_POOL_ALIGN, pool->payload_bytes) != 0)
+    {
+        fprintf(stderr, "[BLOCK_POOL]: ERROR mem alloc failed\n");
+        free(pool->blocks);
+        free(pool);
+        return NULL;
+    }
+
+    /* prefault every payload page now so the acquisition path never takes a page fault */
+    memset(pool->payload, 0, pool->payload_bytes);
+    if (mlock(pool->payload, pool->payload_bytes) != 0)
+    {
+        fprintf(stderr, "[BLOCK_POOL]: mlock failed, payload may be paged out\n");
+    }
+
+    atomic_init(&pool->free_head, BLOCK_POOL_NIL);
+    for (size_t i = cfg->n_blocks; i-- > 0; )
+    {
+        sample_block_t *blk = &pool->blocks[i];
+        blk->data = pool->payload + i * pool->payload_stride;
+        blk->payload_size = (uint32_t)cfg->payload_size;
+        blk->pool = pool;
+        free_push(pool, (uint32_t)i);
+    }
+
+    return pool;
+}
+
+int block_pool_free(block_pool_t *pool)
+{
+    if (!pool) return ERROR;
+
+    if (atomic_load(&pool->in_use) != 0)
+    {
+        fprintf(stderr, "[BLOCK_POOL]: ERROR freeing pool with %u blocks in use\n", atomic_load(&pool->in_use));
+    }
+
+    munlock(pool->payload, pool->payload_bytes);
+    free(pool->payload);
+    free(pool->blocks);
+    free(pool);
+
+    return OK;
+}
+
+sample_block_t* block_pool_acquire(block_pool_t *pool)
+{
+    if (!pool) return NULL;
+
+    uint32_t idx = free_pop(pool);
+
+    if (idx == BLOCK_POOL_NIL && pool->cfg.policy == BLOCK_POOL_EXHAUST_WAIT)
+    {
+        const struct timespec step = { .tv_sec = 0, .tv_nsec = BLOCK_POOL_WAIT_STEP_US * 1000 };
+        for (uint32_t waited = 0; idx == BLOCK_POOL_NIL && waited < pool->cfg.wait_timeout_us; waited += BLOCK_POOL_WAIT_STEP_US)
+        {
+            nanosleep(&step, NULL);
+            idx = free_pop(pool);
+        }
+    }
+
+    if (idx == BLOCK_POOL_NIL)
+    {
+        atomic_fetch_add_explicit(&pool->exhausted, 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    sample_block_t *blk = &pool->blocks[idx];
+    blk->seq = 0;
+    blk->t_first_ns = 0;
+    blk->dt_ns = 0;
+    blk->n_samples = 0;
+    blk->flags = 0;
+    __atomic_store_n(&blk->refs, 1, __ATOMIC_RELAXED);
+
+    atomic_fetch_add_explicit(&pool->acquired, 1, memory_order_relaxed);
+    uint32_t used = atomic_fetch_add_explicit(&pool->in_use, 1, memory_order_relaxed) + 1;
+    uint32_t high = atomic_load_explicit(&pool->in_use_max, memory_order_relaxed);
+    while (used > high && !atomic_compare_exchange_weak_explicit(&pool->in_use_max, &high, used, 
+                                                                 memory_order_relaxed, memory_order_relaxed));
+
+    return blk;
+}
+
+int block_ref(sample_block_t *blk, uint32_t count)
+{
+    if (!blk || !blk->pool) return ERROR;
+
+    __atomic_fetch_add(&blk->refs, count, __ATOMIC_RELAXED);
+
+    return OK;
+}
+
+int block_release(sample_block_t *blk)
+{
+    if (!blk || !blk->pool) return ERROR;
+
+    /* acq_rel : every holder's reads of the payload happen before the block is reused */
+    uint32_t prev = __atomic_fetch_sub(&blk->refs, 1, __ATOMIC_ACQ_REL);
+    if (prev == 0)
+    {
+        fprintf(stderr, "[BLOCK_POOL]: ERROR release of free block\n");
+        __atomic_store_n(&blk->refs, 0, __ATOMIC_RELAXED);
+        return ERROR;
+    }
+
+    if (prev == 1)
+    {
+        block_pool_t *pool = blk->pool;
+        atomic_fetch_sub_explicit(&pool->in_use, 1, memory_order_relaxed);
+        free_push(pool, (uint32_t)(blk - pool->blocks));
+    }
+
+    return OK;
+}
+
+int block_pool_stats(block_pool_t *pool, block_pool_stats_t *stats)
+{
+    if (!pool || !stats) return ERROR;
+
+    stats->acquired = atomic_load_explicit(&pool->acquired, memory_order_relaxed);
+    stats->exhausted = atomic_load_explicit(&pool->exhausted, memory_order_relaxed);
+    stats->in_use = atomic_load_explicit(&pool->in_use, memory_order_relaxed);
+    stats->in_use_max = atomic_load_explicit(&pool->in_use_max, memory_order_relaxed);
+
+    return OK;
+}
@@ -0,0 +1,81 @@
+/* 
+Description : fixed-size pool of refcounted sample blocks for zero-copy fan-out
+              - every block and its payload is allocated and prefaulted at init
+              - a block is shared by handle; it returns to the pool when the
+                last holder calls block_release()
+              - exhaustion is counted and handled by policy, never by malloc
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* sample_block_t flags */
+#define BLOCK_FLAG_GAP              0x01    /* samples were lost before this block */
+#define BLOCK_FLAG_OVERRUN          0x02    /* sensor FIFO overran before this block */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    BLOCK_POOL_EXHAUST_DROP = 0,    /* acquire fails immediately */
+    BLOCK_POOL_EXHAUST_WAIT = 1     /* acquire waits up to wait_timeout_us for a release */
+} block_pool_policy_t;
+
+typedef struct
+{
+    size_t n_blocks;
+    size_t payload_size;            /* bytes of sample data per block */
+    block_pool_policy_t policy;
+    uint32_t wait_timeout_us;       /* BLOCK_POOL_EXHAUST_WAIT only */
+} block_pool_cfg_t;
+
+typedef struct
+{
+    uint64_t acquired;              /* successful acquires */
+    uint64_t exhausted;             /* acquires that found the pool empty after the policy ran */
+    uint32_t in_use;
+    uint32_t in_use_max;            /* high-water mark */
+} block_pool_stats_t;
+
+typedef struct block_pool block_pool_t;
+
+/* a block : N timestamped samples plus metadata, sample i was taken at t_first_ns + i * dt_ns */
+typedef struct
+{
+    uint64_t seq;                   /* producer sequence number, a jump means blocks never reached this queue */
+    uint64_t t_first_ns;            /* CLOCK_MONOTONIC of the first sample */
+    uint32_t dt_ns;                 /* sample period */
+    uint32_t n_samples;
+    uint32_t flags;                 /* BLOCK_FLAG_* */
+    uint32_t cfg_gen;               /* producer configuration generation the samples were captured under */
+    uint32_t payload_size;          /* bytes available at data */
+    void *data;                     /* sample payload, layout owned by the producer */
+
+    /* pool bookkeeping, only touched by block_pool.c */
+    uint32_t refs;
+    uint32_t next;
+    block_pool_t *pool;
+} sample_block_t;
+
+block_pool_t* block_pool_init(const block_pool_cfg_t *cfg);
+
+int block_pool_free(block_pool_t *pool);
+
+/* take a block with one reference, NULL when exhausted (counted) */
+sample_block_t* block_pool_acquire(block_pool_t *pool);
+
+/* add 'count' references, e.g. one per extra consumer before fan-out */
+int block_ref(sample_block_t *blk, uint32_t count);
+
+/* drop one reference, the last one returns the block to its pool */
+int block_release(sample_block_t *blk);
+
+int block_pool_stats(block_pool_t *pool, block_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,87 @@
+#include "block_queue.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdatomic.h>
+
+/* head and tail on separate cache lines so producer and consumer do not false share */
+struct block_queue
+{
+    _Alignas(64) _Atomic size_t head;       /* next slot to write, producer owned */
+    _Alignas(64) _Atomic size_t tail;       /* next slot to read, consumer owned */
+    _Alignas(64) size_t mask;
+    sample_block_t **slots;
+};
+
+block_queue_t* block_queue_init(size_t capacity)
+{
+    if (capacity == 0) return NULL;
+
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+
+    block_queue_t *q = NULL;
+    if (posix_memalign((void **)&q, 64, sizeof(block_queue_t)) != 0) return NULL;
+
+    q->slots = calloc(cap, sizeof(sample_block_t *));
+    if (!q->slots)
+    {
+        fprintf(stderr, "[BLOCK_QUEUE]: ERROR mem alloc failed\n");
+        free(q);
+        return NULL;
+    }
+
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->mask = cap - 1;
+
+    return q;
+}
+
+int block_queue_free(block_queue_t *q)
+{
+    if (!q) return ERROR;
+
+    free(q->slots);
+    free(q);
+
+    return OK;
+}
+
+int block_queue_push(block_queue_t *q, sample_block_t *blk)
+{
+    if (!q || !blk) return ERROR;
+
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head - tail > q->mask) return ERROR;   /* full */
+
+    q->slots[head & q->mask] = blk;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+
+    return OK;
+}
+
+int block_queue_pop(block_queue_t *q, sample_block_t **blk)
+{
+    if (!q || !blk) return ERROR;
+
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (tail == head) return ERROR;             /* empty */
+
+    *blk = q->slots[tail & q->mask];
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+
+    return OK;
+}
+
+size_t block_queue_count(block_queue_t *q)
+{
+    if (!q) return 0;
+
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+    return head - tail;
+}
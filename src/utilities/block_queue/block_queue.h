@@ -0,0 +1,34 @@
+/* 
+Description : bounded single-producer / single-consumer queue of sample block handles
+*/
+
+#pragma once
+
+#include "utilities/block_pool/block_pool.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct block_queue block_queue_t;
+
+/* capacity is rounded up to a power of two */
+block_queue_t* block_queue_init(size_t capacity);
+
+/* queue must be drained first, the queue does not own references */
+int block_queue_free(block_queue_t *q);
+
+/* producer side, ERROR when full */
+int block_queue_push(block_queue_t *q, sample_block_t *blk);
+
+/* consumer side, ERROR when empty */
+int block_queue_pop(block_queue_t *q, sample_block_t **blk);
+
+size_t block_queue_count(block_queue_t *q);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,125 @@
+#include "fft.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define FFT_PI      3.14159265358979323846
+
+int fft_init(fft_t *fft, size_t n)
+{
+    if (!fft || n < 2 || (n & (n - 1)) != 0) return ERROR;
+
+    fft->twiddle_re = calloc(n / 2, sizeof(float));
+    fft->twiddle_im = calloc(n / 2, sizeof(float));
+    fft->bitrev = calloc(n, sizeof(uint32_t));
+    if (!fft->twiddle_re || !fft->twiddle_im || !fft->bitrev)
+    {
+        fprintf(stderr, "[FFT]: ERROR mem alloc failed\n");
+        free(fft->twiddle_re);
+        free(fft->twiddle_im);
+        free(fft->bitrev);
+        return ERROR;
+    }
+
+    for (size_t k = 0; k < n / 2; k++)
+    {
+        double angle = 2.0 * FFT_PI * (double)k / (double)n;
+        fft->twiddle_re[k] = (float)cos(angle);
+        fft->twiddle_im[k] = (float)-sin(angle);
+    }
+
+    unsigned int log2n = 0;
+    while (((size_t)1 << log2n) < n) log2n++;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t r = 0;
+        for (unsigned int b = 0; b < log2n; b++)
+        {
+            if (i & ((size_t)1 << b)) r |= 1u << (log2n - 1 - b);
+        }
+        fft->bitrev[i] = r;
+    }
+
+    fft->n = n;
+
+    return OK;
+}
+
+int fft_free(fft_t *fft)
+{
+    if (!fft || !fft->bitrev) return ERROR;
+
+    free(fft->twiddle_re);
+    free(fft->twiddle_im);
+    free(fft->bitrev);
+    fft->twiddle_re = fft->twiddle_im = NULL;
+    fft->bitrev = NULL;
+    fft->n = 0;
+
+    return OK;
+}
+
+int fft_forward(const fft_t *fft, float *re, float *im)
+{
+    if (!fft || !fft->bitrev || !re || !im) return ERROR;
+
+    const size_t n = fft->n;
+
+    /* reorder into bit reversed positions */
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t j = fft->bitrev[i];
+        if (j > i)
+        {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    /* iterative butterflies */
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        size_t half = len >> 1;
+        size_t step = n / len;
+        for (size_t base = 0; base < n; base += len)
+        {
+            for (size_t k = 0; k < half; k++)
+            {
+                float wr = fft->twiddle_re[k * step];
+                float wi = fft->twiddle_im[k * step];
+                size_t a = base + k;
+                size_t b = a + half;
+
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+
+    return OK;
+}
+
+int fft_power_spectrum(const fft_t *fft, const float *in, float *re, float *im, float *power)
+{
+    if (!fft || !in || !re || !im || !power) return ERROR;
+
+    memcpy(re, in, fft->n * sizeof(float));
+    memset(im, 0, fft->n * sizeof(float));
+
+    if (fft_forward(fft, re, im) != OK) return ERROR;
+
+    for (size_t k = 0; k <= fft->n / 2; k++)
+    {
+        power[k] = re[k] * re[k] + im[k] * im[k];
+    }
+
+    return OK;
+}
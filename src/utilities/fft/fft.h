@@ -0,0 +1,35 @@
+/* 
+Description : in-place radix-2 complex FFT with precomputed twiddles
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    size_t n;                   /* transform length, power of two */
+    float *twiddle_re;          /* cos(2*pi*k/n), k < n/2 */
+    float *twiddle_im;          /* -sin(2*pi*k/n), k < n/2 */
+    uint32_t *bitrev;           /* bit reversed index table */
+} fft_t;
+
+int fft_init(fft_t *fft, size_t n);
+
+int fft_free(fft_t *fft);
+
+/* forward transform of re/im (n elements each), in place */
+int fft_forward(const fft_t *fft, float *re, float *im);
+
+/* power spectrum |X[k]|^2 for k in [0, n/2] of a real block; re/im are
+   n element scratch buffers, 'power' receives n/2 + 1 bins */
+int fft_power_spectrum(const fft_t *fft, const float *in, float *re, float *im, float *power);
+
+#ifdef __cplusplus
+}
+#endif
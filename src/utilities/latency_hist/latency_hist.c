@@ -0,0 +1,137 @@
+#include "latency_hist.h"
+#include "common_def.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* counters are plain words driven by __atomic builtins, the writer never takes a lock */
+struct latency_hist
+{
+    uint64_t buckets[LATENCY_HIST_BUCKETS];
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+};
+
+#define SUB_COUNT   (1u << LATENCY_HIST_SUB_BITS)
+
+size_t latency_hist_bucket(uint64_t ns)
+{
+    if (ns < (1ull << LATENCY_HIST_MIN_SHIFT)) return 0;
+    if (ns >= (1ull << LATENCY_HIST_MAX_SHIFT)) return LATENCY_HIST_BUCKETS - 1;
+
+    const unsigned shift = 63u - (unsigned)__builtin_clzll(ns);                    /* octave */
+    const unsigned sub = (unsigned)(ns >> (shift - LATENCY_HIST_SUB_BITS)) & (SUB_COUNT - 1);
+
+    return ((size_t)(shift - LATENCY_HIST_MIN_SHIFT) << LATENCY_HIST_SUB_BITS) + sub;
+}
+
+uint64_t latency_hist_bucket_upper(size_t bucket)
+{
+    if (bucket >= LATENCY_HIST_BUCKETS - 1) return UINT64_MAX;
+
+    const unsigned shift = (unsigned)(bucket >> LATENCY_HIST_SUB_BITS) + LATENCY_HIST_MIN_SHIFT;
+    const uint64_t sub = bucket & (SUB_COUNT - 1);
+
+    /* bucket covers [2^shift + sub * step, 2^shift + (sub + 1) * step) */
+    return (1ull << shift) + (sub + 1) * (1ull << (shift - LATENCY_HIST_SUB_BITS)) - 1;
+}
+
+latency_hist_t* latency_hist_init(void)
+{
+    latency_hist_t *h = calloc(1, sizeof(latency_hist_t));
+    if (!h) return NULL;
+
+    h->min_ns = UINT64_MAX;
+
+    return h;
+}
+
+int latency_hist_free(latency_hist_t *h)
+{
+    if (!h) return ERROR;
+
+    free(h);
+
+    return OK;
+}
+
+void latency_hist_record(latency_hist_t *h, uint64_t ns)
+{
+    if (!h) return;
+
+    __atomic_fetch_add(&h->buckets[latency_hist_bucket(ns)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->sum_ns, ns, __ATOMIC_RELAXED);
+    if (ns < __atomic_load_n(&h->min_ns, __ATOMIC_RELAXED)) __atomic_store_n(&h->min_ns, ns, __ATOMIC_RELAXED);
+    if (ns > __atomic_load_n(&h->max_ns, __ATOMIC_RELAXED)) __atomic_store_n(&h->max_ns, ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->count, 1, __ATOMIC_RELEASE);
+}
+
+void latency_hist_reset(latency_hist_t *h)
+{
+    if (!h) return;
+
+    for (size_t i = 0; i < LATENCY_HIST_BUCKETS; i++) __atomic_store_n(&h->buckets[i], 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->sum_ns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->min_ns, UINT64_MAX, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->max_ns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->count, 0, __ATOMIC_RELEASE);
+}
+
+int latency_hist_percentile(latency_hist_t *h, double q, uint64_t *ns)
+{
+    if (!h || !ns) return ERROR;
+
+    /* sum buckets rather than trusting count, a concurrent record may be half done */
+    uint64_t snap[LATENCY_HIST_BUCKETS];
+    uint64_t total = 0;
+    for (size_t i = 0; i < LATENCY_HIST_BUCKETS; i++)
+    {
+        snap[i] = __atomic_load_n(&h->buckets[i], __ATOMIC_RELAXED);
+        total += snap[i];
+    }
+    if (total == 0) return ERROR;
+
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+
+    uint64_t rank = (uint64_t)(q * (double)total + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LATENCY_HIST_BUCKETS; i++)
+    {
+        seen += snap[i];
+        if (seen >= rank)
+        {
+            /* never report beyond the largest value actually seen */
+            const uint64_t upper = latency_hist_bucket_upper(i);
+            const uint64_t max = __atomic_load_n(&h->max_ns, __ATOMIC_RELAXED);
+            *ns = (upper > max) ? max : upper;
+            return OK;
+        }
+    }
+
+    return ERROR;
+}
+
+int latency_hist_summary(latency_hist_t *h, latency_summary_t *out)
+{
+    if (!h || !out) return ERROR;
+
+    memset(out, 0, sizeof(latency_summary_t));
+
+    out->count = __atomic_load_n(&h->count, __ATOMIC_ACQUIRE);
+    if (out->count == 0) return ERROR;
+
+    out->min_ns = __atomic_load_n(&h->min_ns, __ATOMIC_RELAXED);
+    out->max_ns = __atomic_load_n(&h->max_ns, __ATOMIC_RELAXED);
+    out->mean_ns = __atomic_load_n(&h->sum_ns, __ATOMIC_RELAXED) / out->count;
+
+    if (latency_hist_percentile(h, 0.50, &out->p50_ns) != OK) return ERROR;
+    if (latency_hist_percentile(h, 0.99, &out->p99_ns) != OK) return ERROR;
+    if (latency_hist_percentile(h, 0.999, &out->p999_ns) != OK) return ERROR;
+
+    return OK;
+}
@@ -0,0 +1,53 @@
+/* 
+Description : log-linear latency histogram (8 sub-buckets per power of two, ~12% resolution)
+              - single writer, any number of concurrent readers
+              - covers 1 us .. ~68 s, values outside are clamped into the end buckets
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LATENCY_HIST_SUB_BITS       3
+#define LATENCY_HIST_MIN_SHIFT      10                  /* first octave starts at 1024 ns */
+#define LATENCY_HIST_MAX_SHIFT      36                  /* last octave ends at ~68.7 s */
+#define LATENCY_HIST_BUCKETS        (((LATENCY_HIST_MAX_SHIFT - LATENCY_HIST_MIN_SHIFT) << LATENCY_HIST_SUB_BITS) + 1)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct latency_hist latency_hist_t;
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+} latency_summary_t;
+
+latency_hist_t* latency_hist_init(void);
+
+int latency_hist_free(latency_hist_t *h);
+
+void latency_hist_record(latency_hist_t *h, uint64_t ns);
+
+void latency_hist_reset(latency_hist_t *h);
+
+/* upper bound of the bucket holding quantile q (0..1), ERROR when empty */
+int latency_hist_percentile(latency_hist_t *h, double q, uint64_t *ns);
+
+int latency_hist_summary(latency_hist_t *h, latency_summary_t *out);
+
+/* bucket helpers, exposed for tests */
+size_t latency_hist_bucket(uint64_t ns);
+uint64_t latency_hist_bucket_upper(size_t bucket);
+
+#ifdef __cplusplus
+}
+#endif
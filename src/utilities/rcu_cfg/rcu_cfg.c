@@ -0,0 +1,146 @@
+#include "rcu_cfg.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+typedef struct
+{
+    uint32_t gen;
+    uint64_t retire_epoch;          /* epoch that replaced this copy */
+    max_align_t payload[];
+} rcu_node_t;
+
+struct rcu_cfg
+{
+    size_t size;                    /* payload size in bytes */
+    uint32_t n_readers;
+    _Atomic(rcu_node_t *) current;
+    _Atomic uint64_t epoch;         /* bumped by every publish */
+    _Atomic uint64_t reader_epoch[RCU_CFG_MAX_READERS];     /* epoch seen at the last quiescent state */
+    rcu_node_t *retired[RCU_CFG_MAX_RETIRED];               /* writer only */
+    _Atomic size_t n_retired;
+};
+
+static rcu_node_t* node_alloc(size_t size, const void *cfg, uint32_t gen)
+{
+    rcu_node_t *node = malloc(sizeof(rcu_node_t) + size);
+    if (!node) return NULL;
+
+    node->gen = gen;
+    node->retire_epoch = 0;
+    memcpy(node->payload, cfg, size);
+
+    return node;
+}
+
+/* free every retired copy all readers have moved past */
+static void reclaim(rcu_cfg_t *rc)
+{
+    uint64_t min_epoch = UINT64_MAX;
+    for (uint32_t r = 0; r < rc->n_readers; r++)
+    {
+        const uint64_t e = atomic_load_explicit(&rc->reader_epoch[r], memory_order_acquire);
+        if (e < min_epoch) min_epoch = e;
+    }
+
+    size_t kept = 0;
+    const size_t n = atomic_load_explicit(&rc->n_retired, memory_order_relaxed);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (rc->retired[i]->retire_epoch <= min_epoch) free(rc->retired[i]);
+        else rc->retired[kept++] = rc->retired[i];
+    }
+    atomic_store_explicit(&rc->n_retired, kept, memory_order_relaxed);
+}
+
+rcu_cfg_t* rcu_cfg_init(size_t size, const void *initial, uint32_t n_readers)
+{
+    if (size == 0 || !initial || n_readers > RCU_CFG_MAX_READERS) return NULL;
+
+    rcu_cfg_t *rc = calloc(1, sizeof(rcu_cfg_t));
+    if (!rc) return NULL;
+
+    rcu_node_t *node = node_alloc(size, initial, 1);
+    if (!node)
+    {
+        fprintf(stderr, "[RCU_CFG]: ERROR mem alloc failed\n");
+        free(rc);
+        return NULL;
+    }
+
+    rc->size = size;
+    rc->n_readers = n_readers;
+    atomic_init(&rc->current, node);
+    atomic_init(&rc->epoch, 0);
+    for (uint32_t r = 0; r < RCU_CFG_MAX_READERS; r++) atomic_init(&rc->reader_epoch[r], 0);
+    atomic_init(&rc->n_retired, 0);
+
+    return rc;
+}
+
+int rcu_cfg_free(rcu_cfg_t *rc)
+{
+    if (!rc) return ERROR;
+
+    const size_t n = atomic_load(&rc->n_retired);
+    for (size_t i = 0; i < n; i++) free(rc->retired[i]);
+    free(atomic_load(&rc->current));
+    free(rc);
+
+    return OK;
+}
+
+int rcu_cfg_publish(rcu_cfg_t *rc, const void *cfg, uint32_t *gen)
+{
+    if (!rc || !cfg) return ERROR;
+
+    reclaim(rc);
+    const size_t n = atomic_load_explicit(&rc->n_retired, memory_order_relaxed);
+    if (n == RCU_CFG_MAX_RETIRED) return ERROR;
+
+    rcu_node_t *prev = atomic_load_explicit(&rc->current, memory_order_relaxed);
+    rcu_node_t *node = node_alloc(rc->size, cfg, prev->gen + 1);
+    if (!node) return ERROR;
+
+    /* swap first : a reader reporting the new epoch has already seen the new copy */
+    atomic_store_explicit(&rc->current, node, memory_order_seq_cst);
+    prev->retire_epoch = atomic_fetch_add_explicit(&rc->epoch, 1, memory_order_seq_cst) + 1;
+    rc->retired[n] = prev;
+    atomic_store_explicit(&rc->n_retired, n + 1, memory_order_relaxed);
+
+    reclaim(rc);
+    if (gen) *gen = node->gen;
+
+    return OK;
+}
+
+const void* rcu_cfg_read(rcu_cfg_t *rc, uint32_t reader, uint32_t *gen)
+{
+    if (!rc || reader >= rc->n_readers) return NULL;
+
+    const rcu_node_t *node = atomic_load_explicit(&rc->current, memory_order_acquire);
+    if (gen) *gen = node->gen;
+
+    return node->payload;
+}
+
+int rcu_cfg_quiescent(rcu_cfg_t *rc, uint32_t reader)
+{
+    if (!rc || reader >= rc->n_readers) return ERROR;
+
+    const uint64_t e = atomic_load_explicit(&rc->epoch, memory_order_seq_cst);
+    atomic_store_explicit(&rc->reader_epoch[reader], e, memory_order_release);
+
+    return OK;
+}
+
+size_t rcu_cfg_retired(rcu_cfg_t *rc)
+{
+    if (!rc) return 0;
+
+    return atomic_load_explicit(&rc->n_retired, memory_order_relaxed);
+}
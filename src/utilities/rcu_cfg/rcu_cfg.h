@@ -0,0 +1,45 @@
+/*
+Description : RCU-style publication of an immutable, fixed-size configuration
+              - one writer publishes a new copy and swaps the pointer, readers
+                never block and never copy
+              - quiescent-state based reclamation : a replaced copy is freed once
+                every registered reader has reported a quiescent state after it
+              - every publish gets the next generation number
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define RCU_CFG_MAX_READERS         8
+#define RCU_CFG_MAX_RETIRED         8       /* replaced copies a stalled reader can hold back */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rcu_cfg rcu_cfg_t;
+
+/* 'initial' is published as generation 1 */
+rcu_cfg_t* rcu_cfg_init(size_t size, const void *initial, uint32_t n_readers);
+
+/* no reader may be inside a read section */
+int rcu_cfg_free(rcu_cfg_t *rc);
+
+/* writer side : publish a copy of 'cfg', reclaim what the readers released; ERROR when
+   RCU_CFG_MAX_RETIRED copies are still held by a reader that has not reported in */
+int rcu_cfg_publish(rcu_cfg_t *rc, const void *cfg, uint32_t *gen);
+
+/* reader side : current copy, valid until 'reader' calls rcu_cfg_quiescent() */
+const void* rcu_cfg_read(rcu_cfg_t *rc, uint32_t reader, uint32_t *gen);
+
+/* 'reader' holds no pointer returned by rcu_cfg_read() any more */
+int rcu_cfg_quiescent(rcu_cfg_t *rc, uint32_t reader);
+
+/* replaced copies not reclaimed yet */
+size_t rcu_cfg_retired(rcu_cfg_t *rc);
+
+#ifdef __cplusplus
+}
+#endif
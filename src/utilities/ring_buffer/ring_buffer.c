@@ -7,7 +7,7 @@ int ring_buffer_init(ring_buffer_t *rb, size_t capacity, size_t element_size)
 {
     if (!rb || capacity == 0 || element_size == 0) return ERROR; 
     
-    if (capacity > 1024) capacity = 1024; /* max cap is 1024 items */
+    if (capacity > RING_BUFFER_MAX_CAPACITY) capacity = RING_BUFFER_MAX_CAPACITY;
 
     rb->buffer = calloc(1, capacity * element_size);
     if (!rb->buffer) return ERROR;
@@ -4,6 +4,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#define RING_BUFFER_MAX_CAPACITY    1024    /* init clamps capacity to this many items */
+
 typedef struct
 {
     uint8_t *buffer;            /* raw byte buffer */
@@ -0,0 +1,105 @@
+#include "snapshot.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#define SNAPSHOT_READ_RETRIES       16
+
+struct snapshot
+{
+    uint8_t *slot[2];               /* payload buffers */
+    _Atomic uint32_t seq[2];        /* per-slot sequence, odd while writing */
+    _Atomic uint64_t gen[2];        /* publish count the slot holds, written inside its seq window */
+    _Atomic uint32_t active;        /* slot index readers should use */
+    uint64_t generation;            /* number of publishes so far, writer only */
+    size_t size;                    /* payload size in bytes */
+};
+
+snapshot_t* snapshot_init(size_t size)
+{
+    if (size == 0) return NULL;
+
+    snapshot_t *snap = calloc(1, sizeof(snapshot_t));
+    if (!snap) return NULL;
+
+    snap->slot[0] = calloc(1, size);
+    snap->slot[1] = calloc(1, size);
+    if (!snap->slot[0] || !snap->slot[1])
+    {
+        fprintf(stderr, "[SNAPSHOT]: ERROR mem alloc failed\n");
+        free(snap->slot[0]);
+        free(snap->slot[1]);
+        free(snap);
+        return NULL;
+    }
+
+    atomic_init(&snap->seq[0], 0);
+    atomic_init(&snap->seq[1], 0);
+    atomic_init(&snap->gen[0], 0);
+    atomic_init(&snap->gen[1], 0);
+    atomic_init(&snap->active, 0);
+    snap->generation = 0;
+    snap->size = size;
+
+    return snap;
+}
+
+int snapshot_free(snapshot_t *snap)
+{
+    if (!snap) return ERROR;
+
+    free(snap->slot[0]);
+    free(snap->slot[1]);
+    free(snap);
+
+    return OK;
+}
+
+int snapshot_publish(snapshot_t *snap, const void *data)
+{
+    if (!snap || !data) return ERROR;
+
+    /* always write the slot readers are not pointed at */
+    uint32_t idx = atomic_load_explicit(&snap->active, memory_order_relaxed) ^ 1u;
+    uint32_t seq = atomic_load_explicit(&snap->seq[idx], memory_order_relaxed);
+
+    atomic_store_explicit(&snap->seq[idx], seq + 1, memory_order_relaxed);  /* odd : write in progress */
+    atomic_thread_fence(memory_order_release);
+
+    memcpy(snap->slot[idx], data, snap->size);
+    atomic_store_explicit(&snap->gen[idx], ++snap->generation, memory_order_relaxed);
+
+    atomic_store_explicit(&snap->seq[idx], seq + 2, memory_order_release);  /* even : slot stable */
+    atomic_store_explicit(&snap->active, idx, memory_order_release);
+
+    return OK;
+}
+
+int snapshot_read(snapshot_t *snap, void *out, uint64_t *generation)
+{
+    if (!snap || !out) return ERROR;
+
+    for (int attempt = 0; attempt < SNAPSHOT_READ_RETRIES; attempt++)
+    {
+        uint32_t idx = atomic_load_explicit(&snap->active, memory_order_acquire);
+        uint32_t seq_start = atomic_load_explicit(&snap->seq[idx], memory_order_acquire);
+        if (seq_start & 1u) continue;   /* writer lapped us onto this slot */
+
+        /* the generation travels with the payload : both are validated by the same seq */
+        uint64_t gen = atomic_load_explicit(&snap->gen[idx], memory_order_relaxed);
+        memcpy(out, snap->slot[idx], snap->size);
+
+        atomic_thread_fence(memory_order_acquire);
+        uint32_t seq_end = atomic_load_explicit(&snap->seq[idx], memory_order_relaxed);
+        if (seq_start == seq_end)
+        {
+            if (generation) *generation = gen;
+            return OK;
+        }
+    }
+
+    fprintf(stderr, "[SNAPSHOT]: ERROR read retries exhausted\n");
+    return ERROR;
+}
@@ -0,0 +1,36 @@
+/* 
+Description : double-buffered seqlock snapshot for publishing fixed-size state
+              from one writer thread to any number of reader threads
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ - single writer : publish never blocks and never waits on readers
+ - many readers  : each read copies the latest complete slot; a reader only
+                   retries if the writer has overwritten that same slot while
+                   it was copying, which takes two full publishes
+*/
+typedef struct snapshot snapshot_t;
+
+snapshot_t* snapshot_init(size_t size);
+
+int snapshot_free(snapshot_t *snap);
+
+/* writer side : copy 'data' into the inactive slot and flip it live */
+int snapshot_publish(snapshot_t *snap, const void *data);
+
+/* reader side : copy the live slot into 'out'. 'generation' (optional) is
+   the number of publishes visible when the copy was taken, 0 = never published */
+int snapshot_read(snapshot_t *snap, void *out, uint64_t *generation);
+
+#ifdef __cplusplus
+}
+#endif
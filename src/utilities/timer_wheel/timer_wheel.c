@@ -0,0 +1,140 @@
+#include "timer_wheel.h"
+#include "common_def.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOT_MASK   (TIMER_WHEEL_SLOTS - 1)
+#define NIL         (-1)
+
+typedef struct
+{
+    timer_wheel_cb_t cb;        /* NULL = free entry */
+    void *arg;
+    uint64_t expires;           /* absolute tick */
+    uint64_t period;            /* ticks */
+    int next;                   /* slot list */
+} tw_timer_t;
+
+struct timer_wheel
+{
+    uint32_t tick_ms;
+    uint64_t origin_ms;
+    uint64_t tick;              /* next tick to process */
+    int slot[TIMER_WHEEL_SLOTS];
+    tw_timer_t timers[TIMER_WHEEL_MAX_TIMERS];
+};
+
+static void slot_insert(timer_wheel_t *tw, int id)
+{
+    int *head = &tw->slot[tw->timers[id].expires & SLOT_MASK];
+    tw->timers[id].next = *head;
+    *head = id;
+}
+
+static void slot_remove(timer_wheel_t *tw, int id)
+{
+    int *link = &tw->slot[tw->timers[id].expires & SLOT_MASK];
+    while (*link != NIL)
+    {
+        if (*link == id)
+        {
+            *link = tw->timers[id].next;
+            return;
+        }
+        link = &tw->timers[*link].next;
+    }
+}
+
+timer_wheel_t* timer_wheel_init(uint32_t tick_ms, uint64_t now_ms)
+{
+    if (tick_ms == 0) return NULL;
+
+    timer_wheel_t *tw = calloc(1, sizeof(timer_wheel_t));
+    if (!tw) return NULL;
+
+    tw->tick_ms = tick_ms;
+    tw->origin_ms = now_ms;
+    tw->tick = 0;
+    for (int i = 0; i < TIMER_WHEEL_SLOTS; i++) tw->slot[i] = NIL;
+
+    return tw;
+}
+
+int timer_wheel_free(timer_wheel_t *tw)
+{
+    if (!tw) return ERROR;
+
+    free(tw);
+
+    return OK;
+}
+
+int timer_wheel_add(timer_wheel_t *tw, uint32_t period_ms, timer_wheel_cb_t cb, void *arg)
+{
+    if (!tw || !cb || period_ms == 0) return ERROR;
+
+    for (int id = 0; id < TIMER_WHEEL_MAX_TIMERS; id++)
+    {
+        tw_timer_t *t = &tw->timers[id];
+        if (t->cb) continue;
+
+        t->cb = cb;
+        t->arg = arg;
+        t->period = (period_ms + tw->tick_ms - 1) / tw->tick_ms;
+        t->expires = tw->tick + t->period;
+        slot_insert(tw, id);
+
+        return id;
+    }
+
+    return ERROR;
+}
+
+int timer_wheel_cancel(timer_wheel_t *tw, int id)
+{
+    if (!tw || id < 0 || id >= TIMER_WHEEL_MAX_TIMERS || !tw->timers[id].cb) return ERROR;
+
+    slot_remove(tw, id);
+    tw->timers[id].cb = NULL;
+
+    return OK;
+}
+
+int timer_wheel_advance(timer_wheel_t *tw, uint64_t now_ms, uint32_t max_fire)
+{
+    if (!tw || now_ms < tw->origin_ms) return 0;
+
+    const uint64_t now_tick = (now_ms - tw->origin_ms) / tw->tick_ms;
+    int fired = 0;
+
+    /* every tick up to now is visited in order, a timer only sits in the slot of its own tick */
+    while (tw->tick <= now_tick)
+    {
+        int *link = &tw->slot[tw->tick & SLOT_MASK];
+        while (*link != NIL)
+        {
+            const int id = *link;
+            tw_timer_t *t = &tw->timers[id];
+            if (t->expires > tw->tick)
+            {
+                link = &t->next;            /* a later lap of the wheel */
+                continue;
+            }
+
+            if (max_fire && (uint32_t)fired == max_fire) return fired;   /* resume at this tick */
+
+            /* re-arm before the callback so it may cancel itself; missed periods are skipped */
+            *link = t->next;
+            t->expires += t->period;
+            if (t->expires <= now_tick) t->expires = now_tick + t->period;
+            slot_insert(tw, id);
+
+            t->cb(t->arg, now_ms);
+            fired++;
+        }
+        tw->tick++;
+    }
+
+    return fired;
+}
@@ -0,0 +1,37 @@
+/* 
+Description : hashed timer wheel for periodic low-rate work inside an existing loop
+              - no thread, no allocation after init : the owner calls timer_wheel_advance()
+              - max_fire bounds the work done per call, late timers fire on the next call
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TIMER_WHEEL_SLOTS           64          /* power of two */
+#define TIMER_WHEEL_MAX_TIMERS      16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct timer_wheel timer_wheel_t;
+
+typedef void (*timer_wheel_cb_t)(void *arg, uint64_t now_ms);
+
+timer_wheel_t* timer_wheel_init(uint32_t tick_ms, uint64_t now_ms);
+
+int timer_wheel_free(timer_wheel_t *tw);
+
+/* periodic timer, first expiry one period from the wheel's current time; returns id or ERROR */
+int timer_wheel_add(timer_wheel_t *tw, uint32_t period_ms, timer_wheel_cb_t cb, void *arg);
+
+int timer_wheel_cancel(timer_wheel_t *tw, int id);
+
+/* run expired timers up to 'now_ms', at most 'max_fire' callbacks (0 = no limit); returns the number fired */
+int timer_wheel_advance(timer_wheel_t *tw, uint64_t now_ms, uint32_t max_fire);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,189 @@
+#define _GNU_SOURCE     /* gettid */
+#include "trace.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define TRACE_MAGIC             0x43525445u     /* "ETRC" */
+#define TRACE_VERSION           1u
+
+typedef struct
+{
+    uint32_t tid;
+    int owned;                                  /* 0 once the thread unregistered, slot reusable */
+    char name[TRACE_NAME_LEN];
+    uint64_t written;                           /* total events, ring index = written % size */
+    trace_event_t events[TRACE_EVENTS_PER_THREAD];
+} trace_buf_t;
+
+static const char *const trace_point_names[TRACE_POINT_COUNT] = {
+    [TRACE_SPI_XFER]   = "spi_xfer",
+    [TRACE_FIFO_DRAIN] = "fifo_drain",
+    [TRACE_BLOCK_PUSH] = "block_push",
+    [TRACE_BLOCK_POP]  = "block_pop",
+    [TRACE_FEATURES]   = "features",
+    [TRACE_ALARM]      = "alarm",
+    [TRACE_INFERENCE]  = "inference",
+    [TRACE_KURTOGRAM]  = "kurtogram",
+};
+
+int trace_enabled_flag = 0;
+
+static trace_buf_t *trace_bufs[TRACE_MAX_THREADS];
+static uint32_t trace_n_bufs = 0;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;     /* registration and dump only */
+static _Thread_local trace_buf_t *tls_buf = NULL;
+static _Thread_local int tls_full = 0;          /* registration failed, stop retrying */
+static _Thread_local char tls_name[TRACE_NAME_LEN];
+
+void trace_enable(int on)
+{
+    __atomic_store_n(&trace_enabled_flag, on ? 1 : 0, __ATOMIC_RELAXED);
+}
+
+/*
+ give the calling thread a buffer, under the lock
+ - a slot released by a thread of the same name is taken over with its events, so a restarted
+   stage keeps one timeline; failing that a fresh slot, failing that any released one (cleared)
+*/
+static int thread_attach(void)
+{
+    const char *name = tls_name[0] ? tls_name : "thread";
+    trace_buf_t *buf = NULL;
+
+    pthread_mutex_lock(&trace_lock);
+    for (uint32_t i = 0; i < trace_n_bufs && !buf; i++)
+    {
+        if (!trace_bufs[i]->owned && strcmp(trace_bufs[i]->name, name) == 0) buf = trace_bufs[i];
+    }
+    if (!buf && trace_n_bufs < TRACE_MAX_THREADS)
+    {
+        buf = calloc(1, sizeof(trace_buf_t));
+        if (buf) trace_bufs[trace_n_bufs++] = buf;
+    }
+    for (uint32_t i = 0; i < trace_n_bufs && !buf; i++)
+    {
+        if (!trace_bufs[i]->owned)
+        {
+            buf = trace_bufs[i];
+            __atomic_store_n(&buf->written, 0, __ATOMIC_RELEASE);
+        }
+    }
+    if (buf)
+    {
+        buf->tid = (uint32_t)gettid();
+        buf->owned = 1;
+        snprintf(buf->name, sizeof(buf->name), "%s", name);
+    }
+    pthread_mutex_unlock(&trace_lock);
+
+    if (!buf)
+    {
+        tls_full = 1;
+        return ERROR;
+    }
+    tls_buf = buf;
+
+    return OK;
+}
+
+int trace_thread_register(const char *name)
+{
+    if (name) snprintf(tls_name, sizeof(tls_name), "%s", name);
+    if (tls_buf) return OK;
+
+    /* nothing to record yet : the buffer comes with the first event */
+    if (!trace_is_enabled()) return OK;
+
+    return thread_attach();
+}
+
+void trace_thread_unregister(void)
+{
+    tls_full = 0;
+    tls_name[0] = '\0';
+    if (!tls_buf) return;
+
+    pthread_mutex_lock(&trace_lock);
+    tls_buf->owned = 0;
+    pthread_mutex_unlock(&trace_lock);
+    tls_buf = NULL;
+}
+
+void trace_emit(trace_point_t point, trace_phase_t phase, uint64_t arg)
+{
+    if (!tls_buf && (tls_full || thread_attach() != OK)) return;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    trace_buf_t *buf = tls_buf;
+    trace_event_t *ev = &buf->events[buf->written % TRACE_EVENTS_PER_THREAD];
+    ev->ts_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    ev->arg = arg;
+    ev->point = (uint16_t)point;
+    ev->phase = (uint8_t)phase;
+
+    __atomic_store_n(&buf->written, buf->written + 1, __ATOMIC_RELEASE);
+}
+
+void trace_reset(void)
+{
+    pthread_mutex_lock(&trace_lock);
+    for (uint32_t i = 0; i < trace_n_bufs; i++) __atomic_store_n(&trace_bufs[i]->written, 0, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&trace_lock);
+}
+
+/*
+ file layout (little endian, native structs) :
+   u32 magic, u32 version, u32 n_points, char name[TRACE_NAME_LEN] * n_points,
+   u32 n_threads, then per thread : u32 tid, char name[TRACE_NAME_LEN], u32 n_events,
+   trace_event_t * n_events (oldest first)
+*/
+int trace_dump(const char *path)
+{
+    if (!path) return ERROR;
+
+    FILE *fp = fopen(path, "wb");
+    if (!fp)
+    {
+        fprintf(stderr, "TRACE: cannot open %s\n", path);
+        return ERROR;
+    }
+
+    const uint32_t hdr[3] = { TRACE_MAGIC, TRACE_VERSION, TRACE_POINT_COUNT };
+    fwrite(hdr, sizeof(hdr), 1, fp);
+    for (int p = 0; p < TRACE_POINT_COUNT; p++)
+    {
+        char name[TRACE_NAME_LEN] = {0};
+        snprintf(name, sizeof(name), "%s", trace_point_names[p]);
+        fwrite(name, sizeof(name), 1, fp);
+    }
+
+    pthread_mutex_lock(&trace_lock);
+    const uint32_t n_threads = trace_n_bufs;
+    fwrite(&n_threads, sizeof(n_threads), 1, fp);
+    for (uint32_t i = 0; i < n_threads; i++)
+    {
+        const trace_buf_t *buf = trace_bufs[i];
+        const uint64_t written = __atomic_load_n(&buf->written, __ATOMIC_ACQUIRE);
+        const uint32_t n = (written > TRACE_EVENTS_PER_THREAD) ? TRACE_EVENTS_PER_THREAD : (uint32_t)written;
+        const uint64_t first = written - n;
+
+        fwrite(&buf->tid, sizeof(buf->tid), 1, fp);
+        fwrite(buf->name, sizeof(buf->name), 1, fp);
+        fwrite(&n, sizeof(n), 1, fp);
+        for (uint64_t e = first; e < written; e++)
+        {
+            fwrite(&buf->events[e % TRACE_EVENTS_PER_THREAD], sizeof(trace_event_t), 1, fp);
+        }
+    }
+    pthread_mutex_unlock(&trace_lock);
+
+    return (fclose(fp) == 0) ? OK : ERROR;
+}
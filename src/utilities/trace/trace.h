@@ -0,0 +1,96 @@
+/* 
+Description : lightweight span tracing into per-thread binary buffers
+              - TRACE_* macros compile to nothing unless EDGE_TRACE is defined
+              - when compiled in, a disabled tracer costs one relaxed load + branch
+              - each thread writes its own ring of fixed-size events (no locks, no syscalls
+                beyond clock_gettime); trace_dump() writes them out for
+                scripts/trace_to_json.py
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRACE_MAX_THREADS           16
+#define TRACE_EVENTS_PER_THREAD     16384   /* ring, oldest events are overwritten */
+#define TRACE_NAME_LEN              32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* tracepoints, names in trace.c */
+typedef enum
+{
+    TRACE_SPI_XFER = 0,         /* one spidev transfer */
+    TRACE_FIFO_DRAIN,           /* FIFO level check + burst read into a block */
+    TRACE_BLOCK_PUSH,           /* fan-out of a block to subscriber queues */
+    TRACE_BLOCK_POP,            /* instant : a stage took a block off its queue, arg = seq */
+    TRACE_FEATURES,             /* feature extraction over one block */
+    TRACE_ALARM,                /* instant : alarm state decided, arg = alarm bits */
+    TRACE_INFERENCE,            /* model forward pass over one feature record */
+    TRACE_KURTOGRAM,            /* demodulation band selection over one block */
+    TRACE_POINT_COUNT
+} trace_point_t;
+
+typedef enum
+{
+    TRACE_PH_BEGIN = 'B',
+    TRACE_PH_END = 'E',
+    TRACE_PH_INSTANT = 'i'
+} trace_phase_t;
+
+/* on-disk / in-buffer event */
+typedef struct
+{
+    uint64_t ts_ns;             /* CLOCK_MONOTONIC */
+    uint64_t arg;               /* e.g. block sequence number */
+    uint16_t point;             /* trace_point_t */
+    uint8_t phase;              /* trace_phase_t */
+    uint8_t reserved[5];
+} trace_event_t;
+
+extern int trace_enabled_flag;
+
+static inline int trace_is_enabled(void)
+{
+    return __atomic_load_n(&trace_enabled_flag, __ATOMIC_RELAXED);
+}
+
+/* runtime switch, tracing starts disabled */
+void trace_enable(int on);
+
+/*
+ name the calling thread (optional, unnamed threads show as "thread")
+ - its buffer is allocated now if tracing is enabled, else with its first event, so threads that
+   never record anything cost nothing
+*/
+int trace_thread_register(const char *name);
+
+/* calling thread is exiting : its events stay for trace_dump(), the slot goes back for reuse
+   (first by a thread registering under the same name) */
+void trace_thread_unregister(void);
+
+void trace_emit(trace_point_t point, trace_phase_t phase, uint64_t arg);
+
+/* write all thread buffers to 'path'; disable tracing first for a consistent dump */
+int trace_dump(const char *path);
+
+/* drop all recorded events, keep thread registrations */
+void trace_reset(void);
+
+#ifdef EDGE_TRACE
+#define TRACE_EMIT_(point, phase, arg)  \
+    do { if (__builtin_expect(trace_is_enabled(), 0)) trace_emit((point), (phase), (uint64_t)(arg)); } while (0)
+#else
+#define TRACE_EMIT_(point, phase, arg)  do { (void)(arg); } while (0)
+#endif
+
+#define TRACE_BEGIN(point, arg)         TRACE_EMIT_(point, TRACE_PH_BEGIN, arg)
+#define TRACE_END(point, arg)           TRACE_EMIT_(point, TRACE_PH_END, arg)
+#define TRACE_INSTANT(point, arg)       TRACE_EMIT_(point, TRACE_PH_INSTANT, arg)
+
+#ifdef __cplusplus
+}
+#endif
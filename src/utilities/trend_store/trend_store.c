@@ -0,0 +1,466 @@
+#include "trend_store.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TREND_STORE_MAGIC           0x54524E44u     /* "TRND" */
+#define TREND_STORE_VERSION         1u
+#define TREND_STORE_READ_RETRIES    64
+
+/* on-disk layout : file header | per tier { accumulator bucket | ring of buckets } */
+typedef struct
+{
+    float min;
+    float max;
+    float mean;
+    float ms;                   /* mean square; ring buckets store RMS here */
+} trend_stat_t;
+
+typedef struct
+{
+    uint64_t start_ms;
+    uint32_t count;             /* 0 = empty */
+    uint32_t reserved;
+    /* trend_stat_t stat[n_channels] follows */
+} trend_bucket_t;
+
+typedef struct
+{
+    uint64_t period_ms;
+    uint32_t slots;
+    uint32_t head;              /* next ring slot to write */
+    uint32_t count;             /* valid ring slots */
+    uint32_t reserved;
+    uint64_t acc_offset;        /* open bucket being accumulated */
+    uint64_t ring_offset;
+} trend_tier_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t n_channels;
+    uint32_t n_tiers;
+    trend_tier_t tier[TREND_STORE_MAX_TIERS];
+    uint64_t rejected;          /* records refused for going back in time */
+} trend_header_t;
+
+struct trend_store
+{
+    uint8_t *base;
+    size_t len;
+    int mapped;                 /* 1 if base is our own mmap */
+    trend_header_t *hdr;
+    size_t stride;              /* bytes per bucket */
+    _Atomic uint32_t seq;       /* odd while the writer is mid update */
+};
+
+static size_t bucket_stride(uint32_t n_channels)
+{
+    return sizeof(trend_bucket_t) + (size_t)n_channels * sizeof(trend_stat_t);
+}
+
+static int cfg_valid(const trend_store_cfg_t *cfg)
+{
+    if (!cfg) return 0;
+    if (cfg->n_channels == 0 || cfg->n_channels > TREND_STORE_MAX_CHANNELS) return 0;
+    if (cfg->n_tiers == 0 || cfg->n_tiers > TREND_STORE_MAX_TIERS) return 0;
+
+    for (uint32_t t = 0; t < cfg->n_tiers; t++)
+    {
+        if (cfg->tier[t].period_ms == 0 || cfg->tier[t].slots == 0) return 0;
+        if (t > 0 && (cfg->tier[t].period_ms <= cfg->tier[t - 1].period_ms ||
+                      cfg->tier[t].period_ms % cfg->tier[t - 1].period_ms != 0)) return 0;
+    }
+
+    return 1;
+}
+
+size_t trend_store_size(const trend_store_cfg_t *cfg)
+{
+    if (!cfg_valid(cfg)) return 0;
+
+    size_t size = sizeof(trend_header_t);
+    for (uint32_t t = 0; t < cfg->n_tiers; t++)
+    {
+        size += (1 + (size_t)cfg->tier[t].slots) * bucket_stride(cfg->n_channels);
+    }
+
+    return size;
+}
+
+static inline trend_bucket_t *bucket_at(trend_store_t *store, uint64_t offset)
+{
+    return (trend_bucket_t *)(store->base + offset);
+}
+
+static inline trend_stat_t *bucket_stats(trend_bucket_t *b)
+{
+    return (trend_stat_t *)(b + 1);
+}
+
+static inline trend_bucket_t *ring_slot(trend_store_t *store, const trend_tier_t *tier, uint32_t slot)
+{
+    return bucket_at(store, tier->ring_offset + (uint64_t)slot * store->stride);
+}
+
+/*
+ existing contents are reused only if written with an identical layout
+ - the bucket offsets are recomputed from 'cfg', never trusted from the file : they address the mapping
+*/
+static int layout_matches(const trend_header_t *hdr, const trend_store_cfg_t *cfg)
+{
+    if (hdr->magic != TREND_STORE_MAGIC || hdr->version != TREND_STORE_VERSION) return 0;
+    if (hdr->n_channels != cfg->n_channels || hdr->n_tiers != cfg->n_tiers) return 0;
+
+    const size_t stride = bucket_stride(cfg->n_channels);
+    uint64_t offset = sizeof(trend_header_t);
+    for (uint32_t t = 0; t < cfg->n_tiers; t++)
+    {
+        const trend_tier_t *tier = &hdr->tier[t];
+        if (tier->period_ms != cfg->tier[t].period_ms || tier->slots != cfg->tier[t].slots) return 0;
+        if (tier->head >= tier->slots || tier->count > tier->slots) return 0;
+        if (tier->acc_offset != offset || tier->ring_offset != offset + stride) return 0;
+        offset += (1 + (uint64_t)tier->slots) * stride;
+    }
+
+    return 1;
+}
+
+static void layout_init(trend_store_t *store, const trend_store_cfg_t *cfg)
+{
+    memset(store->base, 0, store->len);
+
+    trend_header_t *hdr = store->hdr;
+    hdr->n_channels = cfg->n_channels;
+    hdr->n_tiers = cfg->n_tiers;
+
+    uint64_t offset = sizeof(trend_header_t);
+    for (uint32_t t = 0; t < cfg->n_tiers; t++)
+    {
+        trend_tier_t *tier = &hdr->tier[t];
+        tier->period_ms = cfg->tier[t].period_ms;
+        tier->slots = cfg->tier[t].slots;
+        tier->acc_offset = offset;
+        tier->ring_offset = offset + store->stride;
+        offset += (1 + (uint64_t)tier->slots) * store->stride;
+    }
+
+    hdr->version = TREND_STORE_VERSION;
+    hdr->magic = TREND_STORE_MAGIC;     /* written last, marks the layout valid */
+}
+
+trend_store_t* trend_store_attach(void *mem, size_t len, const trend_store_cfg_t *cfg)
+{
+    size_t need = trend_store_size(cfg);
+    if (!mem || need == 0 || len < need) return NULL;
+
+    trend_store_t *store = calloc(1, sizeof(trend_store_t));
+    if (!store) return NULL;
+
+    store->base = (uint8_t *)mem;
+    store->len = need;
+    store->hdr = (trend_header_t *)mem;
+    store->stride = bucket_stride(cfg->n_channels);
+    atomic_init(&store->seq, 0);
+
+    if (!layout_matches(store->hdr, cfg))
+    {
+        fprintf(stdout, "TREND: initialising new store layout\n");
+        layout_init(store, cfg);
+    }
+
+    return store;
+}
+
+trend_store_t* trend_store_open(const char *path, const trend_store_cfg_t *cfg)
+{
+    size_t size = trend_store_size(cfg);
+    if (!path || size == 0) return NULL;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr, "TREND: failed to open %s\n", path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || ((size_t)st.st_size != size && ftruncate(fd, (off_t)size) < 0))
+    {
+        fprintf(stderr, "TREND: failed to size %s\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  /* mapping keeps the file referenced */
+    if (mem == MAP_FAILED)
+    {
+        fprintf(stderr, "TREND: mmap failed\n");
+        return NULL;
+    }
+
+    trend_store_t *store = trend_store_attach(mem, size, cfg);
+    if (!store)
+    {
+        munmap(mem, size);
+        return NULL;
+    }
+    store->mapped = 1;
+
+    return store;
+}
+
+int trend_store_close(trend_store_t *store)
+{
+    if (!store) return ERROR;
+
+    if (store->mapped)
+    {
+        msync(store->base, store->len, MS_ASYNC);
+        munmap(store->base, store->len);
+    }
+    free(store);
+
+    return OK;
+}
+
+/* fold 'src' (count records, stats with mean square) into accumulator 'acc' */
+static void bucket_merge(trend_bucket_t *acc, const trend_bucket_t *src, uint32_t n_channels)
+{
+    trend_stat_t *a = bucket_stats(acc);
+    const trend_stat_t *s = (const trend_stat_t *)(src + 1);
+
+    if (acc->count == 0)
+    {
+        memcpy(a, s, n_channels * sizeof(trend_stat_t));
+        acc->count = src->count;
+        return;
+    }
+
+    const float total = (float)acc->count + (float)src->count;
+    const float wa = (float)acc->count / total;
+    const float ws = (float)src->count / total;
+    for (uint32_t c = 0; c < n_channels; c++)
+    {
+        if (s[c].min < a[c].min) a[c].min = s[c].min;
+        if (s[c].max > a[c].max) a[c].max = s[c].max;
+        a[c].mean = a[c].mean * wa + s[c].mean * ws;
+        a[c].ms = a[c].ms * wa + s[c].ms * ws;
+    }
+    acc->count += src->count;
+}
+
+/* move the open bucket of tier 't' into its ring and roll it up into tier t + 1 */
+static void tier_close(trend_store_t *store, uint32_t t)
+{
+    trend_header_t *hdr = store->hdr;
+    trend_tier_t *tier = &hdr->tier[t];
+    trend_bucket_t *acc = bucket_at(store, tier->acc_offset);
+    if (acc->count == 0) return;
+
+    if (t + 1 < hdr->n_tiers)
+    {
+        trend_tier_t *parent = &hdr->tier[t + 1];
+        trend_bucket_t *parent_acc = bucket_at(store, parent->acc_offset);
+        uint64_t parent_start = acc->start_ms - (acc->start_ms % parent->period_ms);
+
+        if (parent_acc->count > 0 && parent_acc->start_ms != parent_start) tier_close(store, t + 1);
+        if (parent_acc->count == 0) parent_acc->start_ms = parent_start;
+        bucket_merge(parent_acc, acc, hdr->n_channels);
+    }
+
+    trend_bucket_t *slot = ring_slot(store, tier, tier->head);
+    memcpy(slot, acc, store->stride);
+
+    trend_stat_t *st = bucket_stats(slot);
+    for (uint32_t c = 0; c < hdr->n_channels; c++) st[c].ms = sqrtf(st[c].ms);
+
+    tier->head = (tier->head + 1) % tier->slots;
+    if (tier->count < tier->slots) tier->count++;
+
+    acc->count = 0;
+}
+
+int trend_store_add(trend_store_t *store, uint64_t now_ms, const float *values)
+{
+    if (!store || !values) return ERROR;
+
+    trend_header_t *hdr = store->hdr;
+    trend_tier_t *tier = &hdr->tier[0];
+    trend_bucket_t *acc = bucket_at(store, tier->acc_offset);
+    const uint64_t start = now_ms - (now_ms % tier->period_ms);
+
+    if (acc->count > 0 && start < acc->start_ms)
+    {
+        hdr->rejected++;
+        return ERROR;
+    }
+
+    uint32_t seq = atomic_load_explicit(&store->seq, memory_order_relaxed);
+    atomic_store_explicit(&store->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    if (acc->count > 0 && start != acc->start_ms) tier_close(store, 0);
+
+    trend_stat_t *a = bucket_stats(acc);
+    if (acc->count == 0)
+    {
+        acc->start_ms = start;
+        for (uint32_t c = 0; c < hdr->n_channels; c++)
+        {
+            a[c].min = a[c].max = a[c].mean = values[c];
+            a[c].ms = values[c] * values[c];
+        }
+        acc->count = 1;
+    }
+    else
+    {
+        acc->count++;
+        const float inv = 1.0f / (float)acc->count;
+        for (uint32_t c = 0; c < hdr->n_channels; c++)
+        {
+            const float v = values[c];
+            if (v < a[c].min) a[c].min = v;
+            if (v > a[c].max) a[c].max = v;
+            a[c].mean += (v - a[c].mean) * inv;
+            a[c].ms += (v * v - a[c].ms) * inv;
+        }
+    }
+
+    atomic_store_explicit(&store->seq, seq + 2, memory_order_release);
+
+    return OK;
+}
+
+static void point_from_slot(trend_store_t *store, trend_bucket_t *b, uint32_t channel, trend_point_t *out)
+{
+    const trend_stat_t *st = &bucket_stats(b)[channel];
+    out->start_ms = b->start_ms;
+    out->count = b->count;
+    out->min = st->min;
+    out->max = st->max;
+    out->mean = st->mean;
+    out->rms = st->ms;
+}
+
+/* first logical ring index whose bucket starts at or after t_ms (starts are monotonic) */
+static uint32_t lower_bound(trend_store_t *store, const trend_tier_t *tier, uint32_t oldest, uint64_t t_ms)
+{
+    uint32_t lo = 0;
+    uint32_t hi = tier->count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (ring_slot(store, tier, (oldest + mid) % tier->slots)->start_ms < t_ms) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* a ring that never wrapped still holds everything since the first record */
+static int tier_covers(trend_store_t *store, const trend_tier_t *tier, uint64_t t_ms)
+{
+    if (tier->count < tier->slots) return 1;
+
+    const uint32_t oldest = (tier->head + tier->slots - tier->count) % tier->slots;
+    return ring_slot(store, tier, oldest)->start_ms <= t_ms;
+}
+
+int trend_store_query(trend_store_t *store, 
+                      uint32_t channel, 
+                      uint64_t t_start_ms, 
+                      uint64_t t_end_ms,
+                      uint64_t resolution_ms, 
+                      trend_point_t *out, 
+                      size_t max_points, 
+                      size_t *n_points,
+                      trend_query_info_t *info)
+{
+    if (!store || !out || !n_points || channel >= store->hdr->n_channels || t_end_ms < t_start_ms) return ERROR;
+
+    const trend_header_t *hdr = store->hdr;
+    uint32_t finest = 0;
+    while (finest + 1 < hdr->n_tiers && hdr->tier[finest + 1].period_ms <= resolution_ms) finest++;
+
+    for (int attempt = 0; attempt < TREND_STORE_READ_RETRIES; attempt++)
+    {
+        uint32_t seq_start = atomic_load_explicit(&store->seq, memory_order_acquire);
+        if (seq_start & 1u) continue;
+
+        /* retention moves with every close, pick the tier under the same seq as the copy */
+        uint32_t t = finest;
+        while (t + 1 < hdr->n_tiers && !tier_covers(store, &hdr->tier[t], t_start_ms)) t++;
+        const trend_tier_t *tier = &hdr->tier[t];
+        int truncated = !tier_covers(store, tier, t_start_ms);
+
+        size_t n = 0;
+        uint32_t oldest = (tier->head + tier->slots - tier->count) % tier->slots;
+        for (uint32_t i = lower_bound(store, tier, oldest, t_start_ms); i < tier->count; i++)
+        {
+            trend_bucket_t *b = ring_slot(store, tier, (oldest + i) % tier->slots);
+            if (b->start_ms >= t_end_ms) break;
+            if (n == max_points)
+            {
+                truncated = 1;
+                break;
+            }
+            point_from_slot(store, b, channel, &out[n++]);
+        }
+        const uint64_t oldest_ms = tier->count ? ring_slot(store, tier, oldest)->start_ms : 0;
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&store->seq, memory_order_relaxed) == seq_start)
+        {
+            *n_points = n;
+            if (info)
+            {
+                info->tier_period_ms = tier->period_ms;
+                info->oldest_ms = oldest_ms;
+                info->truncated = truncated;
+            }
+            return OK;
+        }
+    }
+
+    fprintf(stderr, "TREND: query retries exhausted\n");
+    return ERROR;
+}
+
+int trend_store_latest(trend_store_t *store, uint32_t tier_idx, uint32_t channel, trend_point_t *out)
+{
+    if (!store || !out || tier_idx >= store->hdr->n_tiers || channel >= store->hdr->n_channels) return ERROR;
+
+    const trend_tier_t *tier = &store->hdr->tier[tier_idx];
+
+    for (int attempt = 0; attempt < TREND_STORE_READ_RETRIES; attempt++)
+    {
+        uint32_t seq_start = atomic_load_explicit(&store->seq, memory_order_acquire);
+        if (seq_start & 1u) continue;
+        if (tier->count == 0) return ERROR;
+
+        point_from_slot(store, ring_slot(store, tier, (tier->head + tier->slots - 1) % tier->slots), channel, out);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&store->seq, memory_order_relaxed) == seq_start) return OK;
+    }
+
+    return ERROR;
+}
+
+int trend_store_rejected(trend_store_t *store, uint64_t *rejected)
+{
+    if (!store || !rejected) return ERROR;
+
+    *rejected = store->hdr->rejected;
+
+    return OK;
+}
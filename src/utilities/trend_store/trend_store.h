@@ -0,0 +1,93 @@
+/* 
+Description : multi-resolution trend rollup store held in a memory-mapped file
+              - fixed-size circular tiers (e.g. 1 s, 1 min, 1 h, 1 day)
+              - per channel min / max / mean / RMS per bucket
+              - constant footprint, restarts reuse the mapped file as-is
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TREND_STORE_MAX_TIERS           4
+#define TREND_STORE_MAX_CHANNELS        32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint64_t period_ms;         /* bucket width, each tier a multiple of the previous one */
+    uint32_t slots;             /* ring length, retention = period_ms * slots */
+} trend_tier_cfg_t;
+
+typedef struct
+{
+    uint32_t n_channels;
+    uint32_t n_tiers;
+    trend_tier_cfg_t tier[TREND_STORE_MAX_TIERS];   /* finest first */
+} trend_store_cfg_t;
+
+typedef struct
+{
+    uint64_t start_ms;          /* bucket start, aligned to the tier period */
+    uint32_t count;             /* raw records folded into this bucket */
+    float min;
+    float max;
+    float mean;
+    float rms;
+} trend_point_t;
+
+typedef struct
+{
+    uint64_t tier_period_ms;    /* period of the tier the points come from */
+    uint64_t oldest_ms;         /* start of the oldest bucket that tier still holds */
+    int truncated;              /* 1 if buckets of the range are missing from 'out' */
+} trend_query_info_t;
+
+typedef struct trend_store trend_store_t;
+
+/* bytes of backing storage needed for 'cfg' */
+size_t trend_store_size(const trend_store_cfg_t *cfg);
+
+/* attach to caller-owned memory of trend_store_size() bytes, reusing its
+   contents if they were written with the same layout */
+trend_store_t* trend_store_attach(void *mem, size_t len, const trend_store_cfg_t *cfg);
+
+/* open or create a file-backed store at 'path' (mmap, MAP_SHARED) */
+trend_store_t* trend_store_open(const char *path, const trend_store_cfg_t *cfg);
+
+int trend_store_close(trend_store_t *store);
+
+/* writer side : fold one record of n_channels values at time 'now_ms' */
+int trend_store_add(trend_store_t *store, uint64_t now_ms, const float *values);
+
+/*
+ reader side : buckets of 'channel' with start in [t_start_ms, t_end_ms), oldest first
+ - starts at the coarsest tier whose period is <= resolution_ms (finest tier if none) and
+   falls through to coarser tiers until one still holds t_start_ms
+ - 'info' (optional) reports the tier used; 'truncated' is set when even the coarsest tier
+   has dropped the start of the range, or when the range holds more than max_points buckets
+*/
+int trend_store_query(trend_store_t *store, 
+                      uint32_t channel, 
+                      uint64_t t_start_ms, 
+                      uint64_t t_end_ms,
+                      uint64_t resolution_ms, 
+                      trend_point_t *out, 
+                      size_t max_points, 
+                      size_t *n_points,
+                      trend_query_info_t *info);
+
+/* reader side : most recently closed bucket of 'channel' in 'tier' */
+int trend_store_latest(trend_store_t *store, uint32_t tier, uint32_t channel, trend_point_t *out);
+
+/* records refused by trend_store_add() for going back in time, e.g. a wall clock step.
+   Kept in the backing file, the count survives restarts */
+int trend_store_rejected(trend_store_t *store, uint64_t *rejected);
+
+#ifdef __cplusplus
+}
+#endif
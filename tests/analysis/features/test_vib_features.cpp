@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "analysis/features/vib_features.h"
+#include "common_def.h"
+
+#include <cmath>
+
+static const float lsb_to_g = 0.061f / 1000.0f;
+
+TEST(vib_features_init, fails_on_non_power_of_two_block)
+{
+    vib_features_cfg_t cfg = {1000, lsb_to_g, 0.0f, 0.0f};
+    EXPECT_EQ(nullptr, vib_features_init(&cfg));
+}
+
+TEST(vib_features_add, sine_rms_and_band)
+{
+    const size_t n = 1024;
+    vib_features_cfg_t cfg = {n, lsb_to_g, 0.2f, 5.0f};
+    vib_features_ctx_t *ctx = vib_features_init(&cfg);
+    ASSERT_NE(nullptr, ctx);
+
+    // X : 0.5 g amplitude sine on bin 200 (band 200 * 8 / 512 = 3), Y/Z : constant offset
+    const int16_t amp = (int16_t)(0.5f / lsb_to_g);
+    vib_features_t feat = {};
+    uint8_t ready = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        vib_sensor_data_t s = {};
+        s.accel_x = (int16_t)std::lround(amp * std::sin(2.0 * M_PI * 200.0 * i / n));
+        s.accel_y = 100;
+        s.accel_z = 16393;
+        ASSERT_EQ(OK, vib_features_add(ctx, &s, 1234, &ready, &feat));
+        if (i + 1 < n) ASSERT_EQ(0, ready);
+    }
+
+    ASSERT_EQ(1, ready);
+    EXPECT_EQ(1234u, feat.timestamp_ns);
+    EXPECT_EQ(0u, feat.block_seq);
+    EXPECT_NEAR(0.5f / std::sqrt(2.0f), feat.rms[0], 1e-3f);
+    EXPECT_NEAR(0.5f, feat.peak[0], 1e-3f);
+    EXPECT_NEAR(0.0f, feat.rms[1], 1e-6f);     // DC removed
+    EXPECT_NEAR(0.125f, feat.band_energy[3], 1e-3f);
+    EXPECT_NEAR(0.0f, feat.band_energy[0], 1e-4f);
+    EXPECT_EQ((uint32_t)VIB_ALARM_WARNING, feat.alarm_state);
+
+    vib_features_free(ctx);
+}
+
+TEST(vib_features_reset, drops_partial_block)
+{
+    const size_t n = 64;
+    vib_features_cfg_t cfg = {n, lsb_to_g, 0.0f, 0.0f};
+    vib_features_ctx_t *ctx = vib_features_init(&cfg);
+    ASSERT_NE(nullptr, ctx);
+
+    vib_features_t feat = {};
+    uint8_t ready = 0;
+    vib_sensor_data_t s = {};
+    for (size_t i = 0; i < n / 2; i++) ASSERT_EQ(OK, vib_features_add(ctx, &s, 1, &ready, &feat));
+
+    ASSERT_EQ(OK, vib_features_reset(ctx));
+
+    // a full block is needed again after the reset
+    for (size_t i = 0; i < n - 1; i++)
+    {
+        ASSERT_EQ(OK, vib_features_add(ctx, &s, 2, &ready, &feat));
+        ASSERT_EQ(0, ready);
+    }
+    ASSERT_EQ(OK, vib_features_add(ctx, &s, 2, &ready, &feat));
+    EXPECT_EQ(1, ready);
+
+    EXPECT_EQ(ERROR, vib_features_reset(NULL));
+    vib_features_free(ctx);
+}
+
+TEST(vib_features_set_levels, applies_to_the_next_block)
+{
+    const size_t n = 64;
+    vib_features_cfg_t cfg = {n, lsb_to_g, 0.0f, 0.0f};
+    vib_features_ctx_t *ctx = vib_features_init(&cfg);
+    ASSERT_NE(nullptr, ctx);
+
+    // square wave of +-0.3 g : RMS 0.3 g
+    const int16_t amp = (int16_t)(0.3f / lsb_to_g);
+    vib_features_t feat = {};
+    uint8_t ready = 0;
+    auto run_block = [&]() {
+        for (size_t i = 0; i < n; i++)
+        {
+            vib_sensor_data_t s = {};
+            s.accel_x = (i & 1) ? amp : (int16_t)-amp;
+            ASSERT_EQ(OK, vib_features_add(ctx, &s, 1, &ready, &feat));
+        }
+        ASSERT_EQ(1, ready);
+    };
+
+    run_block();
+    EXPECT_EQ(0u, feat.alarm_state);
+
+    ASSERT_EQ(OK, vib_features_set_levels(ctx, 0.2f, 0.25f));
+    run_block();
+    EXPECT_EQ((uint32_t)(VIB_ALARM_WARNING | VIB_ALARM_DANGER), feat.alarm_state);
+
+    ASSERT_EQ(OK, vib_features_set_levels(ctx, 0.2f, 0.0f));
+    run_block();
+    EXPECT_EQ((uint32_t)VIB_ALARM_WARNING, feat.alarm_state);
+
+    EXPECT_EQ(ERROR, vib_features_set_levels(ctx, -1.0f, 0.0f));
+    EXPECT_EQ(ERROR, vib_features_set_levels(NULL, 0.0f, 0.0f));
+    vib_features_free(ctx);
+}
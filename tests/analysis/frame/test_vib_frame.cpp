@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "analysis/frame/vib_frame.h"
+#include "analysis/features/vib_features.h"
+#include "common_def.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+static std::vector<vib_sensor_data_t> ramp(size_t n)
+{
+    std::vector<vib_sensor_data_t> raw(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        raw[i].accel_x = (int16_t)(i * 7 - 300);
+        raw[i].accel_y = (int16_t)(-(int)i * 13);
+        raw[i].accel_z = (int16_t)((i & 1) ? INT16_MAX : INT16_MIN);
+    }
+    return raw;
+}
+
+TEST(vib_frame_init, axes_are_cache_aligned_and_disjoint)
+{
+    vib_frame_t frame;
+    ASSERT_EQ(OK, vib_frame_init(&frame, 100));
+    EXPECT_EQ(100u, frame.capacity);
+    for (int a = 0; a < VIB_FRAME_AXES; a++) EXPECT_EQ(0u, (uintptr_t)frame.axis[a] % VIB_FRAME_ALIGN);
+    EXPECT_GE((uintptr_t)frame.axis[1], (uintptr_t)(frame.axis[0] + 100));
+    EXPECT_GE((uintptr_t)frame.axis[2], (uintptr_t)(frame.axis[1] + 100));
+    EXPECT_EQ(OK, vib_frame_free(&frame));
+
+    EXPECT_EQ(ERROR, vib_frame_init(&frame, 0));
+}
+
+TEST(vib_frame_scale, lsb_to_g_is_a_constant_expression)
+{
+    static_assert(IIS3DWB_LSB_TO_G(IIS3DWB_FS_2G) == 0.061f / 1000.0f, "2 g sensitivity");
+    static_assert(IIS3DWB_LSB_TO_G(IIS3DWB_FS_16G) == 0.488f / 1000.0f, "16 g sensitivity");
+    EXPECT_EQ(IIS3DWB_LSB_TO_G(IIS3DWB_FS_4G), vib_sensor_lsb_to_g(IIS3DWB_FS_4G));
+    EXPECT_EQ(IIS3DWB_LSB_TO_G(IIS3DWB_FS_8G), vib_sensor_lsb_to_g(IIS3DWB_FS_8G));
+}
+
+TEST(vib_frame_load, matches_scalar_reference_for_every_full_scale)
+{
+    // 8-sample vector body plus a 5 sample tail
+    const size_t n = 8 * 12 + 5;
+    const auto raw = ramp(n);
+    const iis3dwb_fs_t scales[] = {IIS3DWB_FS_2G, IIS3DWB_FS_4G, IIS3DWB_FS_8G, IIS3DWB_FS_16G};
+
+    vib_frame_t frame;
+    ASSERT_EQ(OK, vib_frame_init(&frame, n));
+    std::vector<float> x(n), y(n), z(n);
+
+    for (iis3dwb_fs_t fs : scales)
+    {
+        ASSERT_EQ(OK, vib_frame_load(&frame, raw.data(), n, fs));
+        EXPECT_EQ(n, frame.n_samples);
+
+        vib_frame_deinterleave_scalar(raw.data(), n, vib_sensor_lsb_to_g(fs), x.data(), y.data(), z.data());
+        for (size_t i = 0; i < n; i++)
+        {
+            ASSERT_EQ(x[i], frame.axis[0][i]);
+            ASSERT_EQ(y[i], frame.axis[1][i]);
+            ASSERT_EQ(z[i], frame.axis[2][i]);
+        }
+    }
+
+    ASSERT_EQ(OK, vib_frame_load(&frame, raw.data(), n, IIS3DWB_FS_2G));
+    EXPECT_FLOAT_EQ(-300 * 0.061f / 1000.0f, frame.axis[0][0]);
+    EXPECT_EQ(ERROR, vib_frame_load(&frame, raw.data(), n + 1, IIS3DWB_FS_2G));
+    vib_frame_free(&frame);
+}
+
+TEST(vib_features_add_frame, same_features_as_per_sample_path)
+{
+    const size_t block = 256;
+    const float lsb_to_g = IIS3DWB_LSB_TO_G(IIS3DWB_FS_2G);
+    vib_features_cfg_t cfg = {block, lsb_to_g, 0.2f, 5.0f};
+    vib_features_ctx_t *ref = vib_features_init(&cfg);
+    vib_features_ctx_t *soa = vib_features_init(&cfg);
+    ASSERT_NE(nullptr, ref);
+    ASSERT_NE(nullptr, soa);
+
+    // frames of 100 samples do not line up with the 256 sample feature blocks
+    const size_t total = 3 * block + 40;
+    std::vector<vib_sensor_data_t> raw(total);
+    for (size_t i = 0; i < total; i++)
+    {
+        raw[i].accel_x = (int16_t)std::lround(4000.0 * std::sin(2.0 * M_PI * 17.0 * i / block));
+        raw[i].accel_y = (int16_t)(i % 50);
+        raw[i].accel_z = 16393;
+    }
+
+    std::vector<vib_features_t> expected;
+    for (size_t i = 0; i < total; i++)
+    {
+        vib_features_t f = {};
+        uint8_t ready = 0;
+        ASSERT_EQ(OK, vib_features_add(ref, &raw[i], 1000 + i * 10, &ready, &f));
+        if (ready) expected.push_back(f);
+    }
+    ASSERT_EQ(3u, expected.size());
+
+    vib_frame_t frame;
+    ASSERT_EQ(OK, vib_frame_init(&frame, 100));
+    std::vector<vib_features_t> got;
+    for (size_t start = 0; start < total; start += 100)
+    {
+        const size_t n = std::min<size_t>(100, total - start);
+        ASSERT_EQ(OK, vib_frame_load(&frame, &raw[start], n, IIS3DWB_FS_2G));
+        frame.t_first_ns = 1000 + start * 10;
+        frame.dt_ns = 10;
+
+        size_t pos = 0;
+        while (pos < frame.n_samples)
+        {
+            vib_features_t f = {};
+            uint8_t ready = 0;
+            ASSERT_EQ(OK, vib_features_add_frame(soa, &frame, &pos, &ready, &f));
+            if (ready) got.push_back(f);
+        }
+    }
+
+    ASSERT_EQ(expected.size(), got.size());
+    for (size_t k = 0; k < got.size(); k++)
+    {
+        EXPECT_EQ(expected[k].timestamp_ns, got[k].timestamp_ns);
+        EXPECT_EQ(expected[k].block_seq, got[k].block_seq);
+        EXPECT_EQ(expected[k].alarm_state, got[k].alarm_state);
+        for (int a = 0; a < VIB_FEATURES_AXES; a++)
+        {
+            EXPECT_FLOAT_EQ(expected[k].rms[a], got[k].rms[a]);
+            EXPECT_FLOAT_EQ(expected[k].peak[a], got[k].peak[a]);
+        }
+        for (int b = 0; b < VIB_FEATURES_BANDS; b++) EXPECT_FLOAT_EQ(expected[k].band_energy[b], got[k].band_energy[b]);
+    }
+
+    vib_frame_free(&frame);
+    vib_features_free(ref);
+    vib_features_free(soa);
+}
@@ -0,0 +1,320 @@
+#include <gtest/gtest.h>
+#include "analysis/inference/nn_model.h"
+#include "analysis/inference/nn_kernels.h"
+#include "common_def.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/* ---- reference implementation : direct loops, zero points applied per element ---- */
+
+static int32_t ref_rounding_doubling_high_mul(int32_t a, int32_t b)
+{
+    if (a == INT32_MIN && b == INT32_MIN) return INT32_MAX;
+    const int64_t ab = (int64_t)a * (int64_t)b;
+    return (int32_t)((ab + (1ll << 30)) >> 31);                 // round half up
+}
+
+static int32_t ref_rounding_shift(int32_t x, int shift)
+{
+    if (shift == 0) return x;
+    const int64_t half = 1ll << (shift - 1);
+    return (int32_t)(((int64_t)x + half) >> shift);
+}
+
+static std::vector<int8_t> ref_forward(const nn_model_spec_t &spec, const std::vector<int8_t> &input)
+{
+    std::vector<int8_t> x = input;
+    for (uint32_t li = 0; li < spec.n_layers; li++)
+    {
+        const nn_layer_desc_t &l = spec.layers[li].desc;
+        const int8_t *w = spec.layers[li].weights;
+        const int32_t *b = spec.layers[li].bias;
+        std::vector<int8_t> y((size_t)l.out_len * l.out_ch);
+
+        for (uint32_t o = 0; o < l.out_len; o++)
+        {
+            for (uint32_t c = 0; c < l.out_ch; c++)
+            {
+                int32_t acc = b[c];
+                for (uint32_t k = 0; k < l.kernel; k++)
+                {
+                    for (uint32_t ic = 0; ic < l.in_ch; ic++)
+                    {
+                        const int32_t xv = x[((size_t)o * l.stride + k) * l.in_ch + ic] - l.in_zp;
+                        acc += xv * w[((size_t)c * l.kernel + k) * l.in_ch + ic];
+                    }
+                }
+                int32_t v = ref_rounding_shift(ref_rounding_doubling_high_mul(acc, l.out_mult), l.out_shift) + l.out_zp;
+                const int32_t lo = (l.activation == NN_ACT_RELU) ? l.out_zp : -128;
+                v = std::min(127, std::max(lo, v));
+                y[(size_t)o * l.out_ch + c] = (int8_t)v;
+            }
+        }
+        x.swap(y);
+    }
+    return x;
+}
+
+/* ---- model construction helpers ---- */
+
+struct test_model
+{
+    nn_model_spec_t spec = {};
+    std::vector<std::vector<int8_t>> weights;
+    std::vector<std::vector<int32_t>> biases;
+    std::vector<uint8_t> image;
+
+    nn_layer_desc_t &add(uint32_t type, uint32_t in_len, uint32_t in_ch, uint32_t out_ch, uint32_t kernel, uint32_t stride)
+    {
+        nn_layer_desc_t &l = spec.layers[spec.n_layers++].desc;
+        l = {};
+        l.type = type;
+        l.in_len = in_len;
+        l.in_ch = in_ch;
+        l.out_ch = out_ch;
+        l.kernel = kernel;
+        l.stride = stride;
+        l.out_len = (type == NN_LAYER_DENSE) ? 1 : (in_len - kernel) / stride + 1;
+        l.out_mult = 1 << 30;
+        return l;
+    }
+
+    // weights / bias storage must be in place before pack()
+    void fill(std::mt19937 &rng)
+    {
+        std::uniform_int_distribution<int> w8(-128, 127);
+        std::uniform_int_distribution<int> b32(-4000, 4000);
+        std::uniform_int_distribution<int32_t> mult(1 << 30, INT32_MAX);
+        std::uniform_int_distribution<int> sh(5, 10);
+
+        weights.resize(spec.n_layers);
+        biases.resize(spec.n_layers);
+        for (uint32_t i = 0; i < spec.n_layers; i++)
+        {
+            nn_layer_desc_t &l = spec.layers[i].desc;
+            weights[i].resize((size_t)l.out_ch * l.kernel * l.in_ch);
+            biases[i].resize(l.out_ch);
+            for (auto &v : weights[i]) v = (int8_t)w8(rng);
+            for (auto &v : biases[i]) v = b32(rng);
+            l.out_mult = mult(rng);
+            l.out_shift = sh(rng);
+        }
+        link();
+    }
+
+    void link()
+    {
+        for (uint32_t i = 0; i < spec.n_layers; i++)
+        {
+            spec.layers[i].weights = weights[i].data();
+            spec.layers[i].bias = biases[i].data();
+        }
+    }
+
+    bool pack()
+    {
+        const size_t n = nn_model_pack(&spec, nullptr, 0);
+        if (n == 0) return false;
+        image.assign(n, 0);
+        return nn_model_pack(&spec, image.data(), image.size()) == n;
+    }
+};
+
+/* conv1d(32x2 -> 8ch, k5 s2, relu) -> dense(112 -> 16, relu) -> dense(16 -> 4) */
+static void build_conv_classifier(test_model &m, std::mt19937 &rng)
+{
+    m.spec.kind = NN_KIND_CLASSIFIER;
+    m.spec.input_len = 64;
+    m.spec.input_scale = 0.05f;
+    m.spec.input_zp = -3;
+    m.spec.output_scale = 0.1f;
+    m.spec.output_zp = 5;
+
+    nn_layer_desc_t &c1 = m.add(NN_LAYER_CONV1D, 32, 2, 8, 5, 2);
+    c1.activation = NN_ACT_RELU;
+    c1.in_zp = -3;
+    c1.out_zp = -128;
+
+    nn_layer_desc_t &d1 = m.add(NN_LAYER_DENSE, 14 * 8, 1, 16, 14 * 8, 14 * 8);
+    d1.activation = NN_ACT_RELU;
+    d1.in_zp = -128;
+    d1.out_zp = -100;
+
+    nn_layer_desc_t &d2 = m.add(NN_LAYER_DENSE, 16, 1, 4, 16, 16);
+    d2.in_zp = -100;
+    d2.out_zp = 5;
+
+    m.fill(rng);
+}
+
+TEST(nn_kernels, neon_and_scalar_dot_agree)
+{
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> w8(-128, 127);
+    for (size_t n : {1u, 7u, 8u, 15u, 16u, 17u, 31u, 64u, 100u, 1000u})
+    {
+        std::vector<int8_t> x(n), w(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] = (int8_t)w8(rng);
+            w[i] = (int8_t)w8(rng);
+        }
+        EXPECT_EQ(nn_dot_s8_scalar(x.data(), w.data(), n), nn_dot_s8(x.data(), w.data(), n)) << n;
+    }
+
+    // extreme values stay exact
+    std::vector<int8_t> lo(4096, -128);
+    EXPECT_EQ(4096 * 16384, nn_dot_s8(lo.data(), lo.data(), lo.size()));
+}
+
+TEST(nn_quant_multiplier, represents_scale)
+{
+    int32_t mult = 0, shift = 0;
+    ASSERT_EQ(OK, nn_quant_multiplier(0.5, &mult, &shift));
+    EXPECT_EQ(1 << 30, mult);
+    EXPECT_EQ(0, shift);
+
+    ASSERT_EQ(OK, nn_quant_multiplier(0.0123, &mult, &shift));
+    EXPECT_NEAR(0.0123, (double)mult / 2147483648.0 / (double)(1 << shift), 1e-9);
+
+    EXPECT_EQ(ERROR, nn_quant_multiplier(1.0, &mult, &shift));
+    EXPECT_EQ(ERROR, nn_quant_multiplier(0.0, &mult, &shift));
+    EXPECT_EQ(ERROR, nn_quant_multiplier(1e-12, &mult, &shift));
+}
+
+TEST(nn_model, bit_exact_against_reference)
+{
+    std::mt19937 rng(1234);
+    test_model m;
+    build_conv_classifier(m, rng);
+    ASSERT_TRUE(m.pack());
+
+    nn_model_t *model = nn_model_load(m.image.data(), m.image.size());
+    ASSERT_NE(nullptr, model);
+    ASSERT_EQ(64u, nn_model_input_len(model));
+    ASSERT_EQ(4u, nn_model_output_len(model));
+    EXPECT_GT(nn_model_arena_bytes(model), 0u);
+
+    std::uniform_int_distribution<int> x8(-128, 127);
+    std::vector<int8_t> in(64), out(4);
+    size_t distinct_outputs = 0;
+    for (int trial = 0; trial < 500; trial++)
+    {
+        for (auto &v : in) v = (int8_t)x8(rng);
+        ASSERT_EQ(OK, nn_model_run_q(model, in.data(), out.data()));
+        const std::vector<int8_t> ref = ref_forward(m.spec, in);
+        ASSERT_EQ(ref, out) << "trial " << trial;
+        if (out[0] != -128 && out[0] != 127) distinct_outputs++;
+    }
+    EXPECT_GT(distinct_outputs, 0u);        // not saturated everywhere
+
+    nn_model_close(model);
+}
+
+TEST(nn_model, load_rejects_corrupt_images)
+{
+    std::mt19937 rng(1);
+    test_model m;
+    build_conv_classifier(m, rng);
+    ASSERT_TRUE(m.pack());
+
+    EXPECT_EQ(nullptr, nn_model_load(nullptr, m.image.size()));
+    EXPECT_EQ(nullptr, nn_model_load(m.image.data(), 16));
+    EXPECT_EQ(nullptr, nn_model_load(m.image.data(), m.image.size() - 1));     // last bias cut off
+
+    std::vector<uint8_t> bad = m.image;
+    bad[0] ^= 0xFF;
+    EXPECT_EQ(nullptr, nn_model_load(bad.data(), bad.size()));
+
+    // broken zero point chain between layers
+    bad = m.image;
+    nn_layer_desc_t l;
+    const size_t off = sizeof(nn_file_header_t) + sizeof(nn_layer_desc_t);
+    memcpy(&l, &bad[off], sizeof(l));
+    l.in_zp += 1;
+    memcpy(&bad[off], &l, sizeof(l));
+    EXPECT_EQ(nullptr, nn_model_load(bad.data(), bad.size()));
+}
+
+TEST(nn_model, pack_rejects_inconsistent_shapes)
+{
+    std::mt19937 rng(2);
+    test_model m;
+    build_conv_classifier(m, rng);
+
+    m.spec.layers[1].desc.in_len = 100;                 // conv produces 112
+    EXPECT_EQ(0u, nn_model_pack(&m.spec, nullptr, 0));
+}
+
+TEST(nn_model, classifier_scores_and_argmax)
+{
+    // dense 4 -> 4, w = 64 * I, real scale 1/64 : output equals input
+    test_model m;
+    m.spec.kind = NN_KIND_CLASSIFIER;
+    m.spec.input_len = 4;
+    m.spec.input_scale = 0.1f;
+    m.spec.output_scale = 0.1f;
+
+    nn_layer_desc_t &d = m.add(NN_LAYER_DENSE, 4, 1, 4, 4, 4);
+    ASSERT_EQ(OK, nn_quant_multiplier(1.0 / 64.0, &d.out_mult, &d.out_shift));
+    m.weights.assign(1, std::vector<int8_t>(16, 0));
+    m.biases.assign(1, std::vector<int32_t>(4, 0));
+    for (int i = 0; i < 4; i++) m.weights[0][i * 4 + i] = 64;
+    m.link();
+    ASSERT_TRUE(m.pack());
+
+    nn_model_t *model = nn_model_load(m.image.data(), m.image.size());
+    ASSERT_NE(nullptr, model);
+
+    const float in[4] = {0.3f, -1.0f, 2.5f, 1.2f};
+    nn_result_t res;
+    ASSERT_EQ(OK, nn_model_run(model, in, &res));
+    EXPECT_EQ((uint32_t)NN_KIND_CLASSIFIER, res.kind);
+    EXPECT_EQ(4u, res.n_scores);
+    EXPECT_EQ(2u, res.class_id);
+    for (int i = 0; i < 4; i++) EXPECT_NEAR(in[i], res.scores[i], 0.05f);
+
+    nn_model_close(model);
+}
+
+TEST(nn_model, autoencoder_reconstruction_error)
+{
+    // conv1d 1x1 identity over 8 positions, quantization error only
+    test_model m;
+    m.spec.kind = NN_KIND_AUTOENCODER;
+    m.spec.input_len = 8;
+    m.spec.input_scale = 0.02f;
+    m.spec.input_zp = 10;
+    m.spec.output_scale = 0.02f;
+    m.spec.output_zp = 10;
+
+    nn_layer_desc_t &c = m.add(NN_LAYER_CONV1D, 8, 1, 1, 1, 1);
+    c.in_zp = 10;
+    c.out_zp = 10;
+    ASSERT_EQ(OK, nn_quant_multiplier(1.0 / 64.0, &c.out_mult, &c.out_shift));
+    m.weights.assign(1, std::vector<int8_t>(1, 64));
+    m.biases.assign(1, std::vector<int32_t>(1, 0));
+    m.link();
+    ASSERT_TRUE(m.pack());
+
+    nn_model_t *model = nn_model_load(m.image.data(), m.image.size());
+    ASSERT_NE(nullptr, model);
+
+    float in[8];
+    for (int i = 0; i < 8; i++) in[i] = 0.37f * (float)(i - 4);
+
+    nn_result_t res;
+    ASSERT_EQ(OK, nn_model_run(model, in, &res));
+    EXPECT_EQ((uint32_t)NN_KIND_AUTOENCODER, res.kind);
+    EXPECT_LE(res.recon_error, 0.01f * 0.01f);              // within half a step per element
+
+    // an input outside the representable range reconstructs badly
+    in[0] = 50.0f;
+    ASSERT_EQ(OK, nn_model_run(model, in, &res));
+    EXPECT_GT(res.recon_error, 1.0f);
+
+    nn_model_close(model);
+}
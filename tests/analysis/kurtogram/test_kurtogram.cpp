@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "analysis/kurtogram/kurtogram.h"
+#include "common_def.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+static const float fs_hz = 26667.0f;
+
+static const kurtogram_cfg_t cfg = {
+    .levels = 6,
+    .sample_rate_hz = fs_hz,
+};
+
+/*
+ bearing-like signal : unit Gaussian noise, a 1 g offset (gravity), a strong 60 Hz tone and
+ resonance bursts at 'carrier_hz' excited every 'period_s', decaying with a 0.4 ms time constant
+*/
+static std::vector<float> bearing_signal(double duration_s, double carrier_hz, double period_s, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    const size_t n = (size_t)(duration_s * fs_hz);
+    std::vector<float> x(n);
+
+    const size_t burst_every = (size_t)(period_s * fs_hz);
+    for (size_t i = 0; i < n; i++)
+    {
+        const double t = (double)i / fs_hz;
+        const double tb = (double)(i % burst_every) / fs_hz;
+        x[i] = 1.0f + noise(rng) + 5.0f * (float)std::sin(2.0 * M_PI * 60.0 * t) +
+               8.0f * (float)(std::exp(-tb / 0.0004) * std::sin(2.0 * M_PI * carrier_hz * tb));
+    }
+
+    return x;
+}
+
+TEST(kurtogram_init, rejects_bad_config)
+{
+    kurtogram_cfg_t bad = cfg;
+    bad.levels = 0;
+    EXPECT_EQ(nullptr, kurtogram_init(&bad));
+    bad.levels = KURTOGRAM_MAX_LEVELS + 1;
+    EXPECT_EQ(nullptr, kurtogram_init(&bad));
+    bad = cfg;
+    bad.sample_rate_hz = 0.0f;
+    EXPECT_EQ(nullptr, kurtogram_init(&bad));
+    EXPECT_EQ(nullptr, kurtogram_init(nullptr));
+}
+
+TEST(kurtogram_best, needs_one_full_chunk)
+{
+    kurtogram_t *kg = kurtogram_init(&cfg);
+    ASSERT_NE(nullptr, kg);
+
+    std::vector<float> x(KURTOGRAM_CHUNK, 1.0f);
+    kurtogram_band_t best;
+    ASSERT_EQ(OK, kurtogram_add(kg, x.data(), KURTOGRAM_CHUNK - 1));
+    EXPECT_EQ(ERROR, kurtogram_best(kg, &best));
+    ASSERT_EQ(OK, kurtogram_add(kg, x.data(), 1));
+    EXPECT_EQ(OK, kurtogram_best(kg, &best));
+    EXPECT_EQ((uint64_t)KURTOGRAM_CHUNK, best.samples);
+
+    ASSERT_EQ(OK, kurtogram_reset(kg));
+    EXPECT_EQ(ERROR, kurtogram_best(kg, &best));
+    EXPECT_EQ(OK, kurtogram_free(kg));
+}
+
+TEST(kurtogram_level, gaussian_noise_is_not_impulsive)
+{
+    kurtogram_t *kg = kurtogram_init(&cfg);
+    ASSERT_NE(nullptr, kg);
+
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<float> x(1 << 19);
+    for (auto &v : x) v = 3.0f + noise(rng);
+    ASSERT_EQ(OK, kurtogram_add(kg, x.data(), x.size()));
+
+    // each level-k band averages 2^19 / 2^k samples
+    for (uint32_t k = 0; k <= cfg.levels; k++)
+    {
+        std::vector<float> sk(1u << k);
+        ASSERT_EQ(OK, kurtogram_level(kg, k, sk.data(), sk.size()));
+        for (size_t j = 0; j < sk.size(); j++) EXPECT_NEAR(0.0f, sk[j], 0.2f) << "level " << k << " band " << j;
+    }
+
+    float row[4];
+    EXPECT_EQ(ERROR, kurtogram_level(kg, 2, row, 3));
+    EXPECT_EQ(ERROR, kurtogram_level(kg, cfg.levels + 1, row, 4));
+    EXPECT_EQ(OK, kurtogram_free(kg));
+}
+
+// one carrier below fs / 4, one above : bands keep their order through the tree
+class kurtogram_resonance : public ::testing::TestWithParam<double> {};
+
+TEST_P(kurtogram_resonance, finds_the_band_around_the_resonance)
+{
+    const double carrier_hz = GetParam();
+    kurtogram_t *kg = kurtogram_init(&cfg);
+    ASSERT_NE(nullptr, kg);
+
+    const std::vector<float> x = bearing_signal(4.0, carrier_hz, 0.01, 3);
+    ASSERT_EQ(OK, kurtogram_add(kg, x.data(), x.size()));
+
+    kurtogram_band_t best;
+    ASSERT_EQ(OK, kurtogram_best(kg, &best));
+    EXPECT_GE(best.level, 1u);
+    EXPECT_LE(best.f_lo_hz, carrier_hz);
+    EXPECT_GE(best.f_hi_hz, carrier_hz);
+    EXPECT_GT(best.sk, 2.0f);
+    EXPECT_FLOAT_EQ(fs_hz / (float)(2u << best.level), best.f_hi_hz - best.f_lo_hz);
+
+    // the raw signal, dominated by the tone, hides the impulses
+    float full;
+    ASSERT_EQ(OK, kurtogram_level(kg, 0, &full, 1));
+    EXPECT_LT(full, 0.5f);
+
+    EXPECT_EQ(OK, kurtogram_free(kg));
+}
+
+INSTANTIATE_TEST_SUITE_P(carriers, kurtogram_resonance, ::testing::Values(3100.0, 9200.0));
+
+TEST(kurtogram_add, result_does_not_depend_on_how_the_stream_is_cut)
+{
+    const std::vector<float> x = bearing_signal(1.0, 5200.0, 0.013, 11);
+    kurtogram_t *whole = kurtogram_init(&cfg);
+    kurtogram_t *pieces = kurtogram_init(&cfg);
+    ASSERT_NE(nullptr, whole);
+    ASSERT_NE(nullptr, pieces);
+
+    ASSERT_EQ(OK, kurtogram_add(whole, x.data(), x.size()));
+
+    // FIFO bursts of uneven length
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<size_t> len(1, 700);
+    for (size_t pos = 0; pos < x.size(); )
+    {
+        const size_t n = std::min(len(rng), x.size() - pos);
+        ASSERT_EQ(OK, kurtogram_add(pieces, x.data() + pos, n));
+        pos += n;
+    }
+
+    for (uint32_t k = 0; k <= cfg.levels; k++)
+    {
+        std::vector<float> a(1u << k), b(1u << k);
+        ASSERT_EQ(OK, kurtogram_level(whole, k, a.data(), a.size()));
+        ASSERT_EQ(OK, kurtogram_level(pieces, k, b.data(), b.size()));
+        EXPECT_EQ(a, b) << "level " << k;
+    }
+
+    EXPECT_EQ(OK, kurtogram_free(whole));
+    EXPECT_EQ(OK, kurtogram_free(pieces));
+}
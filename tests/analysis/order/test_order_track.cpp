@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+#include "analysis/order/order_track.h"
+#include "utilities/block_pool/block_pool.h"
+#include "common_def.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+static const double fs_hz = 26667.0;
+static const uint32_t dt_ns = 37500;
+static const uint64_t t_base_ns = 5000000000ull;
+
+static const order_track_cfg_t cfg = {
+    .samples_per_rev = 64,
+    .revs_per_spectrum = 8,
+    .pulses_per_rev = 1,
+    .sample_rate_hz = (float)fs_hz,
+    .min_rpm = 300.0f,
+};
+
+/*
+ synthetic run-up : shaft speed ramps linearly from f0 to f1 rev/s over 'duration_s'
+ - x carries order 2 at 1 g, y order 3 at 0.5 g, z a fixed 400 Hz tone (not shaft synchronous)
+ - tach pulses every 1 / pulses_per_rev revolution, delivered ahead of the vibration like the kernel does
+*/
+struct run_up
+{
+    double f0, alpha;
+    double theta(double t) const { return f0 * t + 0.5 * alpha * t * t; }
+    double pulse_t(double th) const { return (-f0 + std::sqrt(f0 * f0 + 2.0 * alpha * th)) / alpha; }
+};
+
+struct feed_opts
+{
+    double duration_s = 4.0;
+    size_t frame_len = 256;
+    uint32_t jitter_ns = 0;             // block timestamp jitter, the sample clock itself is exact
+    double gap_at_s = -1.0;             // drop 50 ms of samples here and flag the next frame
+    uint32_t pulses_per_rev = 1;
+};
+
+static std::vector<order_features_t> feed(order_track_t *ot, const run_up &ru, const feed_opts &o)
+{
+    std::vector<order_features_t> out;
+    vib_frame_t frame;
+    EXPECT_EQ(OK, vib_frame_init(&frame, o.frame_len));
+
+    const size_t total = (size_t)(o.duration_s * fs_hz);
+    const size_t gap_at = (o.gap_at_s < 0.0) ? SIZE_MAX : (size_t)(o.gap_at_s * fs_hz);
+    const size_t gap_len = (size_t)(0.05 * fs_hz);
+    int next_pulse = 1;
+    uint32_t jitter_state = 1;
+    bool gap_pending = false;
+
+    for (size_t s = 0; s + o.frame_len <= total; s += o.frame_len)
+    {
+        if (s >= gap_at && s < gap_at + gap_len)
+        {
+            gap_pending = true;
+            continue;
+        }
+
+        for (size_t i = 0; i < o.frame_len; i++)
+        {
+            const double t = (double)(s + i) / fs_hz;
+            const double th = ru.theta(t);
+            frame.axis[0][i] = (float)std::sin(2.0 * M_PI * 2.0 * th);
+            frame.axis[1][i] = (float)(0.5 * std::sin(2.0 * M_PI * 3.0 * th));
+            frame.axis[2][i] = (float)(0.3 * std::sin(2.0 * M_PI * 400.0 * t));
+        }
+        jitter_state = jitter_state * 1103515245u + 12345u;
+        const int64_t jitter = o.jitter_ns ? (int64_t)(jitter_state >> 8) % (2 * o.jitter_ns + 1) - o.jitter_ns : 0;
+        frame.t_first_ns = t_base_ns + (uint64_t)s * dt_ns + jitter;
+        frame.dt_ns = dt_ns;
+        frame.n_samples = (uint32_t)o.frame_len;
+        frame.flags = gap_pending ? BLOCK_FLAG_GAP : 0;
+        gap_pending = false;
+
+        // the tach runs ~20 ms ahead of the FIFO path
+        const double lead_s = (double)(s + o.frame_len) / fs_hz + 0.02;
+        while (ru.pulse_t((double)next_pulse / o.pulses_per_rev) < lead_s)
+        {
+            const double tp = ru.pulse_t((double)next_pulse / o.pulses_per_rev);
+            EXPECT_EQ(OK, order_track_add_edge(ot, t_base_ns + (uint64_t)(tp * 1e9)));
+            next_pulse++;
+        }
+
+        EXPECT_EQ(OK, order_track_add_frame(ot, &frame));
+        uint8_t ready = 0;
+        order_features_t f;
+        while (order_track_process(ot, &ready, &f) == OK && ready) out.push_back(f);
+    }
+
+    vib_frame_free(&frame);
+    return out;
+}
+
+TEST(order_track_init, rejects_bad_config)
+{
+    order_track_cfg_t bad = cfg;
+    bad.samples_per_rev = 48;
+    EXPECT_EQ(nullptr, order_track_init(&bad));
+    bad = cfg;
+    bad.revs_per_spectrum = 3;
+    EXPECT_EQ(nullptr, order_track_init(&bad));
+    bad = cfg;
+    bad.pulses_per_rev = 3;                 // does not divide samples_per_rev
+    EXPECT_EQ(nullptr, order_track_init(&bad));
+    bad = cfg;
+    bad.min_rpm = 0.0f;
+    EXPECT_EQ(nullptr, order_track_init(&bad));
+    EXPECT_EQ(nullptr, order_track_init(nullptr));
+}
+
+TEST(order_track_process, run_up_keeps_orders_in_their_bins)
+{
+    order_track_t *ot = order_track_init(&cfg);
+    ASSERT_NE(nullptr, ot);
+
+    const run_up ru = { 10.0, 10.0 };       // 600 -> 3000 rpm over 4 s, 120 revolutions
+    const std::vector<order_features_t> out = feed(ot, ru, feed_opts{});
+
+    ASSERT_GE(out.size(), 13u);
+    for (size_t i = 0; i < out.size(); i++)
+    {
+        const order_features_t &f = out[i];
+        EXPECT_EQ((uint32_t)i, f.spectrum_seq);
+        EXPECT_NEAR(1.0f, f.order_amp[0][1], 0.03f) << "spectrum " << i;
+        EXPECT_LT(f.order_amp[0][0], 0.02f);
+        EXPECT_LT(f.order_amp[0][2], 0.02f);
+        EXPECT_NEAR(0.5f, f.order_amp[1][2], 0.02f);
+        EXPECT_NEAR(std::sqrt(0.5f), f.rms[0], 0.03f);
+
+        // the non-synchronous tone smears across the order axis instead of building a peak
+        for (int h = 0; h < ORDER_TRACK_HARMONICS; h++) EXPECT_LT(f.order_amp[2][h], 0.05f);
+
+        // speed over the spectrum matches the ramp between its first and last point (mean of
+        // per-pulse speeds, so slightly above the midpoint while accelerating)
+        const double ta = (double)(f.t_start_ns - t_base_ns) * 1e-9;
+        const double tb = (double)(f.t_end_ns - t_base_ns) * 1e-9;
+        EXPECT_NEAR(60.0 * (ru.f0 + ru.alpha * 0.5 * (ta + tb)), f.rpm_mean, 0.02 * f.rpm_mean);
+        EXPECT_LT(f.rpm_min, f.rpm_max);
+        if (i > 0) EXPECT_GE(f.t_start_ns, out[i - 1].t_end_ns);
+    }
+
+    size_t n_bins = 0;
+    const float *spec = order_track_spectrum(ot, 0, &n_bins);
+    ASSERT_NE(nullptr, spec);
+    EXPECT_EQ(cfg.samples_per_rev * cfg.revs_per_spectrum / 2 + 1, n_bins);
+    size_t peak = 0;
+    for (size_t k = 1; k < n_bins; k++) if (spec[k] > spec[peak]) peak = k;
+    EXPECT_EQ(2u * cfg.revs_per_spectrum, peak);
+
+    float rpm = 0.0f;
+    EXPECT_EQ(OK, order_track_speed(ot, &rpm));
+    EXPECT_NEAR(2900.0f, rpm, 100.0f);
+
+    order_track_free(ot);
+}
+
+TEST(order_track_process, several_pulses_per_rev_leave_no_pulse_rate_artifact)
+{
+    // 8 angle points per pulse : the first point of each interval averages back past its pulse
+    order_track_cfg_t c = cfg;
+    c.pulses_per_rev = 8;
+    order_track_t *ot = order_track_init(&c);
+    ASSERT_NE(nullptr, ot);
+
+    feed_opts o;
+    o.pulses_per_rev = c.pulses_per_rev;
+    const std::vector<order_features_t> out = feed(ot, run_up{ 10.0, 10.0 }, o);
+
+    ASSERT_GE(out.size(), 13u);
+    for (size_t i = 0; i < out.size(); i++)
+    {
+        EXPECT_NEAR(1.0f, out[i].order_amp[0][1], 0.03f) << "spectrum " << i;
+        EXPECT_NEAR(0.5f, out[i].order_amp[1][2], 0.02f) << "spectrum " << i;
+    }
+
+    // a one-sided first point per interval modulates order 2 at the pulse rate : sidebands at 8 +- 2
+    size_t n_bins = 0;
+    const float *spec = order_track_spectrum(ot, 0, &n_bins);
+    ASSERT_NE(nullptr, spec);
+    EXPECT_LT(spec[6 * cfg.revs_per_spectrum], 0.001f);
+    EXPECT_LT(spec[10 * cfg.revs_per_spectrum], 0.001f);
+
+    order_track_free(ot);
+}
+
+TEST(order_track_process, tolerates_block_timestamp_jitter)
+{
+    order_track_t *ot = order_track_init(&cfg);
+    ASSERT_NE(nullptr, ot);
+
+    feed_opts o;
+    o.jitter_ns = 30000;
+    const std::vector<order_features_t> out = feed(ot, run_up{ 10.0, 10.0 }, o);
+
+    ASSERT_GE(out.size(), 13u);
+    for (const order_features_t &f : out) EXPECT_NEAR(1.0f, f.order_amp[0][1], 0.05f);
+
+    order_track_free(ot);
+}
+
+TEST(order_track_process, gap_restarts_the_angle_buffer)
+{
+    order_track_t *ot = order_track_init(&cfg);
+    ASSERT_NE(nullptr, ot);
+
+    feed_opts o;
+    o.gap_at_s = 2.0;
+    const std::vector<order_features_t> out = feed(ot, run_up{ 10.0, 10.0 }, o);
+
+    // no spectrum spans the missing samples, and none is corrupted by them
+    const uint64_t gap_start = t_base_ns + (uint64_t)(2.0 * 1e9) - 1000000ull;
+    const uint64_t gap_end = t_base_ns + (uint64_t)(2.05 * 1e9);
+    bool after = false;
+    for (const order_features_t &f : out)
+    {
+        EXPECT_FALSE(f.t_start_ns < gap_end && f.t_end_ns > gap_start);
+        EXPECT_NEAR(1.0f, f.order_amp[0][1], 0.03f);
+        after |= f.t_start_ns >= gap_end;
+    }
+    EXPECT_TRUE(after);
+
+    order_track_free(ot);
+}
+
+TEST(order_track_process, waits_for_vibration_to_cover_the_pulses)
+{
+    order_track_t *ot = order_track_init(&cfg);
+    ASSERT_NE(nullptr, ot);
+
+    // 8 revolutions of pulses at 1200 rpm, but no samples yet
+    for (int k = 0; k <= 8; k++) ASSERT_EQ(OK, order_track_add_edge(ot, t_base_ns + (uint64_t)k * 50000000ull));
+    uint8_t ready = 1;
+    order_features_t f;
+    ASSERT_EQ(OK, order_track_process(ot, &ready, &f));
+    EXPECT_EQ(0, ready);
+
+    // timestamps must increase
+    EXPECT_EQ(ERROR, order_track_add_edge(ot, t_base_ns));
+
+    order_track_free(ot);
+}
+
+TEST(order_track_speed, stop_reports_zero)
+{
+    order_track_t *ot = order_track_init(&cfg);
+    ASSERT_NE(nullptr, ot);
+
+    float rpm = -1.0f;
+    ASSERT_EQ(OK, order_track_speed(ot, &rpm));
+    EXPECT_EQ(0.0f, rpm);
+
+    vib_frame_t frame;
+    ASSERT_EQ(OK, vib_frame_init(&frame, 1024));
+    frame.dt_ns = dt_ns;
+    frame.n_samples = 1024;
+    frame.flags = 0;
+
+    // 1200 rpm, then the next pulse comes 1 s later (< min_rpm)
+    ASSERT_EQ(OK, order_track_add_edge(ot, t_base_ns));
+    ASSERT_EQ(OK, order_track_add_edge(ot, t_base_ns + 50000000ull));
+    ASSERT_EQ(OK, order_track_add_edge(ot, t_base_ns + 1050000000ull));
+
+    uint8_t ready = 0;
+    order_features_t f;
+    for (uint64_t t = t_base_ns; t < t_base_ns + 1100000000ull; t += 1024ull * dt_ns)
+    {
+        frame.t_first_ns = t;
+        ASSERT_EQ(OK, order_track_add_frame(ot, &frame));
+        if (t < t_base_ns + 60000000ull)
+        {
+            ASSERT_EQ(OK, order_track_process(ot, &ready, &f));
+            ASSERT_EQ(OK, order_track_speed(ot, &rpm));
+            if (rpm > 0.0f) EXPECT_NEAR(1200.0f, rpm, 1.0f);
+        }
+    }
+    ASSERT_EQ(OK, order_track_process(ot, &ready, &f));
+    EXPECT_EQ(0, ready);
+    ASSERT_EQ(OK, order_track_speed(ot, &rpm));
+    EXPECT_EQ(0.0f, rpm);
+
+    vib_frame_free(&frame);
+    order_track_free(ot);
+}
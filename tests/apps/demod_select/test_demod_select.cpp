@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "apps/demod_select/demod_select.h"
+#include "sensors/vibration/vib_sensor.h"
+#include "common_def.h"
+#include "../../block_stream_fixture.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+
+// 512 samples per block at the IIS3DWB rate, ~19.2 ms
+static const uint32_t samples_per_block = 512;
+static const uint32_t dt_ns = 37500;
+static const float fs_hz = 1.0e9f / dt_ns;
+
+class demod_select_test : public block_stream_test
+{
+protected:
+    demod_select_t *ds = nullptr;
+    demod_select_cfg_t cfg = {};
+    std::mt19937 rng{1};
+    uint64_t sample = 0;            // stream position, drives the synthetic signal
+
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(open_stream(32, samples_per_block));
+
+        cfg.period_ms = 400;
+        cfg.window_ms = 200;
+        cfg.levels = 5;
+        cfg.axis = 2;
+        cfg.sample_rate_hz = fs_hz;
+    }
+
+    void TearDown() override
+    {
+        if (ds)
+        {
+            demod_select_stop(ds);
+            demod_select_free(ds);
+        }
+        close_stream();
+    }
+
+    void start()
+    {
+        ds = demod_select_init(&cfg);
+        ASSERT_NE(nullptr, ds);
+        ASSERT_EQ(OK, demod_select_start(ds, queue));
+    }
+
+    /*
+     z : 1 g of gravity, noise, a 60 Hz running speed tone and resonance bursts at 'carrier_hz'
+     every 10 ms; x and y noise only
+    */
+    void push(uint64_t seq, double carrier_hz, uint32_t flags = 0, uint32_t gen = 1)
+    {
+        sample_block_t *blk = next_block(seq, sample * dt_ns, dt_ns, flags, gen, true);
+        ASSERT_NE(nullptr, blk);
+
+        std::normal_distribution<float> noise(0.0f, 400.0f);
+        auto *s = (vib_sensor_data_t *)blk->data;
+        const size_t burst_every = (size_t)(0.01 * fs_hz);
+        for (uint32_t i = 0; i < samples_per_block; i++, sample++)
+        {
+            const double tb = (double)(sample % burst_every) / fs_hz;
+            const double tone = 4000.0 * std::sin(2.0 * M_PI * 60.0 * (double)sample / fs_hz);
+            const double burst = 3000.0 * std::exp(-tb / 0.0004) * std::sin(2.0 * M_PI * carrier_hz * tb);
+            s[i].accel_x = (int16_t)noise(rng);
+            s[i].accel_y = (int16_t)noise(rng);
+            s[i].accel_z = (int16_t)(16393.0 + noise(rng) + tone + burst);
+        }
+
+        deliver(blk, true);
+    }
+
+    bool wait_idle()
+    {
+        for (int i = 0; i < 2000 && block_queue_count(queue) > 0; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        // the last popped block may still be in the kurtogram
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return block_queue_count(queue) == 0;
+    }
+
+    uint64_t blocks_for_ms(uint32_t ms) const
+    {
+        return (uint64_t)std::ceil(ms * 1.0e6 / ((double)samples_per_block * dt_ns));
+    }
+};
+
+TEST_F(demod_select_test, rejects_bad_config)
+{
+    demod_select_cfg_t bad = cfg;
+    bad.window_ms = 0;
+    EXPECT_EQ(nullptr, demod_select_init(&bad));
+    bad = cfg;
+    bad.window_ms = cfg.period_ms + 1;
+    EXPECT_EQ(nullptr, demod_select_init(&bad));
+    bad = cfg;
+    bad.axis = DEMOD_SELECT_AXES;
+    EXPECT_EQ(nullptr, demod_select_init(&bad));
+    bad = cfg;
+    bad.levels = 0;
+    EXPECT_EQ(nullptr, demod_select_init(&bad));
+    bad = cfg;
+    bad.window_ms = 1;          // not one kurtogram chunk
+    EXPECT_EQ(nullptr, demod_select_init(&bad));
+}
+
+TEST_F(demod_select_test, publishes_the_resonance_band_once_per_period)
+{
+    start();
+
+    uint64_t gen = 0;
+    demod_band_t band = {};
+    snapshot_read(demod_select_band(ds), &band, &gen);
+    EXPECT_EQ(0u, gen);
+
+    // three periods of signal
+    const uint64_t n_blocks = 3 * blocks_for_ms(cfg.period_ms);
+    for (uint64_t b = 0; b < n_blocks; b++) push(b, 7300.0);
+    ASSERT_TRUE(wait_idle());
+
+    demod_select_stats_t st = {};
+    ASSERT_EQ(OK, demod_select_stats(ds, &st));
+    EXPECT_EQ(3u, st.windows);
+    EXPECT_EQ(0u, st.restarts);
+    EXPECT_EQ(n_blocks, st.blocks_analysed + st.blocks_skipped);
+    EXPECT_EQ(3 * blocks_for_ms(cfg.window_ms), st.blocks_analysed);
+    EXPECT_GT(st.busy_ns, 0u);
+
+    ASSERT_EQ(OK, snapshot_read(demod_select_band(ds), &band, &gen));
+    EXPECT_EQ(3u, gen);
+    EXPECT_EQ(2u, band.window_seq);
+    EXPECT_EQ(2u, band.axis);
+    EXPECT_EQ(1u, band.cfg_gen);
+    // window 3 opens with the first block a period after window 2 did
+    const uint64_t block_ns = (uint64_t)samples_per_block * dt_ns;
+    EXPECT_GE(band.t_start_ns, 2ull * cfg.period_ms * 1000000ull);
+    EXPECT_LT(band.t_start_ns, 2ull * cfg.period_ms * 1000000ull + 2 * block_ns);
+    EXPECT_GE(band.t_end_ns - band.t_start_ns, cfg.window_ms * 1000000ull - dt_ns);
+    EXPECT_GE(band.band.level, 1u);
+    EXPECT_LE(band.band.f_lo_hz, 7300.0f);
+    EXPECT_GE(band.band.f_hi_hz, 7300.0f);
+    EXPECT_GT(band.band.sk, 1.0f);
+}
+
+TEST_F(demod_select_test, discontinuity_restarts_the_window)
+{
+    cfg.period_ms = 200;        // continuous
+    start();
+
+    const uint64_t per_window = blocks_for_ms(cfg.window_ms);
+    uint64_t seq = 0;
+
+    // half a window, then a gap flag; half, then a lost block; half, then a new generation
+    for (uint64_t b = 0; b < per_window / 2; b++) push(seq++, 2500.0);
+    push(seq++, 2500.0, BLOCK_FLAG_GAP);
+    for (uint64_t b = 1; b < per_window / 2; b++) push(seq++, 2500.0);
+    seq++;
+    for (uint64_t b = 0; b < per_window / 2; b++) push(seq++, 2500.0);
+    const uint64_t t_gen2 = sample * dt_ns;
+    for (uint64_t b = 0; b < per_window; b++) push(seq++, 2500.0, 0, 2);
+    ASSERT_TRUE(wait_idle());
+
+    demod_select_stats_t st = {};
+    ASSERT_EQ(OK, demod_select_stats(ds, &st));
+    EXPECT_EQ(3u, st.restarts);
+    EXPECT_EQ(1u, st.windows);
+
+    // the only window is the one that started at the generation change
+    uint64_t gen = 0;
+    demod_band_t band = {};
+    ASSERT_EQ(OK, snapshot_read(demod_select_band(ds), &band, &gen));
+    EXPECT_EQ(1u, gen);
+    EXPECT_EQ(t_gen2, band.t_start_ns);
+    EXPECT_EQ(2u, band.cfg_gen);
+    EXPECT_LE(band.band.f_lo_hz, 2500.0f);
+    EXPECT_GE(band.band.f_hi_hz, 2500.0f);
+}
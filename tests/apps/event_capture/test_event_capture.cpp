@@ -0,0 +1,345 @@
+#include <gtest/gtest.h>
+#include "apps/event_capture/event_capture.h"
+#include "sensors/vibration/vib_sensor.h"
+#include "common_def.h"
+#include "../../block_stream_fixture.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+// 10 samples of 0.1 ms per block : block 'seq' spans [seq, seq + 1) ms
+static const uint32_t samples_per_block = 10;
+static const uint32_t dt_ns = 100000;
+static const uint64_t ms = 1000000ull;
+
+struct vcap_event
+{
+    vcap_file_header_t hdr;
+    std::vector<vcap_block_header_t> blocks;
+    std::vector<std::vector<vib_sensor_data_t>> samples;
+};
+
+class event_capture_test : public block_stream_test
+{
+protected:
+    event_capture_t *ec = nullptr;
+    event_capture_cfg_t cfg = {};
+    char dir[64] = "/tmp/vcap_test_XXXXXX";
+
+    void SetUp() override
+    {
+        ASSERT_NE(nullptr, mkdtemp(dir));
+
+        ASSERT_NO_FATAL_FAILURE(open_stream(128, samples_per_block));
+
+        cfg.pre_ms = 10;
+        cfg.post_ms = 10;
+        cfg.lag_ms = 0;
+        cfg.block_ns = samples_per_block * dt_ns;
+        cfg.max_events = 2;
+        cfg.level_lsb = 0;
+        cfg.dir = dir;
+    }
+
+    void TearDown() override
+    {
+        if (ec)
+        {
+            event_capture_stop(ec);
+            event_capture_free(ec);
+        }
+        close_stream();
+        std::system((std::string("rm -rf ") + dir).c_str());
+    }
+
+    void start()
+    {
+        ec = event_capture_init(&cfg);
+        ASSERT_NE(nullptr, ec);
+        ASSERT_EQ(OK, event_capture_start(ec, queue));
+    }
+
+    // accel_x carries the block sequence number, accel_y the sample index
+    void push(uint64_t seq, int16_t level = 0, uint32_t gen = 1)
+    {
+        sample_block_t *blk = next_block(seq, seq * ms, dt_ns, 0, gen, false);
+        ASSERT_NE(nullptr, blk);
+        auto *s = (vib_sensor_data_t *)blk->data;
+        for (uint32_t i = 0; i < samples_per_block; i++)
+        {
+            s[i].accel_x = (int16_t)seq;
+            s[i].accel_y = (int16_t)i;
+            s[i].accel_z = level;
+        }
+        ASSERT_TRUE(deliver(blk, false));
+    }
+
+    void push_range(uint64_t first, uint64_t last)
+    {
+        for (uint64_t s = first; s <= last; s++) push(s);
+    }
+
+    bool wait_for(const std::function<bool(const event_capture_stats_t &)> &cond)
+    {
+        for (int i = 0; i < 2000; i++)
+        {
+            event_capture_stats_t st = {};
+            event_capture_stats(ec, &st);
+            if (cond(st) && block_queue_count(queue) == 0) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    // the stage has taken every queued block into its history
+    void drain()
+    {
+        const size_t hist = (size_t)((cfg.pre_ms + cfg.lag_ms) * ms / cfg.block_ns) + 1;
+        ASSERT_TRUE(wait_for([&](const event_capture_stats_t &st) { return st.refs_held >= hist; }));
+    }
+
+    bool load(uint64_t id, vcap_event &ev)
+    {
+        std::string path = std::string(dir) + "/event_" + std::to_string(id) + ".vcap";
+        FILE *f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        bool ok = std::fread(&ev.hdr, sizeof(ev.hdr), 1, f) == 1;
+        for (uint32_t i = 0; ok && i < ev.hdr.n_blocks; i++)
+        {
+            vcap_block_header_t bh;
+            ok = std::fread(&bh, sizeof(bh), 1, f) == 1;
+            std::vector<vib_sensor_data_t> s(bh.n_samples);
+            ok = ok && std::fread(s.data(), sizeof(vib_sensor_data_t), bh.n_samples, f) == bh.n_samples;
+            ev.blocks.push_back(bh);
+            ev.samples.push_back(s);
+        }
+        std::fclose(f);
+        return ok;
+    }
+};
+
+TEST(event_capture_init, rejects_bad_config)
+{
+    event_capture_cfg_t cfg = {};
+    cfg.pre_ms = 10;
+    cfg.post_ms = 10;
+    cfg.block_ns = 1000000;
+    cfg.max_events = EVENT_CAPTURE_MAX_EVENTS + 1;
+    cfg.dir = "/tmp";
+    EXPECT_EQ(nullptr, event_capture_init(&cfg));
+
+    cfg.max_events = 1;
+    cfg.block_ns = 0;
+    EXPECT_EQ(nullptr, event_capture_init(&cfg));
+    EXPECT_EQ(nullptr, event_capture_init(NULL));
+}
+
+TEST(event_capture_blocks_needed, history_plus_every_event_slot)
+{
+    event_capture_cfg_t cfg = {};
+    cfg.pre_ms = 10;
+    cfg.post_ms = 20;
+    cfg.lag_ms = 5;
+    cfg.block_ns = 1000000;
+    cfg.max_events = 3;
+
+    // history 16 blocks, each event 16 + 21
+    EXPECT_EQ(16u + 3u * 37u, event_capture_blocks_needed(&cfg));
+}
+
+TEST_F(event_capture_test, external_trigger_stores_pre_and_post_window)
+{
+    start();
+    push_range(0, 29);
+    drain();
+
+    ASSERT_EQ(OK, event_capture_trigger(ec, EVENT_TRIGGER_EXTERNAL, 30 * ms));
+    push_range(30, 45);
+    ASSERT_TRUE(wait_for([](const event_capture_stats_t &st) { return st.written == 1; }));
+
+    vcap_event ev;
+    ASSERT_TRUE(load(0, ev));
+    EXPECT_EQ(EVENT_CAPTURE_FILE_MAGIC, ev.hdr.magic);
+    EXPECT_EQ((uint32_t)EVENT_TRIGGER_EXTERNAL, ev.hdr.trigger);
+    EXPECT_EQ(30 * ms, ev.hdr.t_trigger_ns);
+    EXPECT_EQ(0u, ev.hdr.flags);
+    EXPECT_EQ((uint32_t)sizeof(vib_sensor_data_t), ev.hdr.sample_size);
+
+    // 10 ms before the trigger through 10 ms after, in order and intact
+    ASSERT_EQ(20u, ev.hdr.n_blocks);
+    for (uint32_t i = 0; i < ev.hdr.n_blocks; i++)
+    {
+        EXPECT_EQ(20u + i, ev.blocks[i].seq);
+        EXPECT_EQ((20u + i) * ms, ev.blocks[i].t_first_ns);
+        ASSERT_EQ(samples_per_block, ev.blocks[i].n_samples);
+        EXPECT_EQ((int16_t)(20 + i), ev.samples[i][0].accel_x);
+        EXPECT_EQ(9, ev.samples[i][9].accel_y);
+    }
+
+    event_capture_stats_t st = {};
+    event_capture_stats(ec, &st);
+    EXPECT_EQ(1u, st.triggers[EVENT_TRIGGER_EXTERNAL]);
+    EXPECT_LE(st.refs_held_max, event_capture_blocks_needed(&cfg));
+}
+
+TEST_F(event_capture_test, overlapping_triggers_extend_one_event)
+{
+    start();
+    push_range(0, 29);
+    drain();
+
+    ASSERT_EQ(OK, event_capture_trigger(ec, EVENT_TRIGGER_ALARM, 30 * ms));
+    push(30);
+    ASSERT_EQ(OK, event_capture_trigger(ec, EVENT_TRIGGER_EXTERNAL, 31 * ms));
+    push_range(31, 50);
+    ASSERT_TRUE(wait_for([](const event_capture_stats_t &st) { return st.written == 1; }));
+
+    event_capture_stats_t st = {};
+    event_capture_stats(ec, &st);
+    EXPECT_EQ(1u, st.merged);
+    EXPECT_EQ(0u, st.dropped);
+
+    vcap_event ev;
+    ASSERT_TRUE(load(0, ev));
+    EXPECT_EQ((uint32_t)EVENT_TRIGGER_ALARM, ev.hdr.trigger);
+    EXPECT_EQ((uint32_t)EVENT_FLAG_MERGED, ev.hdr.flags);
+    ASSERT_EQ(21u, ev.hdr.n_blocks);            // 20 .. 40, post window now ends at 41 ms
+    EXPECT_EQ(40u, ev.blocks.back().seq);
+}
+
+TEST_F(event_capture_test, extension_past_event_capacity_is_truncated)
+{
+    start();
+    push_range(0, 29);
+    drain();
+
+    // each event holds 11 + 11 blocks, extending the post window to 48 ms would need 28
+    ASSERT_EQ(OK, event_capture_trigger(ec, EVENT_TRIGGER_ALARM, 30 * ms));
+    push(30);
+    ASSERT_EQ(OK, event_capture_trigger(ec, EVENT_TRIGGER_ALARM, 38 * ms));
+    push_range(31, 50);
+    ASSERT_TRUE(wait_for([](const event_capture_stats_t &st) { return st.written == 1; }));
+
+    vcap_event ev;
+    ASSERT_TRUE(load(0, ev));
+    EXPECT_EQ((uint32_t)(EVENT_FLAG_MERGED | EVENT_FLAG_TRUNCATED), ev.hdr.flags);
+    ASSERT_EQ(22u, ev.hdr.n_blocks);
+    EXPECT_EQ(41u, ev.blocks.back().seq);
+}
+
+TEST_F(event_capture_test, triggers_beyond_the_slot_budget_are_dropped)
+{
+    cfg.max_events = 1;
+    start();
+    push_range(0, 29);
+    drain();
+
+    // the second trigger predates the collecting event, it would need its own slot
+    ASSERT_EQ(OK, event_capture_trigger(ec, EVENT_TRIGGER_EXTERNAL, 30 * ms));
+    ASSERT_EQ(OK, event_capture_trigger(ec, EVENT_TRIGGER_EXTERNAL, 25 * ms));
+    push_range(30, 45);
+    ASSERT_TRUE(wait_for([](const event_capture_stats_t &st) { return st.written == 1; }));
+
+    event_capture_stats_t st = {};
+    event_capture_stats(ec, &st);
+    EXPECT_EQ(2u, st.triggers[EVENT_TRIGGER_EXTERNAL]);
+    EXPECT_EQ(1u, st.dropped);
+    EXPECT_LE(st.refs_held_max, event_capture_blocks_needed(&cfg));
+}
+
+TEST_F(event_capture_test, triggers_beyond_the_pending_queue_are_refused)
+{
+    // not started : nothing takes the triggers off the queue
+    ec = event_capture_init(&cfg);
+    ASSERT_NE(nullptr, ec);
+
+    for (int i = 0; i < EVENT_CAPTURE_MAX_PENDING; i++)
+    {
+        ASSERT_EQ(OK, event_capture_trigger(ec, EVENT_TRIGGER_EXTERNAL, (uint64_t)i * ms));
+    }
+    EXPECT_EQ(ERROR, event_capture_trigger(ec, EVENT_TRIGGER_EXTERNAL, 20 * ms));
+
+    event_capture_stats_t st = {};
+    event_capture_stats(ec, &st);
+    EXPECT_EQ(1u, st.refused);
+    EXPECT_EQ(0u, st.dropped);
+}
+
+TEST_F(event_capture_test, level_trigger_fires_once_per_excursion)
+{
+    cfg.level_lsb = 1000;
+    start();
+    push_range(0, 14);
+    push(15, 2000);
+    push(16, 2000);
+    push(17, 2000);
+    push_range(18, 40);
+    push(41, -2000);
+    push_range(42, 60);
+    ASSERT_TRUE(wait_for([](const event_capture_stats_t &st) { return st.written == 2; }));
+
+    event_capture_stats_t st = {};
+    event_capture_stats(ec, &st);
+    EXPECT_EQ(2u, st.triggers[EVENT_TRIGGER_LEVEL]);
+
+    vcap_event ev;
+    ASSERT_TRUE(load(0, ev));
+    EXPECT_EQ((uint32_t)EVENT_TRIGGER_LEVEL, ev.hdr.trigger);
+    EXPECT_EQ(15 * ms, ev.hdr.t_trigger_ns);
+    EXPECT_EQ(5u, ev.blocks.front().seq);       // 10 ms of history
+    EXPECT_EQ(24u, ev.blocks.back().seq);
+}
+
+TEST_F(event_capture_test, level_change_applies_from_its_generation)
+{
+    cfg.level_lsb = 1000;
+    start();
+    ASSERT_EQ(OK, event_capture_set_level(ec, 4000, 2));
+
+    // generation 1 blocks still compare against the old level, generation 2 against the new one
+    push_range(0, 14);
+    push(15, 2000, 1);
+    for (uint64_t s = 16; s <= 60; s++) push(s, (s == 41) ? 2000 : 0, 2);
+    ASSERT_TRUE(wait_for([](const event_capture_stats_t &st) { return st.written == 1; }));
+
+    event_capture_stats_t st = {};
+    event_capture_stats(ec, &st);
+    EXPECT_EQ(1u, st.triggers[EVENT_TRIGGER_LEVEL]);
+
+    vcap_event ev;
+    ASSERT_TRUE(load(0, ev));
+    EXPECT_EQ(15 * ms, ev.hdr.t_trigger_ns);
+    EXPECT_EQ(1u, ev.blocks.front().cfg_gen);
+    EXPECT_EQ(2u, ev.blocks.back().cfg_gen);
+
+    EXPECT_EQ(ERROR, event_capture_set_level(ec, -1, 3));
+}
+
+TEST_F(event_capture_test, stop_stores_collecting_event_truncated)
+{
+    start();
+    push_range(0, 29);
+    drain();
+
+    ASSERT_EQ(OK, event_capture_trigger(ec, EVENT_TRIGGER_EXTERNAL, 30 * ms));
+    push_range(30, 33);
+    ASSERT_TRUE(wait_for([](const event_capture_stats_t &st) { return st.triggers[EVENT_TRIGGER_EXTERNAL] == 1; }));
+
+    ASSERT_EQ(OK, event_capture_stop(ec));
+
+    event_capture_stats_t st = {};
+    event_capture_stats(ec, &st);
+    EXPECT_EQ(1u, st.written);
+    EXPECT_EQ(0u, st.refs_held);
+
+    vcap_event ev;
+    ASSERT_TRUE(load(0, ev));
+    EXPECT_EQ((uint32_t)EVENT_FLAG_TRUNCATED, ev.hdr.flags);
+    EXPECT_EQ(33u, ev.blocks.back().seq);
+}
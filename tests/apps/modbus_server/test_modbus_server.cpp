@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "apps/modbus_server/modbus_server.h"
+#include "analysis/features/vib_features.h"
+#include "common_def.h"
+
+#include <cstring>
+
+static uint16_t reg_at(const uint8_t *resp, int idx)
+{
+    return (uint16_t)((resp[2 + 2 * idx] << 8) | resp[3 + 2 * idx]);
+}
+
+static float f32_at(const uint8_t *resp, int idx)
+{
+    uint32_t raw = ((uint32_t)reg_at(resp, idx) << 16) | reg_at(resp, idx + 1);
+    float val;
+    std::memcpy(&val, &raw, sizeof(val));
+    return val;
+}
+
+TEST(modbus_process_pdu, fails_on_null_argument)
+{
+    uint8_t resp[MODBUS_MAX_ADU_LEN];
+    EXPECT_EQ(ERROR, modbus_server_process_pdu(nullptr, nullptr, nullptr, 5, resp));
+}
+
+TEST(modbus_process_pdu, illegal_function)
+{
+    uint8_t req[] = {0x06, 0x00, 0x00, 0x00, 0x01};
+    uint8_t resp[MODBUS_MAX_ADU_LEN];
+    ASSERT_EQ(2, modbus_server_process_pdu(nullptr, nullptr, req, sizeof(req), resp));
+    EXPECT_EQ(0x86, resp[0]);
+    EXPECT_EQ(MODBUS_EX_ILLEGAL_FUNCTION, resp[1]);
+}
+
+TEST(modbus_process_pdu, illegal_address_past_map)
+{
+    uint8_t req[] = {MODBUS_FC_READ_INPUT, 0x00, MODBUS_REG_COUNT - 1, 0x00, 0x02};
+    uint8_t resp[MODBUS_MAX_ADU_LEN];
+    ASSERT_EQ(2, modbus_server_process_pdu(nullptr, nullptr, req, sizeof(req), resp));
+    EXPECT_EQ(MODBUS_EX_ILLEGAL_ADDRESS, resp[1]);
+}
+
+TEST(modbus_process_pdu, illegal_quantity)
+{
+    uint8_t req[] = {MODBUS_FC_READ_HOLDING, 0x00, 0x00, 0x00, 0x00};
+    uint8_t resp[MODBUS_MAX_ADU_LEN];
+    ASSERT_EQ(2, modbus_server_process_pdu(nullptr, nullptr, req, sizeof(req), resp));
+    EXPECT_EQ(MODBUS_EX_ILLEGAL_VALUE, resp[1]);
+}
+
+TEST(modbus_process_pdu, serves_published_features)
+{
+    snapshot_t *snap = snapshot_init(sizeof(vib_features_t));
+    ASSERT_NE(nullptr, snap);
+
+    vib_features_t feat = {};
+    feat.block_seq = 0x00010002;
+    feat.alarm_state = VIB_ALARM_WARNING;
+    feat.rms[1] = 0.25f;
+    feat.peak[2] = 1.5f;
+    feat.band_energy[VIB_FEATURES_BANDS - 1] = 0.125f;
+    ASSERT_EQ(OK, snapshot_publish(snap, &feat));
+
+    uint8_t req[] = {MODBUS_FC_READ_INPUT, 0x00, 0x00, 0x00, MODBUS_REG_COUNT};
+    uint8_t resp[MODBUS_MAX_ADU_LEN];
+    ASSERT_EQ(2 + 2 * MODBUS_REG_COUNT, modbus_server_process_pdu(snap, nullptr, req, sizeof(req), resp));
+
+    EXPECT_EQ(MODBUS_FC_READ_INPUT, resp[0]);
+    EXPECT_EQ(2 * MODBUS_REG_COUNT, resp[1]);
+    EXPECT_EQ(0x0001, reg_at(resp, MODBUS_REG_BLOCK_SEQ));
+    EXPECT_EQ(0x0002, reg_at(resp, MODBUS_REG_BLOCK_SEQ + 1));
+    EXPECT_EQ(VIB_ALARM_WARNING, reg_at(resp, MODBUS_REG_ALARM_STATE));
+    EXPECT_FLOAT_EQ(0.25f, f32_at(resp, MODBUS_REG_RMS_X + 2));
+    EXPECT_FLOAT_EQ(1.5f, f32_at(resp, MODBUS_REG_PEAK_X + 4));
+    EXPECT_FLOAT_EQ(0.125f, f32_at(resp, MODBUS_REG_BAND_ENERGY_0 + 2 * (VIB_FEATURES_BANDS - 1)));
+
+    snapshot_free(snap);
+}
@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include "apps/vib_control/vib_control.h"
+#include "common_def.h"
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// stands in for the acquisition : apply is called from the control thread
+static std::mutex fake_lock;
+static vib_acq_cfg_t fake_cfg;
+static uint32_t fake_gen;
+static std::atomic<uint32_t> fake_applied{0};
+static bool fake_get_fail = false;
+
+static void fake_reset()
+{
+    std::lock_guard<std::mutex> g(fake_lock);
+    fake_cfg = {IIS3DWB_FS_2G, 0, 32, 0.0f, 0.0f};
+    fake_gen = 1;
+    fake_applied = 0;
+    fake_get_fail = false;
+}
+
+static int fake_get(vib_acq_cfg_t *cfg, uint32_t *gen)
+{
+    std::lock_guard<std::mutex> g(fake_lock);
+    if (fake_get_fail) return ERROR;
+    *cfg = fake_cfg;
+    *gen = fake_gen;
+    return OK;
+}
+
+static int fake_apply(const vib_acq_cfg_t *cfg, uint32_t *gen)
+{
+    std::lock_guard<std::mutex> g(fake_lock);
+    if (cfg->fifo_watermark == 0 || cfg->fifo_watermark > 3000) return ERROR;
+    fake_cfg = *cfg;
+    *gen = ++fake_gen;
+    fake_applied++;
+    return OK;
+}
+
+// field by field, struct padding is not copied
+static bool cfg_eq(const vib_acq_cfg_t &a, const vib_acq_cfg_t &b)
+{
+    return a.fs == b.fs && a.lpf2_en == b.lpf2_en && a.fifo_watermark == b.fifo_watermark &&
+           a.rms_warning_g == b.rms_warning_g && a.rms_danger_g == b.rms_danger_g;
+}
+
+static const vib_control_ops_t fake_ops = { fake_get, fake_apply };
+
+static bool wait_applied(uint32_t n)
+{
+    for (int i = 0; i < 200 && fake_applied.load() < n; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return fake_applied.load() >= n;
+}
+
+TEST(vib_control_parse, applies_keys_and_skips_comments)
+{
+    vib_acq_cfg_t cfg = {IIS3DWB_FS_2G, 0, 32, 0.0f, 0.0f};
+    const char *text = "# acquisition\nfs=8 lpf2=1\n  wtm=128   # words\nrms_warning=0.5 rms_danger=1.25\n";
+
+    ASSERT_EQ(OK, vib_control_parse(text, &cfg));
+    EXPECT_EQ(IIS3DWB_FS_8G, cfg.fs);
+    EXPECT_EQ(1, cfg.lpf2_en);
+    EXPECT_EQ(128, cfg.fifo_watermark);
+    EXPECT_FLOAT_EQ(0.5f, cfg.rms_warning_g);
+    EXPECT_FLOAT_EQ(1.25f, cfg.rms_danger_g);
+
+    // keys not mentioned keep their value
+    ASSERT_EQ(OK, vib_control_parse("fs=16", &cfg));
+    EXPECT_EQ(IIS3DWB_FS_16G, cfg.fs);
+    EXPECT_EQ(128, cfg.fifo_watermark);
+}
+
+TEST(vib_control_parse, rejects_the_whole_text_on_one_bad_token)
+{
+    const vib_acq_cfg_t before = {IIS3DWB_FS_4G, 0, 64, 0.2f, 0.8f};
+    const char *bad[] = {
+        "fs=3", "lpf2=2", "wtm=-1", "wtm=70000", "wtm=12x", "rms_warning=", "odr=26k", "=1", "fs",
+    };
+
+    for (const char *b : bad)
+    {
+        vib_acq_cfg_t cfg = before;
+        std::string text = std::string("wtm=100 ") + b;
+        EXPECT_EQ(ERROR, vib_control_parse(text.c_str(), &cfg)) << b;
+        EXPECT_TRUE(cfg_eq(before, cfg)) << b;
+    }
+}
+
+TEST(vib_control_format, round_trips_through_parse)
+{
+    const vib_acq_cfg_t cfg = {IIS3DWB_FS_4G, 1, 200, 0.25f, 1.5f};
+    char buf[VIB_CONTROL_MAX_LINE];
+
+    ASSERT_GT(vib_control_format(&cfg, 7, buf, sizeof(buf)), 0);
+    EXPECT_STREQ("gen=7 fs=4 lpf2=1 wtm=200 rms_warning=0.250 rms_danger=1.500", buf);
+
+    // parse does not know gen, skip it
+    vib_acq_cfg_t back = {IIS3DWB_FS_2G, 0, 32, 0.0f, 0.0f};
+    ASSERT_EQ(OK, vib_control_parse(std::strchr(buf, ' ') + 1, &back));
+    EXPECT_TRUE(cfg_eq(cfg, back));
+
+    EXPECT_EQ(ERROR, vib_control_format(&cfg, 7, buf, 10));
+}
+
+TEST(vib_control_process_line, answers_get_and_set)
+{
+    fake_reset();
+    char resp[VIB_CONTROL_MAX_LINE];
+
+    ASSERT_GT(vib_control_process_line(&fake_ops, "get", resp, sizeof(resp)), 0);
+    EXPECT_STREQ("ok gen=1 fs=2 lpf2=0 wtm=32 rms_warning=0.000 rms_danger=0.000\n", resp);
+
+    ASSERT_GT(vib_control_process_line(&fake_ops, "set fs=4 wtm=64", resp, sizeof(resp)), 0);
+    EXPECT_STREQ("ok gen=2\n", resp);
+    EXPECT_EQ(IIS3DWB_FS_4G, fake_cfg.fs);
+    EXPECT_EQ(64, fake_cfg.fifo_watermark);
+
+    vib_control_process_line(&fake_ops, "set fs=5", resp, sizeof(resp));
+    EXPECT_STREQ("err invalid setting\n", resp);
+
+    vib_control_process_line(&fake_ops, "set wtm=4000", resp, sizeof(resp));
+    EXPECT_STREQ("err rejected\n", resp);
+    EXPECT_EQ(2u, fake_gen);
+
+    vib_control_process_line(&fake_ops, "reset", resp, sizeof(resp));
+    EXPECT_STREQ("err unknown command\n", resp);
+
+    fake_get_fail = true;
+    vib_control_process_line(&fake_ops, "get", resp, sizeof(resp));
+    EXPECT_STREQ("err unavailable\n", resp);
+}
+
+class vib_control_live : public ::testing::Test
+{
+protected:
+    std::string dir;
+    std::string sock;
+    std::string conf;
+
+    void SetUp() override
+    {
+        fake_reset();
+        char tmpl[] = "/tmp/vib_ctl_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(tmpl));
+        dir = tmpl;
+        sock = dir + "/ctl.sock";
+        conf = dir + "/vib_acq.conf";
+    }
+
+    void TearDown() override
+    {
+        vib_control_stop();
+        std::remove(conf.c_str());
+        std::remove((conf + ".tmp").c_str());
+        rmdir(dir.c_str());
+    }
+
+    void write_file(const std::string &path, const char *text)
+    {
+        FILE *f = std::fopen(path.c_str(), "w");
+        ASSERT_NE(nullptr, f);
+        std::fputs(text, f);
+        std::fclose(f);
+    }
+};
+
+TEST_F(vib_control_live, serves_commands_over_the_socket)
+{
+    ASSERT_EQ(OK, vib_control_start(sock.c_str(), nullptr, &fake_ops));
+    EXPECT_EQ(ERROR, vib_control_start(sock.c_str(), nullptr, &fake_ops));
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, sock.c_str());
+    ASSERT_EQ(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+    struct timeval tv = {2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    // two commands in one write, answered in order
+    const char cmds[] = "set wtm=100 rms_warning=0.5\r\nget\n";
+    ASSERT_EQ((ssize_t)(sizeof(cmds) - 1), send(fd, cmds, sizeof(cmds) - 1, 0));
+
+    std::string rx;
+    char buf[VIB_CONTROL_MAX_LINE];
+    while (std::count(rx.begin(), rx.end(), '\n') < 2)
+    {
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        ASSERT_GT(n, 0);
+        rx.append(buf, (size_t)n);
+    }
+    EXPECT_EQ("ok gen=2\nok gen=2 fs=2 lpf2=0 wtm=100 rms_warning=0.500 rms_danger=0.000\n", rx);
+
+    close(fd);
+    EXPECT_EQ(OK, vib_control_stop());
+    EXPECT_NE(0, access(sock.c_str(), F_OK));
+}
+
+TEST_F(vib_control_live, reloads_the_file_when_replaced)
+{
+    write_file(conf, "wtm=48\n");
+    ASSERT_EQ(OK, vib_control_start(nullptr, conf.c_str(), &fake_ops));
+    EXPECT_EQ(1u, fake_applied.load());     // applied at start
+    EXPECT_EQ(48, fake_cfg.fifo_watermark);
+
+    // replaced by rename, as deploy tools do
+    write_file(conf + ".tmp", "fs=8 lpf2=1\n");
+    ASSERT_EQ(0, std::rename((conf + ".tmp").c_str(), conf.c_str()));
+    ASSERT_TRUE(wait_applied(2));
+    {
+        std::lock_guard<std::mutex> g(fake_lock);
+        EXPECT_EQ(IIS3DWB_FS_8G, fake_cfg.fs);
+        EXPECT_EQ(1, fake_cfg.lpf2_en);
+        EXPECT_EQ(48, fake_cfg.fifo_watermark);
+    }
+
+    // an invalid rewrite leaves the running configuration alone
+    write_file(conf, "fs=3\n");
+    write_file(conf, "wtm=96\n");
+    ASSERT_TRUE(wait_applied(3));
+    std::lock_guard<std::mutex> g(fake_lock);
+    EXPECT_EQ(IIS3DWB_FS_8G, fake_cfg.fs);
+    EXPECT_EQ(96, fake_cfg.fifo_watermark);
+    EXPECT_EQ(3u, fake_applied.load());
+}
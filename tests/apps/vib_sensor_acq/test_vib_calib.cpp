@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "apps/vib_sensor_acq/vib_calib.h"
+#include "common_def.h"
+
+#include <cstdio>
+#include <string>
+
+static vib_calib_cfg_t test_cfg(uint32_t target_latency_us)
+{
+    vib_calib_cfg_t cfg = {};
+    cfg.max_speed_hz = 10000000;
+    cfg.target_latency_us = target_latency_us;
+    cfg.link_rounds = 16;
+    return cfg;
+}
+
+// clocks 1/2/4/5/8 MHz, failing from 'first_fail' on; batches 16..256 words at 'xfer_us' each
+static vib_calib_results_t test_results(int first_fail, uint32_t xfer_us)
+{
+    static const uint32_t speeds[] = {1000000, 2000000, 4000000, 5000000, 8000000};
+    static const uint16_t batches[] = {16, 32, 64, 128, 192, 256};
+
+    vib_calib_results_t r = {};
+    for (int i = 0; i < 5; i++)
+    {
+        r.speed_hz[i] = speeds[i];
+        r.link_errors[i] = (first_fail >= 0 && i >= first_fail) ? 3 : 0;
+        r.n_speeds++;
+        if (r.link_errors[i]) break;
+    }
+    for (int b = 0; b < 6; b++)
+    {
+        r.batch_words[b] = batches[b];
+        r.batch_xfer_us[b] = xfer_us;
+        r.n_batches++;
+    }
+    return r;
+}
+
+TEST(vib_calib_choose, fails_on_null_argument)
+{
+    vib_calib_profile_t profile;
+    EXPECT_EQ(ERROR, vib_calib_choose(nullptr, nullptr, &profile));
+}
+
+TEST(vib_calib_choose, keeps_fastest_clock_when_nothing_fails)
+{
+    vib_calib_cfg_t cfg = test_cfg(20000);
+    vib_calib_results_t r = test_results(-1, 100);
+    vib_calib_profile_t profile = {};
+    ASSERT_EQ(OK, vib_calib_choose(&cfg, &r, &profile));
+    EXPECT_EQ(8000000u, profile.speed_hz);
+}
+
+TEST(vib_calib_choose, derates_below_failure_edge)
+{
+    vib_calib_cfg_t cfg = test_cfg(20000);
+    vib_calib_results_t r = test_results(4, 100);    // 8 MHz fails, 5 MHz is the edge
+    vib_calib_profile_t profile = {};
+    ASSERT_EQ(OK, vib_calib_choose(&cfg, &r, &profile));
+    EXPECT_EQ(4000000u, profile.speed_hz);
+}
+
+TEST(vib_calib_choose, keeps_slowest_clock_when_it_is_the_only_one_passing)
+{
+    vib_calib_cfg_t cfg = test_cfg(20000);
+    vib_calib_results_t r = test_results(1, 100);    // 2 MHz fails, nothing below 1 MHz
+    vib_calib_profile_t profile = {};
+    ASSERT_EQ(OK, vib_calib_choose(&cfg, &r, &profile));
+    EXPECT_EQ(1000000u, profile.speed_hz);
+}
+
+TEST(vib_calib_choose, fails_when_slowest_clock_fails)
+{
+    vib_calib_cfg_t cfg = test_cfg(20000);
+    vib_calib_results_t r = test_results(0, 100);
+    vib_calib_profile_t profile = {};
+    EXPECT_EQ(ERROR, vib_calib_choose(&cfg, &r, &profile));
+}
+
+TEST(vib_calib_choose, largest_batch_within_latency)
+{
+    // 128 words fill in 4.8 ms, 192 in 7.2 ms : with 200 us transfer only 128 fits 5.5 ms
+    vib_calib_cfg_t cfg = test_cfg(5500);
+    vib_calib_results_t r = test_results(-1, 200);
+    vib_calib_profile_t profile = {};
+    ASSERT_EQ(OK, vib_calib_choose(&cfg, &r, &profile));
+    EXPECT_EQ(128u, profile.fifo_watermark);
+    EXPECT_EQ(4u, profile.queue_depth);
+    EXPECT_EQ(200u, profile.batch_xfer_us);
+}
+
+TEST(vib_calib_choose, falls_back_to_smallest_sustainable_batch)
+{
+    // 1.5 ms transfers : 16/32/64 words cannot keep up (fill < 2 * xfer), 128 can
+    vib_calib_cfg_t cfg = test_cfg(1000);
+    vib_calib_results_t r = test_results(-1, 1500);
+    vib_calib_profile_t profile = {};
+    ASSERT_EQ(OK, vib_calib_choose(&cfg, &r, &profile));
+    EXPECT_EQ(128u, profile.fifo_watermark);
+}
+
+TEST(vib_calib_profile, save_load_round_trip_and_mismatch)
+{
+    std::string path = ::testing::TempDir() + "vib_calib_test.prof";
+    vib_calib_cfg_t cfg = test_cfg(10000);
+    vib_calib_profile_t saved = {5000000, 128, 6, 250};
+    ASSERT_EQ(OK, vib_calib_profile_save(path.c_str(), SPI_DEVICE_0, &cfg, &saved));
+
+    vib_calib_profile_t loaded = {};
+    ASSERT_EQ(OK, vib_calib_profile_load(path.c_str(), SPI_DEVICE_0, &cfg, &loaded));
+    EXPECT_EQ(saved.speed_hz, loaded.speed_hz);
+    EXPECT_EQ(saved.fifo_watermark, loaded.fifo_watermark);
+    EXPECT_EQ(saved.queue_depth, loaded.queue_depth);
+
+    // different bus or different request invalidates the profile
+    EXPECT_EQ(ERROR, vib_calib_profile_load(path.c_str(), SPI_DEVICE_1, &cfg, &loaded));
+    cfg.target_latency_us = 5000;
+    EXPECT_EQ(ERROR, vib_calib_profile_load(path.c_str(), SPI_DEVICE_0, &cfg, &loaded));
+
+    std::remove(path.c_str());
+}
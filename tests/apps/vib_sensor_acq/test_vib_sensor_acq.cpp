@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "apps/vib_sensor_acq/vib_sensor_acq.h"
+#include "common_def.h"
+#include "../../spi_device_model.h"
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+extern bool (*mock_open_filter)(const char *pathname);
+
+/*
+ IIS3DWB FIFO on top of the register model : 'available' accelerometer words, reported through
+ FIFO_STATUS1/2 and handed out by FIFO_DATA_OUT bursts. Every other transfer goes to the
+ register model. The producer thread and the test share the model, both under 'lock'
+*/
+struct fifo_model
+{
+    static inline std::mutex lock;
+    static inline uint32_t available = 0;
+
+    static int handler(int fd, unsigned long request, void *arg)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        auto *tr = (struct spi_ioc_transfer *)arg;
+        auto *tx = (const uint8_t *)(uintptr_t)tr->tx_buf;
+        auto *rx = (uint8_t *)(uintptr_t)tr->rx_buf;
+        if (request != SPI_IOC_MESSAGE(1) || !tx || !rx || tr->len < 2 || !(tx[0] & IIS3DWB_READ_MASK))
+        {
+            return spi_device_model::handler(fd, request, arg);
+        }
+
+        const uint8_t reg = tx[0] & 0x7F;
+        if (reg == IIS3DWB_FIFO_STATUS1_REG)
+        {
+            const uint32_t level = (available > 0x3FF) ? 0x3FF : available;
+            rx[1] = (uint8_t)(level & 0xFF);
+            if (tr->len > 2) rx[2] = (uint8_t)(level >> 8);
+            return (int)tr->len;
+        }
+        if (reg == IIS3DWB_FIFO_DATA_OUT_TAG_REG)
+        {
+            memset(rx, 0, tr->len);
+            const uint32_t words = (tr->len - 1) / IIS3DWB_FIFO_WORD_LEN;
+            for (uint32_t i = 0; i < words && available > 0; i++, available--)
+            {
+                rx[1 + i * IIS3DWB_FIFO_WORD_LEN] = IIS3DWB_FIFO_TAG_XL << 3;
+            }
+            return (int)tr->len;
+        }
+
+        return spi_device_model::handler(fd, request, arg);
+    }
+
+    static uint32_t pending()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return available;
+    }
+
+    static void feed(uint32_t words)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        available += words;
+    }
+
+    // latched flag bits : set now, cleared by the first read of 'reg'
+    static void latch(uint8_t reg, uint8_t bits)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        spi_device_model::regs[reg] |= bits;
+        spi_device_model::clear_on_read[reg] = bits;
+    }
+};
+
+// device nodes go to the models, nothing under /var/lib (trend store, model) is touched
+static bool only_device_nodes(const char *pathname)
+{
+    return strncmp(pathname, "/dev/", 5) == 0;
+}
+
+class vib_acq_test : public ::testing::Test
+{
+protected:
+    bool started = false;
+
+    void SetUp() override
+    {
+        spi_device_model::install();
+        spi_device_model::regs[IIS3DWB_WHO_AM_I_REG] = IIS3DWB_WHO_AM_I_VAL;
+        fifo_model::available = 0;
+        mock_ioctl_handler = fifo_model::handler;
+        mock_open_filter = only_device_nodes;
+
+        // subscriber queues of 4 blocks
+        ASSERT_EQ(OK, vib_sensor_acq_init(SPI_DEVICE_0, SPI_MODE_0, 10000000, 8, 4, nullptr));
+    }
+
+    void TearDown() override
+    {
+        if (started) EXPECT_EQ(OK, vib_sensor_acq_stop());
+        mock_open_filter = nullptr;
+        spi_device_model::remove();
+    }
+
+    void start()
+    {
+        ASSERT_EQ(OK, vib_sensor_acq_start());
+        started = true;
+    }
+
+    static vib_acq_stats_t stats()
+    {
+        vib_acq_stats_t st = {};
+        EXPECT_EQ(OK, vib_sensor_acq_stats(&st));
+        return st;
+    }
+
+    static bool wait_for(const std::function<bool(const vib_acq_stats_t &)> &done, int timeout_ms)
+    {
+        for (int i = 0; i < timeout_ms; i++)
+        {
+            if (done(stats())) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return done(stats());
+    }
+};
+
+TEST_F(vib_acq_test, feature_queue_drop_restarts_the_feature_block)
+{
+    start();
+
+    // bursts far faster than the feature stage, which naps on its empty queue, until its queue overflows
+    ASSERT_TRUE(wait_for([](const vib_acq_stats_t &st) {
+        if (st.queue_drops == 0 && fifo_model::pending() == 0) fifo_model::feed(32 * IIS3DWB_FIFO_MAX_WORDS);
+        return st.queue_drops > 0;
+    }, 2000));
+
+    const vib_acq_stats_t flooded = stats();
+    EXPECT_EQ(0u, flooded.fifo_overruns);
+    EXPECT_EQ(0u, flooded.pool.exhausted);
+
+    // nothing in the blocks themselves marks the hole, the first one delivered after it must
+    ASSERT_TRUE(wait_for([](const vib_acq_stats_t &st) {
+        if (st.feature_gaps == 0 && fifo_model::pending() == 0) fifo_model::feed(IIS3DWB_FIFO_MAX_WORDS);
+        return st.feature_gaps > 0;
+    }, 2000));
+}
+
+TEST_F(vib_acq_test, wake_up_latched_during_a_window_does_not_open_the_next_one)
+{
+    vib_duty_cfg_t duty = {};
+    duty.period_ms = 5000;
+    duty.capture_ms = 100;
+    duty.wake_threshold_g = 0.5f;
+    ASSERT_EQ(OK, vib_sensor_acq_set_duty(&duty));
+    start();
+
+    // a crossing inside the first window, already in its samples
+    fifo_model::latch(IIS3DWB_WAKE_UP_SRC_REG, 0x08);
+    ASSERT_TRUE(wait_for([](const vib_acq_stats_t &st) { return st.parked_ms > 0; }, 1000));
+
+    // a few parked polls later the stale latch has not reopened capture
+    std::this_thread::sleep_for(std::chrono::milliseconds(350));
+    vib_acq_stats_t st = stats();
+    EXPECT_EQ(0u, st.wake_triggers);
+    EXPECT_EQ(1u, st.windows);
+
+    // a crossing while parked still does
+    fifo_model::latch(IIS3DWB_WAKE_UP_SRC_REG, 0x08);
+    ASSERT_TRUE(wait_for([](const vib_acq_stats_t &st) { return st.wake_triggers > 0; }, 1000));
+    st = stats();
+    EXPECT_EQ(1u, st.wake_triggers);
+    EXPECT_EQ(2u, st.windows);
+}
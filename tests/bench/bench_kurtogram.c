@@ -0,0 +1,113 @@
+/*
+Description : fast kurtogram CPU cost at the full IIS3DWB rate, per decomposition depth
+              - synthetic bearing signal fed in FIFO sized bursts, as the worker sees it
+              - reports the share of one core needed to keep up with continuous analysis and
+                with the duty-cycled default of the demodulation band selection
+
+usage : bench_kurtogram [seconds of signal] [window_ms] [period_ms]
+*/
+
+#include "analysis/kurtogram/kurtogram.h"
+#include "sensors/vibration/vib_sensor.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_SECONDS       20
+#define BENCH_DEFAULT_WINDOW_MS     1000
+#define BENCH_DEFAULT_PERIOD_MS     10000
+#define BENCH_BURST                 128     /* samples per FIFO watermark */
+#define BENCH_PI                    3.14159265358979323846
+
+static uint32_t rng_state = 12345;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* noise, gravity, a 50 Hz tone and 0.4 ms resonance bursts at 6 kHz every 7 ms, in raw counts */
+static float *make_signal(size_t n)
+{
+    float *x = malloc(n * sizeof(float));
+    if (!x) return NULL;
+
+    const size_t burst_every = (size_t)(0.007 * IIS3DWB_ODR_HZ);
+    for (size_t i = 0; i < n; i++)
+    {
+        const double t = (double)i / IIS3DWB_ODR_HZ;
+        const double tb = (double)(i % burst_every) / IIS3DWB_ODR_HZ;
+        const float noise = (float)((int)(rng_next() % 1001) - 500);
+        x[i] = 16393.0f + noise + (float)(3000.0 * sin(2.0 * BENCH_PI * 50.0 * t)) +
+               (float)(4000.0 * exp(-tb / 0.0004) * sin(2.0 * BENCH_PI * 6000.0 * tb));
+    }
+
+    return x;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = (argc > 1) ? (uint32_t)atoi(argv[1]) : BENCH_DEFAULT_SECONDS;
+    uint32_t window_ms = (argc > 2) ? (uint32_t)atoi(argv[2]) : BENCH_DEFAULT_WINDOW_MS;
+    uint32_t period_ms = (argc > 3) ? (uint32_t)atoi(argv[3]) : BENCH_DEFAULT_PERIOD_MS;
+    if (seconds == 0) seconds = BENCH_DEFAULT_SECONDS;
+    if (window_ms == 0 || period_ms < window_ms)
+    {
+        window_ms = BENCH_DEFAULT_WINDOW_MS;
+        period_ms = BENCH_DEFAULT_PERIOD_MS;
+    }
+
+    const size_t n = (size_t)seconds * IIS3DWB_ODR_HZ;
+    float *x = make_signal(n);
+    if (!x) return ERROR;
+
+    printf("%u s of signal at %u Hz, %u sample bursts, duty cycle %u ms every %u ms\n",
+           seconds, IIS3DWB_ODR_HZ, BENCH_BURST, window_ms, period_ms);
+
+    for (uint32_t levels = 2; levels <= KURTOGRAM_MAX_LEVELS; levels++)
+    {
+        const kurtogram_cfg_t cfg = { .levels = levels, .sample_rate_hz = (float)IIS3DWB_ODR_HZ };
+        kurtogram_t *kg = kurtogram_init(&cfg);
+        if (!kg) return ERROR;
+
+        kurtogram_add(kg, x, KURTOGRAM_CHUNK);      /* warm caches */
+        kurtogram_reset(kg);
+
+        const uint64_t t0 = monotonic_ns();
+        for (size_t pos = 0; pos < n; pos += BENCH_BURST)
+        {
+            kurtogram_add(kg, x + pos, (n - pos < BENCH_BURST) ? n - pos : BENCH_BURST);
+        }
+        const double secs = (double)(monotonic_ns() - t0) / 1e9;
+
+        kurtogram_band_t best;
+        kurtogram_best(kg, &best);
+
+        /* one core fraction : processing time over the signal duration */
+        const double load = secs / (double)seconds;
+        printf("levels %u  bands %4u  %7.2f Msample/s  %6.2f ns/sample  cpu continuous %6.2f %%  duty-cycled %6.3f %%"
+               "  best %5.0f-%5.0f Hz (L%u, SK %.1f)\n",
+               levels, (2u << levels) - 1, (double)n / secs / 1e6, secs * 1e9 / (double)n,
+               load * 100.0, load * 100.0 * window_ms / period_ms,
+               best.f_lo_hz, best.f_hi_hz, best.level, best.sk);
+
+        kurtogram_free(kg);
+    }
+
+    free(x);
+
+    return 0;
+}
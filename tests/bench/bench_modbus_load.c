@@ -0,0 +1,215 @@
+/* 
+Description : Modbus TCP load test - request latency from many pollers while an
+              acquisition-side thread runs feature extraction and publishes flat out
+
+usage : bench_modbus_load [clients] [requests_per_client]
+*/
+
+#include "apps/modbus_server/modbus_server.h"
+#include "analysis/features/vib_features.h"
+#include "utilities/snapshot/snapshot.h"
+#include "common_def.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#define BENCH_DEFAULT_CLIENTS       16
+#define BENCH_DEFAULT_REQUESTS      20000
+
+typedef struct
+{
+    uint32_t id;
+    uint32_t requests;
+    uint64_t *latency_ns;           /* one entry per request */
+    uint32_t failures;
+} bench_client_t;
+
+static snapshot_t *features_snap;
+static _Atomic bool acq_run = true;
+static _Atomic uint64_t blocks_published = 0;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* stands in for the acquisition consumer: synthetic samples -> features -> publish */
+static void *acquisition_thread(void *arg)
+{
+    vib_features_cfg_t cfg = {
+        .block_len = 1024,
+        .lsb_to_g = 0.061f / 1000.0f,
+        .rms_warning_g = 0.7f,
+        .rms_danger_g = 1.8f,
+    };
+    vib_features_ctx_t *ctx = vib_features_init(&cfg);
+    if (!ctx) return NULL;
+
+    vib_features_t feat;
+    uint32_t n = 0;
+    while (atomic_load(&acq_run))
+    {
+        float phase = 2.0f * 3.14159265f * 160.0f * (float)n / 26667.0f;
+        vib_sensor_data_t s = {
+            .accel_x = (int16_t)(8000.0f * sinf(phase)),
+            .accel_y = (int16_t)(4000.0f * sinf(2.0f * phase)),
+            .accel_z = (int16_t)(16393 + 2000.0f * sinf(3.0f * phase)),
+        };
+        n++;
+
+        uint8_t ready = 0;
+        if (vib_features_add(ctx, &s, now_ns(), &ready, &feat) == OK && ready)
+        {
+            snapshot_publish(features_snap, &feat);
+            atomic_fetch_add(&blocks_published, 1);
+        }
+    }
+
+    vib_features_free(ctx);
+    return NULL;
+}
+
+static int read_full(int fd, uint8_t *buf, size_t len)
+{
+    size_t got = 0;
+    while (got < len)
+    {
+        ssize_t n = recv(fd, buf + got, len - got, 0);
+        if (n <= 0) return ERROR;
+        got += (size_t)n;
+    }
+    return OK;
+}
+
+static void *client_thread(void *arg)
+{
+    bench_client_t *cl = (bench_client_t *)arg;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(modbus_server_port()),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        cl->failures = cl->requests;
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    /* FC04, all registers */
+    uint8_t req[12] = { 0, 0, 0, 0, 0, 6, 1, MODBUS_FC_READ_INPUT, 0, 0, 0, MODBUS_REG_COUNT };
+    const size_t resp_len = MODBUS_MBAP_LEN + 2 + 2 * MODBUS_REG_COUNT;
+    uint8_t resp[MODBUS_MAX_ADU_LEN];
+
+    for (uint32_t i = 0; i < cl->requests; i++)
+    {
+        req[0] = (uint8_t)(i >> 8);
+        req[1] = (uint8_t)i;
+
+        uint64_t t0 = now_ns();
+        if (send(fd, req, sizeof(req), MSG_NOSIGNAL) != (ssize_t)sizeof(req) ||
+            read_full(fd, resp, resp_len) != OK || resp[0] != req[0] || resp[1] != req[1])
+        {
+            cl->failures++;
+            cl->latency_ns[i] = 0;
+            continue;
+        }
+        cl->latency_ns[i] = now_ns() - t0;
+    }
+
+    close(fd);
+    return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t n_clients = (argc > 1) ? (uint32_t)atoi(argv[1]) : BENCH_DEFAULT_CLIENTS;
+    uint32_t n_requests = (argc > 2) ? (uint32_t)atoi(argv[2]) : BENCH_DEFAULT_REQUESTS;
+    if (n_clients == 0 || n_clients > MODBUS_MAX_CLIENTS || n_requests == 0)
+    {
+        fprintf(stderr, "usage: %s [clients 1-%d] [requests_per_client]\n", argv[0], MODBUS_MAX_CLIENTS);
+        return ERROR;
+    }
+
+    features_snap = snapshot_init(sizeof(vib_features_t));
+    if (!features_snap || modbus_server_start(0, features_snap, NULL) != OK) return ERROR;
+
+    pthread_t acq;
+    pthread_create(&acq, NULL, acquisition_thread, NULL);
+
+    bench_client_t *clients = calloc(n_clients, sizeof(bench_client_t));
+    pthread_t *threads = calloc(n_clients, sizeof(pthread_t));
+    uint64_t *all = calloc((size_t)n_clients * n_requests, sizeof(uint64_t));
+    if (!clients || !threads || !all) return ERROR;
+
+    uint64_t t_start = now_ns();
+    for (uint32_t c = 0; c < n_clients; c++)
+    {
+        clients[c].id = c;
+        clients[c].requests = n_requests;
+        clients[c].latency_ns = &all[(size_t)c * n_requests];
+        pthread_create(&threads[c], NULL, client_thread, &clients[c]);
+    }
+
+    uint32_t failures = 0;
+    for (uint32_t c = 0; c < n_clients; c++)
+    {
+        pthread_join(threads[c], NULL);
+        failures += clients[c].failures;
+    }
+    uint64_t elapsed = now_ns() - t_start;
+
+    atomic_store(&acq_run, false);
+    pthread_join(acq, NULL);
+    modbus_server_stop();
+
+    /* failed requests were stored as 0 and sort to the front */
+    size_t total = (size_t)n_clients * n_requests;
+    qsort(all, total, sizeof(uint64_t), cmp_u64);
+    size_t ok = total - failures;
+    const uint64_t *lat = all + failures;
+
+    printf("clients            : %u\n", n_clients);
+    printf("requests           : %zu (%u failed)\n", total, failures);
+    printf("throughput         : %.0f req/s\n", (double)ok * 1e9 / (double)elapsed);
+    printf("feature publishes  : %.0f blocks/s\n", (double)atomic_load(&blocks_published) * 1e9 / (double)elapsed);
+    if (ok > 0)
+    {
+        printf("latency p50        : %.1f us\n", lat[ok / 2] / 1e3);
+        printf("latency p99        : %.1f us\n", lat[(ok * 99) / 100] / 1e3);
+        printf("latency p99.9      : %.1f us\n", lat[(ok * 999) / 1000] / 1e3);
+        printf("latency max        : %.1f us\n", lat[ok - 1] / 1e3);
+    }
+
+    free(all);
+    free(threads);
+    free(clients);
+    snapshot_free(features_snap);
+
+    return failures ? ERROR : OK;
+}
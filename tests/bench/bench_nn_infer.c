@@ -0,0 +1,182 @@
+/* 
+Description : int8 inference throughput for representative model shapes
+              (feature classifier, spectrum CNN, feature autoencoder) with random weights
+
+usage : bench_nn_infer [iterations]
+*/
+
+#include "analysis/inference/nn_model.h"
+#include "common_def.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_ITERATIONS    20000
+
+typedef struct
+{
+    const char *name;
+    nn_model_spec_t spec;
+    int8_t *weights[NN_MAX_LAYERS];
+    int32_t *bias[NN_MAX_LAYERS];
+} bench_model_t;
+
+static uint32_t rng_state = 12345;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* append a layer, zero points chain from the previous layer */
+static void add_layer(bench_model_t *m, uint32_t type, uint32_t in_len, uint32_t in_ch,
+                      uint32_t out_ch, uint32_t kernel, uint32_t stride, uint32_t act)
+{
+    nn_layer_desc_t *l = &m->spec.layers[m->spec.n_layers].desc;
+    memset(l, 0, sizeof(*l));
+    l->type = type;
+    l->activation = act;
+    l->in_len = in_len;
+    l->in_ch = in_ch;
+    l->out_ch = out_ch;
+    l->kernel = kernel;
+    l->stride = stride;
+    l->out_len = (type == NN_LAYER_DENSE) ? 1 : (in_len - kernel) / stride + 1;
+    l->in_zp = m->spec.n_layers ? m->spec.layers[m->spec.n_layers - 1].desc.out_zp : m->spec.input_zp;
+    l->out_zp = 0;
+    nn_quant_multiplier(1.0 / (64.0 * kernel * in_ch), &l->out_mult, &l->out_shift);
+
+    const size_t nw = (size_t)out_ch * kernel * in_ch;
+    int8_t *w = malloc(nw);
+    int32_t *b = malloc(out_ch * sizeof(int32_t));
+    for (size_t i = 0; i < nw; i++) w[i] = (int8_t)rng_next();
+    for (uint32_t i = 0; i < out_ch; i++) b[i] = (int32_t)(rng_next() % 2000) - 1000;
+
+    m->weights[m->spec.n_layers] = w;
+    m->bias[m->spec.n_layers] = b;
+    m->spec.layers[m->spec.n_layers].weights = w;
+    m->spec.layers[m->spec.n_layers].bias = b;
+    m->spec.n_layers++;
+}
+
+static void init_spec(bench_model_t *m, const char *name, uint32_t kind, uint32_t input_len)
+{
+    memset(m, 0, sizeof(*m));
+    m->name = name;
+    m->spec.kind = kind;
+    m->spec.input_len = input_len;
+    m->spec.input_scale = 0.05f;
+    m->spec.output_scale = 0.05f;
+}
+
+static void run_bench(bench_model_t *m, uint32_t iterations)
+{
+    const size_t len = nn_model_pack(&m->spec, NULL, 0);
+    void *image = len ? malloc(len) : NULL;
+    if (!image || nn_model_pack(&m->spec, image, len) != len)
+    {
+        fprintf(stderr, "%s : invalid model spec\n", m->name);
+        free(image);
+        return;
+    }
+
+    nn_model_t *model = nn_model_load(image, len);
+    if (!model)
+    {
+        free(image);
+        return;
+    }
+
+    const size_t in_len = nn_model_input_len(model);
+    float *in = malloc(in_len * sizeof(float));
+    for (size_t i = 0; i < in_len; i++) in[i] = (float)((int)(rng_next() % 200) - 100) / 20.0f;
+
+    nn_result_t res;
+    for (uint32_t i = 0; i < 100; i++) nn_model_run(model, in, &res);     /* warm caches */
+
+    const uint64_t t0 = monotonic_ns();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        in[i % in_len] += 0.01f;
+        nn_model_run(model, in, &res);
+    }
+    const double secs = (double)(monotonic_ns() - t0) / 1e9;
+
+    uint64_t macs = 0;
+    for (uint32_t i = 0; i < m->spec.n_layers; i++)
+    {
+        const nn_layer_desc_t *l = &m->spec.layers[i].desc;
+        macs += (uint64_t)l->out_len * l->out_ch * l->kernel * l->in_ch;
+    }
+
+    printf("%-22s layers %u  MACs %8llu  image %7zu B  arena %6zu B  %10.0f inf/s  %8.2f us/inf  %6.2f GMAC/s\n",
+           m->name, m->spec.n_layers, (unsigned long long)macs, len, nn_model_arena_bytes(model),
+           iterations / secs, secs * 1e6 / iterations, (double)macs * iterations / secs / 1e9);
+
+    nn_model_close(model);
+    free(in);
+    free(image);
+}
+
+static void free_model(bench_model_t *m)
+{
+    for (uint32_t i = 0; i < m->spec.n_layers; i++)
+    {
+        free(m->weights[i]);
+        free(m->bias[i]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = (argc > 1) ? (uint32_t)atoi(argv[1]) : BENCH_DEFAULT_ITERATIONS;
+    if (iterations == 0) iterations = BENCH_DEFAULT_ITERATIONS;
+
+#if defined(__ARM_NEON)
+    printf("kernels : NEON\n");
+#else
+    printf("kernels : scalar\n");
+#endif
+
+    bench_model_t m;
+
+    /* 14 feature channels -> 4 fault classes */
+    init_spec(&m, "feature_classifier", NN_KIND_CLASSIFIER, 14);
+    add_layer(&m, NN_LAYER_DENSE, 14, 1, 32, 14, 14, NN_ACT_RELU);
+    add_layer(&m, NN_LAYER_DENSE, 32, 1, 16, 32, 32, NN_ACT_RELU);
+    add_layer(&m, NN_LAYER_DENSE, 16, 1, 4, 16, 16, NN_ACT_NONE);
+    run_bench(&m, iterations);
+    free_model(&m);
+
+    /* 512 bin spectrum -> 8 classes */
+    init_spec(&m, "spectrum_cnn", NN_KIND_CLASSIFIER, 512);
+    add_layer(&m, NN_LAYER_CONV1D, 512, 1, 16, 9, 4, NN_ACT_RELU);         /* -> 126 x 16 */
+    add_layer(&m, NN_LAYER_CONV1D, 126, 16, 32, 5, 2, NN_ACT_RELU);        /* -> 61 x 32 */
+    add_layer(&m, NN_LAYER_DENSE, 61 * 32, 1, 32, 61 * 32, 61 * 32, NN_ACT_RELU);
+    add_layer(&m, NN_LAYER_DENSE, 32, 1, 8, 32, 32, NN_ACT_NONE);
+    run_bench(&m, iterations);
+    free_model(&m);
+
+    /* 14 feature channels, reconstruction error as anomaly score */
+    init_spec(&m, "feature_autoencoder", NN_KIND_AUTOENCODER, 14);
+    add_layer(&m, NN_LAYER_DENSE, 14, 1, 8, 14, 14, NN_ACT_RELU);
+    add_layer(&m, NN_LAYER_DENSE, 8, 1, 4, 8, 8, NN_ACT_RELU);
+    add_layer(&m, NN_LAYER_DENSE, 4, 1, 8, 4, 4, NN_ACT_RELU);
+    add_layer(&m, NN_LAYER_DENSE, 8, 1, 14, 8, 8, NN_ACT_NONE);
+    run_bench(&m, iterations);
+    free_model(&m);
+
+    return 0;
+}
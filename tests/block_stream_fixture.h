@@ -0,0 +1,80 @@
+#pragma once
+
+// Block pool and one subscriber queue standing in for the acquisition fan-out, for block stage tests
+#include <gtest/gtest.h>
+#include "utilities/block_pool/block_pool.h"
+#include "utilities/block_queue/block_queue.h"
+#include "sensors/vibration/vib_sensor.h"
+#include "common_def.h"
+
+#include <chrono>
+#include <thread>
+
+class block_stream_test : public ::testing::Test
+{
+protected:
+    block_pool_t *pool = nullptr;
+    block_queue_t *queue = nullptr;
+    uint32_t block_samples = 0;
+
+    // 'n_blocks' blocks of 'samples' vib_sensor_data_t, a queue as deep as the pool
+    void open_stream(size_t n_blocks, uint32_t samples)
+    {
+        block_pool_cfg_t pcfg = {};
+        pcfg.n_blocks = n_blocks;
+        pcfg.payload_size = samples * sizeof(vib_sensor_data_t);
+        pcfg.policy = BLOCK_POOL_EXHAUST_DROP;
+        pool = block_pool_init(&pcfg);
+        queue = block_queue_init(n_blocks);
+        block_samples = samples;
+        ASSERT_NE(nullptr, pool);
+        ASSERT_NE(nullptr, queue);
+    }
+
+    // stage stopped first : whatever it left queued is released and every reference must be back
+    void close_stream()
+    {
+        sample_block_t *blk = nullptr;
+        while (block_queue_pop(queue, &blk) == OK) block_release(blk);
+
+        block_pool_stats_t st = {};
+        block_pool_stats(pool, &st);
+        EXPECT_EQ(0u, st.in_use);
+
+        block_queue_free(queue);
+        block_pool_free(pool);
+    }
+
+    /*
+     a full block with its header filled in, the caller writes the samples and calls deliver()
+     - wait : the stage releases blocks as it goes, wait for room rather than fail
+    */
+    sample_block_t* next_block(uint64_t seq, uint64_t t_first_ns, uint32_t dt_ns, uint32_t flags, uint32_t gen, bool wait)
+    {
+        sample_block_t *blk = block_pool_acquire(pool);
+        for (int i = 0; wait && !blk && i < 2000; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            blk = block_pool_acquire(pool);
+        }
+        if (!blk) return nullptr;
+
+        blk->seq = seq;
+        blk->t_first_ns = t_first_ns;
+        blk->dt_ns = dt_ns;
+        blk->n_samples = block_samples;
+        blk->flags = flags;
+        blk->cfg_gen = gen;
+        return blk;
+    }
+
+    bool deliver(sample_block_t *blk, bool wait)
+    {
+        while (block_queue_push(queue, blk) != OK)
+        {
+            if (!wait) return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return true;
+    }
+};
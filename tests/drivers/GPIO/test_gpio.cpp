@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "drivers/GPIO/gpio_driver.h"
+#include "common_def.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <linux/gpio.h>
+
+// external mock control
+extern bool mock_open_fail;
+extern bool mock_ioctl_fail;
+extern int (*mock_ioctl_handler)(int fd, unsigned long request, void *arg);
+
+// line request model : the returned line fd is the read end of a pipe the test feeds events into
+namespace gpio_model
+{
+    static gpio_v2_line_request last_req;
+    static int event_wr = -1;
+
+    static int handler(int fd, unsigned long request, void *arg)
+    {
+        (void)fd;
+        if (request != GPIO_V2_GET_LINE_IOCTL) return -1;
+
+        int p[2];
+        if (pipe(p) != 0) return -1;
+        auto *req = static_cast<gpio_v2_line_request *>(arg);
+        req->fd = fcntl(p[0], F_DUPFD_CLOEXEC, 512);    // well clear of the mock's fake fds
+        ::close(p[0]);
+        event_wr = p[1];
+        last_req = *req;
+        return 0;
+    }
+
+    static void push(uint64_t t_ns, uint32_t seqno, bool rising)
+    {
+        gpio_v2_line_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.timestamp_ns = t_ns;
+        ev.line_seqno = seqno;
+        ev.id = rising ? GPIO_V2_LINE_EVENT_RISING_EDGE : GPIO_V2_LINE_EVENT_FALLING_EDGE;
+        ASSERT_EQ((ssize_t)sizeof(ev), write(event_wr, &ev, sizeof(ev)));
+    }
+}
+
+class GPIO : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        memset(&gpio_model::last_req, 0, sizeof(gpio_model::last_req));
+        mock_ioctl_handler = gpio_model::handler;
+    }
+    void TearDown() override
+    {
+        mock_ioctl_handler = nullptr;
+        if (gpio_model::event_wr >= 0) ::close(gpio_model::event_wr);
+        gpio_model::event_wr = -1;
+    }
+};
+
+TEST_F(GPIO, open_rejects_bad_arguments)
+{
+    EXPECT_EQ(nullptr, gpio_edge_open(NULL, 17, GPIO_EDGE_RISING, 0));
+    EXPECT_EQ(nullptr, gpio_edge_open(GPIO_CHIP_0, 17, 0, 0));
+}
+
+TEST_F(GPIO, open_fails_on_open_failure)
+{
+    mock_open_fail = true;
+    EXPECT_EQ(nullptr, gpio_edge_open(GPIO_CHIP_0, 17, GPIO_EDGE_RISING, 0));
+    mock_open_fail = false;
+}
+
+TEST_F(GPIO, open_fails_when_line_request_fails)
+{
+    mock_ioctl_fail = true;
+    EXPECT_EQ(nullptr, gpio_edge_open(GPIO_CHIP_0, 17, GPIO_EDGE_RISING, 0));
+    mock_ioctl_fail = false;
+}
+
+TEST_F(GPIO, open_requests_input_with_edges_and_debounce)
+{
+    gpio_handle_t *h = gpio_edge_open(GPIO_CHIP_0, 17, GPIO_EDGE_RISING, 50);
+    ASSERT_NE(nullptr, h);
+
+    const gpio_v2_line_request &req = gpio_model::last_req;
+    EXPECT_EQ(1u, req.num_lines);
+    EXPECT_EQ(17u, req.offsets[0]);
+    EXPECT_EQ((uint64_t)(GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING), req.config.flags);
+    ASSERT_EQ(1u, req.config.num_attrs);
+    EXPECT_EQ((uint32_t)GPIO_V2_LINE_ATTR_ID_DEBOUNCE, req.config.attrs[0].attr.id);
+    EXPECT_EQ(50u, req.config.attrs[0].attr.debounce_period_us);
+    EXPECT_EQ((uint32_t)GPIO_EVENT_BUFFER, req.event_buffer_size);
+
+    // the line fd must never block the acquisition loops
+    EXPECT_TRUE(fcntl(h->line_fd, F_GETFL) & O_NONBLOCK);
+
+    EXPECT_EQ(OK, gpio_edge_close(h));
+}
+
+TEST_F(GPIO, open_without_debounce_sets_no_attribute)
+{
+    gpio_handle_t *h = gpio_edge_open(GPIO_CHIP_0, 4, GPIO_EDGE_RISING | GPIO_EDGE_FALLING, 0);
+    ASSERT_NE(nullptr, h);
+
+    EXPECT_EQ(0u, gpio_model::last_req.config.num_attrs);
+    EXPECT_EQ((uint64_t)(GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING),
+              gpio_model::last_req.config.flags);
+
+    EXPECT_EQ(OK, gpio_edge_close(h));
+}
+
+TEST_F(GPIO, read_returns_nothing_without_blocking)
+{
+    gpio_handle_t *h = gpio_edge_open(GPIO_CHIP_0, 17, GPIO_EDGE_RISING, 0);
+    ASSERT_NE(nullptr, h);
+
+    gpio_edge_t edges[4];
+    size_t n = 99;
+    EXPECT_EQ(OK, gpio_edge_read(h, edges, 4, &n));
+    EXPECT_EQ(0u, n);
+
+    EXPECT_EQ(ERROR, gpio_edge_read(nullptr, edges, 4, &n));
+    EXPECT_EQ(ERROR, gpio_edge_read(h, edges, 0, &n));
+
+    gpio_edge_close(h);
+}
+
+TEST_F(GPIO, read_decodes_events_across_batches)
+{
+    gpio_handle_t *h = gpio_edge_open(GPIO_CHIP_0, 17, GPIO_EDGE_RISING | GPIO_EDGE_FALLING, 0);
+    ASSERT_NE(nullptr, h);
+
+    for (uint32_t i = 0; i < 40; i++) gpio_model::push(1000000ull * (i + 1), i + 1, (i & 1) == 0);
+
+    gpio_edge_t edges[64];
+    size_t n = 0;
+    ASSERT_EQ(OK, gpio_edge_read(h, edges, 30, &n));
+    ASSERT_EQ(30u, n);
+    ASSERT_EQ(OK, gpio_edge_read(h, edges + 30, 34, &n));
+    ASSERT_EQ(10u, n);
+
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        EXPECT_EQ(1000000ull * (i + 1), edges[i].timestamp_ns);
+        EXPECT_EQ(i + 1, edges[i].seqno);
+        EXPECT_EQ((i & 1) == 0, (bool)edges[i].rising);
+    }
+
+    EXPECT_EQ(OK, gpio_edge_read(h, edges, 64, &n));
+    EXPECT_EQ(0u, n);
+
+    gpio_edge_close(h);
+}
+
+TEST_F(GPIO, close_rejects_null)
+{
+    EXPECT_EQ(ERROR, gpio_edge_close(nullptr));
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "drivers/I2C/i2c_driver.h"
+#include "common_def.h"
+#include "../../i2c_device_model.h"
+
+// external mock control
+extern bool mock_open_fail;
+extern bool mock_ioctl_fail;
+
+static const uint16_t dev_addr = 0x48;
+
+class I2C : public testing::Test
+{
+protected:
+    void SetUp() override { i2c_device_model::install(); }
+    void TearDown() override { i2c_device_model::remove(); }
+};
+
+TEST_F(I2C, init_fails_on_null_argument)
+{
+    EXPECT_EQ(nullptr, i2c_init(NULL));
+}
+
+TEST_F(I2C, init_fails_on_open_failure)
+{
+    mock_open_fail = true;
+    EXPECT_EQ(nullptr, i2c_init(I2C_BUS_1));
+    mock_open_fail = false;
+}
+
+TEST_F(I2C, init_fails_without_plain_i2c_support)
+{
+    i2c_device_model::remove();     // funcs left at 0
+    EXPECT_EQ(nullptr, i2c_init(I2C_BUS_1));
+}
+
+TEST_F(I2C, init_success)
+{
+    i2c_handle_t *h = i2c_init(I2C_BUS_1);
+    ASSERT_NE(nullptr, h);
+    EXPECT_EQ(OK, i2c_close(h));
+}
+
+TEST_F(I2C, transfer_rejects_bad_arguments)
+{
+    i2c_handle_t *h = i2c_init(I2C_BUS_1);
+    ASSERT_NE(nullptr, h);
+
+    uint8_t b = 0;
+    i2c_msg_t msgs[I2C_MAX_MSGS + 1];
+    for (auto &m : msgs) m = { dev_addr, I2C_MSG_WRITE, 1, &b };
+
+    EXPECT_EQ(ERROR, i2c_transfer(nullptr, msgs, 1));
+    EXPECT_EQ(ERROR, i2c_transfer(h, msgs, 0));
+    EXPECT_EQ(ERROR, i2c_transfer(h, msgs, I2C_MAX_MSGS + 1));
+
+    i2c_msg_t empty = { dev_addr, I2C_MSG_WRITE, 0, &b };
+    EXPECT_EQ(ERROR, i2c_transfer(h, &empty, 1));
+
+    i2c_close(h);
+}
+
+TEST_F(I2C, reg16_round_trip_is_big_endian)
+{
+    i2c_device_model::regs[dev_addr][0x01] = 0;
+    i2c_handle_t *h = i2c_init(I2C_BUS_1);
+    ASSERT_NE(nullptr, h);
+
+    ASSERT_EQ(OK, i2c_write_reg16(h, dev_addr, 0x01, 0x1234));
+    EXPECT_EQ(0x1234, i2c_device_model::regs[dev_addr][0x01]);
+
+    uint16_t v = 0;
+    ASSERT_EQ(OK, i2c_read_reg16(h, dev_addr, 0x01, &v));
+    EXPECT_EQ(0x1234, v);
+
+    i2c_close(h);
+}
+
+TEST_F(I2C, batched_read_is_one_transaction)
+{
+    for (uint8_t r = 0; r < 6; r++) i2c_device_model::regs[dev_addr][r] = (uint16_t)(0x1000 + r);
+    i2c_handle_t *h = i2c_init(I2C_BUS_1);
+    ASSERT_NE(nullptr, h);
+
+    const uint8_t regs[4] = {5, 0, 3, 1};
+    uint16_t vals[4] = {0};
+    const int calls = i2c_device_model::rdwr_calls;
+    ASSERT_EQ(OK, i2c_read_regs16(h, dev_addr, regs, vals, 4));
+    EXPECT_EQ(calls + 1, i2c_device_model::rdwr_calls);
+    EXPECT_EQ(0x1005, vals[0]);
+    EXPECT_EQ(0x1000, vals[1]);
+    EXPECT_EQ(0x1003, vals[2]);
+    EXPECT_EQ(0x1001, vals[3]);
+
+    EXPECT_EQ(ERROR, i2c_read_regs16(h, dev_addr, regs, vals, I2C_MAX_BATCH_REGS + 1));
+
+    i2c_close(h);
+}
+
+TEST_F(I2C, nack_is_an_error)
+{
+    i2c_handle_t *h = i2c_init(I2C_BUS_1);
+    ASSERT_NE(nullptr, h);
+
+    uint8_t v = 0;
+    EXPECT_EQ(ERROR, i2c_read_reg8(h, 0x77, 0x00, &v));     // nothing at 0x77
+
+    i2c_close(h);
+}
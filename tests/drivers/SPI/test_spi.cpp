@@ -99,3 +99,24 @@ TEST(SPI_ReadReg, SuccessfulRead)
 
     spi_close(h);
 }
+
+TEST(spi_set_speed, fail_on_null_argument)
+{
+    EXPECT_EQ(ERROR, spi_set_speed(nullptr, spi_speed));
+}
+
+TEST(spi_set_speed, keeps_old_speed_on_ioctl_failure)
+{
+    auto h = spi_init(SPI_DEVICE_0, SPI_MODE_0, spi_speed, bits_per_word);
+    ASSERT_NE(h, nullptr);
+
+    mock_ioctl_fail = true;
+    EXPECT_EQ(ERROR, spi_set_speed(h, 1000000));
+    mock_ioctl_fail = false;
+    EXPECT_EQ(spi_speed, h->speed);
+
+    EXPECT_EQ(OK, spi_set_speed(h, 1000000));
+    EXPECT_EQ(1000000u, h->speed);
+
+    spi_close(h);
+}
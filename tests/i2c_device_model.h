@@ -0,0 +1,76 @@
+#pragma once
+
+// Register-file model of I2C slaves behind the mocked ioctl(), for driver and HAL tests
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+
+extern int (*mock_ioctl_handler)(int fd, unsigned long request, void *arg);
+
+struct i2c_device_model
+{
+    // addr -> reg -> 16-bit value (big endian on the wire)
+    static inline std::map<uint16_t, std::map<uint8_t, uint16_t>> regs;
+    static inline std::map<uint16_t, uint8_t> pointer;
+    static inline std::map<uint16_t, std::map<uint8_t, int>> writes;     // write count per register
+    static inline std::map<uint16_t, std::function<void(uint8_t reg, uint16_t &value)>> on_write;   // device side effects
+    static inline int rdwr_calls = 0;
+    static inline bool fail_rdwr = false;
+
+    static int handler(int, unsigned long request, void *arg)
+    {
+        if (request == I2C_FUNCS)
+        {
+            *(unsigned long *)arg = I2C_FUNC_I2C;
+            return 0;
+        }
+        if (request != I2C_RDWR) return 0;
+
+        rdwr_calls++;
+        if (fail_rdwr) return -1;
+
+        auto *xfer = (struct i2c_rdwr_ioctl_data *)arg;
+        for (uint32_t i = 0; i < xfer->nmsgs; i++)
+        {
+            struct i2c_msg &m = xfer->msgs[i];
+            if (!regs.count(m.addr)) return -1;     // NACK
+
+            if (m.flags & I2C_M_RD)
+            {
+                uint16_t v = regs[m.addr][pointer[m.addr]];
+                m.buf[0] = (uint8_t)(v >> 8);
+                if (m.len > 1) m.buf[1] = (uint8_t)(v & 0xFF);
+                continue;
+            }
+
+            pointer[m.addr] = m.buf[0];
+            if (m.len < 2) continue;
+
+            uint16_t v = (m.len == 3) ? (uint16_t)((m.buf[1] << 8) | m.buf[2]) : m.buf[1];
+            if (on_write.count(m.addr)) on_write[m.addr](m.buf[0], v);
+            regs[m.addr][m.buf[0]] = v;
+            writes[m.addr][m.buf[0]]++;
+        }
+        return (int)xfer->nmsgs;
+    }
+
+    static void install()
+    {
+        regs.clear();
+        pointer.clear();
+        writes.clear();
+        on_write.clear();
+        rdwr_calls = 0;
+        fail_rdwr = false;
+        mock_ioctl_handler = handler;
+    }
+
+    static void remove()
+    {
+        mock_ioctl_handler = nullptr;
+    }
+};
@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <unordered_map>
 #include <cstring>
+#include <cstdarg>
+#include <cerrno>
 
 // Fake FD counter
 static int next_fd = 1;
@@ -14,6 +18,12 @@ static std::unordered_map<int, bool> valid_fds;
 bool mock_open_fail = false;
 bool mock_ioctl_fail = false;
 
+// Optional device model : when set, ioctl() on a valid fd returns its result
+int (*mock_ioctl_handler)(int fd, unsigned long request, void *arg) = nullptr;
+
+// Optional path filter : when set, paths it refuses fail to open (e.g. files under /var/lib)
+bool (*mock_open_filter)(const char *pathname) = nullptr;
+
 extern "C" {
 
 // Mock open()
@@ -24,6 +34,12 @@ int open(const char *pathname, int flags, ...)
         return -1; 
     }
 
+    if (mock_open_filter && !mock_open_filter(pathname))
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
     int fd = next_fd++;
     valid_fds[fd] = true; 
 
@@ -43,15 +59,25 @@ int ioctl(int fd, unsigned long request, ...)
         return -1; 
     }
 
+    if (mock_ioctl_handler)
+    {
+        va_list ap;
+        va_start(ap, request);
+        void *arg = va_arg(ap, void *);
+        va_end(ap);
+        return mock_ioctl_handler(fd, request, arg);
+    }
+
     return 0;
 }
 
 // Mock close()
 int close(int fd)
 {
+    // descriptors the mock never handed out (e.g. pipes from device models) are real
     if (!valid_fds.count(fd))
     {
-        return -1;
+        return (int)syscall(SYS_close, fd);
     }
 
     valid_fds.erase(fd);
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "sensors/hal/sensor_hal.h"
+#include "sensors/temperature/tmp117.h"
+#include "sensors/current/ina219.h"
+#include "common_def.h"
+#include "../../i2c_device_model.h"
+
+class sensor_hal : public testing::Test
+{
+protected:
+    i2c_handle_t *i2c = nullptr;
+
+    void SetUp() override
+    {
+        i2c_device_model::install();
+        i2c = i2c_init(I2C_BUS_1);
+        ASSERT_NE(nullptr, i2c);
+    }
+
+    void TearDown() override
+    {
+        i2c_close(i2c);
+        i2c_device_model::remove();
+    }
+
+    sensor_bus_t bus(uint16_t addr) const
+    {
+        sensor_bus_t b = {};
+        b.type = SENSOR_BUS_I2C;
+        b.i2c = i2c;
+        b.i2c_addr = addr;
+        return b;
+    }
+};
+
+TEST(tmp117, raw_conversion)
+{
+    EXPECT_FLOAT_EQ(25.0f, tmp117_raw_to_c(0x0C80));            // 3200 * 7.8125 mC
+    EXPECT_FLOAT_EQ(-0.0078125f, tmp117_raw_to_c(0xFFFF));
+}
+
+TEST(ina219, raw_conversion)
+{
+    EXPECT_FLOAT_EQ(1.0f, ina219_raw_to_current(10000));
+    EXPECT_FLOAT_EQ(-0.5f, ina219_raw_to_current((uint16_t)-5000));
+    EXPECT_FLOAT_EQ(12.0f, ina219_raw_to_bus_v(3000 << 3 | 0x2));    // CNVR flag ignored
+}
+
+TEST_F(sensor_hal, open_rejects_missing_arguments)
+{
+    sensor_bus_t b = bus(TMP117_I2C_ADDR);
+    EXPECT_EQ(nullptr, sensor_open(nullptr, &b));
+    EXPECT_EQ(nullptr, sensor_open(&tmp117_driver, nullptr));
+
+    b.i2c = nullptr;
+    EXPECT_EQ(nullptr, sensor_open(&tmp117_driver, &b));
+}
+
+TEST_F(sensor_hal, probe_fails_on_wrong_id)
+{
+    i2c_device_model::regs[TMP117_I2C_ADDR][TMP117_DEVICE_ID_REG] = 0x0119;
+    sensor_bus_t b = bus(TMP117_I2C_ADDR);
+    EXPECT_EQ(nullptr, sensor_open(&tmp117_driver, &b));
+}
+
+TEST_F(sensor_hal, probe_fails_without_device)
+{
+    sensor_bus_t b = bus(TMP117_I2C_ADDR);
+    EXPECT_EQ(nullptr, sensor_open(&tmp117_driver, &b));
+}
+
+TEST_F(sensor_hal, tmp117_open_configures_and_reads)
+{
+    auto &r = i2c_device_model::regs[TMP117_I2C_ADDR];
+    r[TMP117_DEVICE_ID_REG] = 0x2117;           // revision bits are masked
+    r[TMP117_TEMP_RESULT_REG] = 0x0C80;
+
+    sensor_bus_t b = bus(TMP117_I2C_ADDR);
+    sensor_dev_t *dev = sensor_open(&tmp117_driver, &b);
+    ASSERT_NE(nullptr, dev);
+    EXPECT_EQ(TMP117_CONFIG_1HZ_AVG8, r[TMP117_CONFIG_REG]);
+
+    float v[SENSOR_MAX_CHANNELS] = {0};
+    ASSERT_EQ(OK, sensor_read(dev, v));
+    EXPECT_FLOAT_EQ(25.0f, v[TMP117_CH_TEMP_C]);
+
+    // low-rate devices have no stream
+    uint16_t level = 0;
+    uint8_t ovr = 0;
+    EXPECT_EQ(ERROR, sensor_stream_level(dev, &level, &ovr));
+
+    sensor_close(dev);
+}
+
+TEST_F(sensor_hal, ina219_reset_probe_calibrate_and_batched_read)
+{
+    auto &r = i2c_device_model::regs[INA219_I2C_ADDR];
+    r[INA219_CONFIG_REG] = 0x1234;              // left over from a previous run
+    r[INA219_CURRENT_REG] = 12345;              // 1.2345 A
+    r[INA219_BUS_V_REG] = (uint16_t)(6000 << 3);
+
+    // RST self-clears and restores the power-on default
+    i2c_device_model::on_write[INA219_I2C_ADDR] = [](uint8_t reg, uint16_t &v)
+    {
+        if (reg == INA219_CONFIG_REG && (v & INA219_CONFIG_RESET)) v = INA219_CONFIG_DEFAULT;
+    };
+
+    sensor_bus_t b = bus(INA219_I2C_ADDR);
+    sensor_dev_t *dev = sensor_open(&ina219_driver, &b);
+    ASSERT_NE(nullptr, dev);
+    EXPECT_EQ(INA219_CONFIG_32V_320MV_AVG128, r[INA219_CONFIG_REG]);
+    EXPECT_EQ(INA219_CALIBRATION, r[INA219_CALIBRATION_REG]);
+
+    float v[SENSOR_MAX_CHANNELS] = {0};
+    const int calls = i2c_device_model::rdwr_calls;
+    ASSERT_EQ(OK, sensor_read(dev, v));
+    EXPECT_EQ(calls + 1, i2c_device_model::rdwr_calls);      // current + bus voltage together
+    EXPECT_NEAR(1.2345f, v[INA219_CH_CURRENT_A], 1e-5f);
+    EXPECT_FLOAT_EQ(24.0f, v[INA219_CH_BUS_V]);
+
+    sensor_close(dev);
+}
+
+TEST_F(sensor_hal, ina219_probe_fails_when_reset_does_not_take)
+{
+    i2c_device_model::regs[INA219_I2C_ADDR][INA219_CONFIG_REG] = 0;
+    sensor_bus_t b = bus(INA219_I2C_ADDR);
+    EXPECT_EQ(nullptr, sensor_open(&ina219_driver, &b));
+}
+
+TEST_F(sensor_hal, regs_read_splits_large_batches)
+{
+    auto &r = i2c_device_model::regs[TMP117_I2C_ADDR];
+    r[TMP117_DEVICE_ID_REG] = TMP117_DEVICE_ID_VAL;
+    sensor_bus_t b = bus(TMP117_I2C_ADDR);
+    sensor_dev_t *dev = sensor_open(&tmp117_driver, &b);
+    ASSERT_NE(nullptr, dev);
+
+    const size_t n = I2C_MAX_BATCH_REGS + 3;
+    uint8_t regs[n];
+    uint16_t vals[n];
+    for (size_t i = 0; i < n; i++)
+    {
+        regs[i] = (uint8_t)(0x20 + i);
+        r[regs[i]] = (uint16_t)(0xA000 + i);
+    }
+
+    const int calls = i2c_device_model::rdwr_calls;
+    ASSERT_EQ(OK, sensor_regs_read(dev, regs, vals, n));
+    EXPECT_EQ(calls + 2, i2c_device_model::rdwr_calls);
+    for (size_t i = 0; i < n; i++) EXPECT_EQ(0xA000 + i, vals[i]);
+
+    sensor_close(dev);
+}
+
+TEST_F(sensor_hal, attach_skips_probe_and_keeps_priv)
+{
+    int priv = 0;
+    sensor_bus_t b = bus(0x10);                 // no device there, attach must not touch the bus
+    const int calls = i2c_device_model::rdwr_calls;
+    sensor_dev_t *dev = sensor_attach(&tmp117_driver, &b, &priv);
+    ASSERT_NE(nullptr, dev);
+    EXPECT_EQ(&priv, dev->priv);
+    EXPECT_EQ(calls, i2c_device_model::rdwr_calls);
+    sensor_close(dev);
+}
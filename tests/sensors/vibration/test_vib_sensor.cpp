@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "sensors/vibration/vib_sensor.h"
 #include "common_def.h"
+#include "../../spi_device_model.h"
 
 // Global test parameters
 static uint32_t spi_speed = 25000000;
@@ -12,3 +13,97 @@ TEST(VIB_init, fails_on_null_argument)
     EXPECT_EQ(nullptr, vib_sensor);
 }
 
+
+class VIB_model : public ::testing::Test
+{
+protected:
+    vib_sensor_t *dev = nullptr;
+
+    void SetUp() override
+    {
+        spi_device_model::install();
+        spi_device_model::regs[IIS3DWB_WHO_AM_I_REG] = IIS3DWB_WHO_AM_I_VAL;
+        dev = vib_sensor_init("/dev/spidev0.0", SPI_MODE_0, spi_speed, bits_per_word);
+        ASSERT_NE(nullptr, dev);
+    }
+
+    void TearDown() override
+    {
+        if (dev) vib_sensor_close(dev);
+        spi_device_model::remove();
+    }
+};
+
+TEST_F(VIB_model, power_toggles_xl_en_and_keeps_full_scale)
+{
+    ASSERT_EQ(OK, vib_sensor_config(dev, IIS3DWB_FS_8G, 1));
+    EXPECT_EQ(0xAE, spi_device_model::regs[IIS3DWB_CTRL1_XL_REG]);
+
+    ASSERT_EQ(OK, vib_sensor_power(dev, 0));
+    EXPECT_EQ(0x0E, spi_device_model::regs[IIS3DWB_CTRL1_XL_REG]);
+
+    ASSERT_EQ(OK, vib_sensor_power(dev, 1));
+    EXPECT_EQ(0xAE, spi_device_model::regs[IIS3DWB_CTRL1_XL_REG]);
+}
+
+TEST_F(VIB_model, wakeup_threshold_uses_fine_weight_when_it_fits)
+{
+    ASSERT_EQ(OK, vib_sensor_config(dev, IIS3DWB_FS_2G, 0));
+
+    // 2 g / 256 = 7.8 mg per LSB : 0.25 g -> 32
+    ASSERT_EQ(OK, vib_sensor_wakeup_config(dev, 0.25f));
+    EXPECT_EQ(32, spi_device_model::regs[IIS3DWB_WAKE_UP_THS_REG]);
+    EXPECT_EQ(0x10, spi_device_model::regs[IIS3DWB_WAKE_UP_DUR_REG]);
+    EXPECT_EQ(0x20, spi_device_model::regs[IIS3DWB_MD1_CFG_REG]);
+    EXPECT_EQ(0x80, spi_device_model::regs[IIS3DWB_INTERRUPTS_EN_REG]);
+    EXPECT_EQ(0x01, spi_device_model::regs[IIS3DWB_SLOPE_EN_REG]);
+}
+
+TEST_F(VIB_model, wakeup_threshold_switches_to_coarse_weight_and_clamps)
+{
+    ASSERT_EQ(OK, vib_sensor_config(dev, IIS3DWB_FS_2G, 0));
+
+    // 2 g / 64 = 31.25 mg per LSB : 1 g -> 32, clearing a fine weight left from before
+    spi_device_model::regs[IIS3DWB_WAKE_UP_DUR_REG] = 0x10;
+    ASSERT_EQ(OK, vib_sensor_wakeup_config(dev, 1.0f));
+    EXPECT_EQ(32, spi_device_model::regs[IIS3DWB_WAKE_UP_THS_REG]);
+    EXPECT_EQ(0x00, spi_device_model::regs[IIS3DWB_WAKE_UP_DUR_REG]);
+
+    ASSERT_EQ(OK, vib_sensor_wakeup_config(dev, 10.0f));
+    EXPECT_EQ(63, spi_device_model::regs[IIS3DWB_WAKE_UP_THS_REG]);
+
+    ASSERT_EQ(OK, vib_sensor_wakeup_config(dev, 0.0f));
+    EXPECT_EQ(0x00, spi_device_model::regs[IIS3DWB_MD1_CFG_REG]);
+    EXPECT_EQ(0x00, spi_device_model::regs[IIS3DWB_INTERRUPTS_EN_REG]);
+
+    EXPECT_EQ(ERROR, vib_sensor_wakeup_config(dev, -1.0f));
+}
+
+TEST_F(VIB_model, wakeup_status_reports_latched_event_once)
+{
+    spi_device_model::regs[IIS3DWB_WAKE_UP_SRC_REG] = 0x08;
+    spi_device_model::clear_on_read[IIS3DWB_WAKE_UP_SRC_REG] = 0x08;
+
+    uint8_t triggered = 0;
+    ASSERT_EQ(OK, vib_sensor_wakeup_status(dev, &triggered));
+    EXPECT_EQ(1, triggered);
+    ASSERT_EQ(OK, vib_sensor_wakeup_status(dev, &triggered));
+    EXPECT_EQ(0, triggered);
+}
+
+TEST_F(VIB_model, fifo_level_decodes_status_registers)
+{
+    // 0x1A5 unread words with FIFO_OVR_IA set
+    spi_device_model::regs[IIS3DWB_FIFO_STATUS1_REG] = 0xA5;
+    spi_device_model::regs[IIS3DWB_FIFO_STATUS2_REG] = 0x41;
+
+    uint16_t level = 0;
+    uint8_t overrun = 0;
+    ASSERT_EQ(OK, vib_sensor_fifo_level(dev, &level, &overrun));
+    EXPECT_EQ(0x1A5, level);
+    EXPECT_EQ(1, overrun);
+
+    spi_device_model::regs[IIS3DWB_FIFO_STATUS2_REG] = 0x00;
+    ASSERT_EQ(OK, vib_sensor_fifo_level(dev, &level, nullptr));
+    EXPECT_EQ(0xA5, level);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+// Register-file model of an SPI slave behind the mocked ioctl(), for sensor driver tests
+#include <linux/spi/spidev.h>
+#include <sys/ioctl.h>
+
+#include <cstdint>
+#include <map>
+
+extern int (*mock_ioctl_handler)(int fd, unsigned long request, void *arg);
+
+struct spi_device_model
+{
+    // tx[0] = address, bit 7 set for a read; reads and writes auto-increment
+    static inline std::map<uint8_t, uint8_t> regs;
+    static inline std::map<uint8_t, int> writes;        // write count per register
+    static inline std::map<uint8_t, uint8_t> clear_on_read;   // bits cleared after a read (latched flags)
+
+    static int handler(int, unsigned long request, void *arg)
+    {
+        if (request != SPI_IOC_MESSAGE(1)) return 0;
+
+        auto *tr = (struct spi_ioc_transfer *)arg;
+        auto *tx = (const uint8_t *)(uintptr_t)tr->tx_buf;
+        auto *rx = (uint8_t *)(uintptr_t)tr->rx_buf;
+        if (!tx || tr->len == 0) return -1;
+
+        const bool read = tx[0] & 0x80;
+        const uint8_t start = tx[0] & 0x7F;
+        if (rx) rx[0] = 0;
+        for (uint32_t i = 1; i < tr->len; i++)
+        {
+            const uint8_t reg = (uint8_t)(start + i - 1);
+            if (read)
+            {
+                if (rx) rx[i] = regs[reg];
+                if (clear_on_read.count(reg)) regs[reg] &= (uint8_t)~clear_on_read[reg];
+                continue;
+            }
+            regs[reg] = tx[i];
+            writes[reg]++;
+        }
+        return (int)tr->len;
+    }
+
+    static void install()
+    {
+        regs.clear();
+        writes.clear();
+        clear_on_read.clear();
+        mock_ioctl_handler = handler;
+    }
+
+    static void remove()
+    {
+        mock_ioctl_handler = nullptr;
+    }
+};
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "utilities/block_pool/block_pool.h"
+#include "utilities/block_queue/block_queue.h"
+#include "common_def.h"
+
+#include <thread>
+#include <vector>
+
+static block_pool_cfg_t test_cfg(size_t n_blocks)
+{
+    block_pool_cfg_t cfg = {};
+    cfg.n_blocks = n_blocks;
+    cfg.payload_size = 512 * 6;
+    cfg.policy = BLOCK_POOL_EXHAUST_DROP;
+    return cfg;
+}
+
+TEST(block_pool_init, fails_on_zero_blocks)
+{
+    block_pool_cfg_t cfg = test_cfg(0);
+    EXPECT_EQ(nullptr, block_pool_init(&cfg));
+}
+
+TEST(block_pool_acquire, exhaustion_is_counted_not_allocated)
+{
+    block_pool_cfg_t cfg = test_cfg(4);
+    block_pool_t *pool = block_pool_init(&cfg);
+    ASSERT_NE(nullptr, pool);
+
+    sample_block_t *blks[4];
+    for (auto &b : blks)
+    {
+        b = block_pool_acquire(pool);
+        ASSERT_NE(nullptr, b);
+        EXPECT_EQ(0u, (uintptr_t)b->data % 64);
+    }
+    EXPECT_EQ(nullptr, block_pool_acquire(pool));
+
+    block_pool_stats_t st = {};
+    ASSERT_EQ(OK, block_pool_stats(pool, &st));
+    EXPECT_EQ(4u, st.acquired);
+    EXPECT_EQ(1u, st.exhausted);
+    EXPECT_EQ(4u, st.in_use);
+    EXPECT_EQ(4u, st.in_use_max);
+
+    for (auto b : blks) ASSERT_EQ(OK, block_release(b));
+    ASSERT_EQ(OK, block_pool_stats(pool, &st));
+    EXPECT_EQ(0u, st.in_use);
+
+    block_pool_free(pool);
+}
+
+TEST(block_pool_acquire, wait_policy_times_out)
+{
+    block_pool_cfg_t cfg = test_cfg(1);
+    cfg.policy = BLOCK_POOL_EXHAUST_WAIT;
+    cfg.wait_timeout_us = 200;
+    block_pool_t *pool = block_pool_init(&cfg);
+    ASSERT_NE(nullptr, pool);
+
+    sample_block_t *blk = block_pool_acquire(pool);
+    ASSERT_NE(nullptr, blk);
+    EXPECT_EQ(nullptr, block_pool_acquire(pool));
+
+    // a release during the wait satisfies the acquire
+    cfg.wait_timeout_us = 1000000;
+    block_pool_t *pool2 = block_pool_init(&cfg);
+    sample_block_t *held = block_pool_acquire(pool2);
+    std::thread releaser([&] { block_release(held); });
+    sample_block_t *waited = block_pool_acquire(pool2);
+    EXPECT_NE(nullptr, waited);
+    releaser.join();
+
+    block_release(waited);
+    block_pool_free(pool2);
+    block_release(blk);
+    block_pool_free(pool);
+}
+
+TEST(block_release, last_reference_returns_block)
+{
+    block_pool_cfg_t cfg = test_cfg(1);
+    block_pool_t *pool = block_pool_init(&cfg);
+    ASSERT_NE(nullptr, pool);
+
+    sample_block_t *blk = block_pool_acquire(pool);
+    ASSERT_NE(nullptr, blk);
+    ASSERT_EQ(OK, block_ref(blk, 2));      // three holders
+
+    ASSERT_EQ(OK, block_release(blk));
+    ASSERT_EQ(OK, block_release(blk));
+    EXPECT_EQ(nullptr, block_pool_acquire(pool));  // still held once
+    ASSERT_EQ(OK, block_release(blk));
+    EXPECT_EQ(blk, block_pool_acquire(pool));
+
+    block_release(blk);
+    EXPECT_EQ(ERROR, block_release(blk));   // double release is caught
+    block_pool_free(pool);
+}
+
+TEST(block_queue, fifo_order_and_bounds)
+{
+    block_queue_t *q = block_queue_init(3);    // rounds up to 4
+    ASSERT_NE(nullptr, q);
+
+    sample_block_t blks[5] = {};
+    for (int i = 0; i < 4; i++) ASSERT_EQ(OK, block_queue_push(q, &blks[i]));
+    EXPECT_EQ(ERROR, block_queue_push(q, &blks[4]));
+    EXPECT_EQ(4u, block_queue_count(q));
+
+    sample_block_t *out = nullptr;
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_EQ(OK, block_queue_pop(q, &out));
+        EXPECT_EQ(&blks[i], out);
+    }
+    EXPECT_EQ(ERROR, block_queue_pop(q, &out));
+
+    block_queue_free(q);
+}
+
+TEST(block_pool, fan_out_across_threads_returns_every_block)
+{
+    const int n_consumers = 3;
+    const int n_blocks = 20000;
+    block_pool_cfg_t cfg = test_cfg(16);
+    block_pool_t *pool = block_pool_init(&cfg);
+    ASSERT_NE(nullptr, pool);
+
+    std::vector<block_queue_t *> queues;
+    for (int c = 0; c < n_consumers; c++) queues.push_back(block_queue_init(8));
+
+    std::vector<std::thread> consumers;
+    std::vector<uint64_t> seq_sum(n_consumers, 0);
+    for (int c = 0; c < n_consumers; c++)
+    {
+        consumers.emplace_back([&, c] {
+            int got = 0;
+            sample_block_t *blk = nullptr;
+            while (got < n_blocks)
+            {
+                if (block_queue_pop(queues[c], &blk) != OK) continue;
+                seq_sum[c] += blk->seq;
+                block_release(blk);
+                got++;
+            }
+        });
+    }
+
+    for (int i = 0; i < n_blocks; i++)
+    {
+        sample_block_t *blk = nullptr;
+        while (!(blk = block_pool_acquire(pool))) std::this_thread::yield();
+        blk->seq = (uint64_t)i;
+        block_ref(blk, n_consumers - 1);
+        for (auto q : queues)
+        {
+            while (block_queue_push(q, blk) != OK) std::this_thread::yield();
+        }
+    }
+
+    for (auto &t : consumers) t.join();
+
+    const uint64_t expect = (uint64_t)n_blocks * (n_blocks - 1) / 2;
+    for (int c = 0; c < n_consumers; c++) EXPECT_EQ(expect, seq_sum[c]);
+
+    block_pool_stats_t st = {};
+    block_pool_stats(pool, &st);
+    EXPECT_EQ(0u, st.in_use);
+    EXPECT_LE(st.in_use_max, 16u);
+
+    for (auto q : queues) block_queue_free(q);
+    block_pool_free(pool);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "utilities/latency_hist/latency_hist.h"
+#include "common_def.h"
+
+TEST(latency_hist_bucket, bounds_contain_value)
+{
+    const uint64_t values[] = {1024, 1500, 2047, 2048, 100000, 38000000, 1000000000ull, (1ull << 36) - 1};
+    for (uint64_t v : values)
+    {
+        const size_t b = latency_hist_bucket(v);
+        ASSERT_LT(b, (size_t)LATENCY_HIST_BUCKETS);
+        EXPECT_LE(v, latency_hist_bucket_upper(b)) << v;
+        if (b > 0) EXPECT_GT(v, latency_hist_bucket_upper(b - 1)) << v;
+    }
+}
+
+TEST(latency_hist_bucket, relative_error_is_bounded)
+{
+    for (uint64_t v = 1024; v < (1ull << 34); v = v * 5 / 4 + 1)
+    {
+        const uint64_t upper = latency_hist_bucket_upper(latency_hist_bucket(v));
+        EXPECT_LE((double)(upper - v) / (double)v, 0.125) << v;
+    }
+}
+
+TEST(latency_hist_bucket, clamps_out_of_range)
+{
+    EXPECT_EQ(0u, latency_hist_bucket(0));
+    EXPECT_EQ((size_t)LATENCY_HIST_BUCKETS - 1, latency_hist_bucket(UINT64_MAX));
+}
+
+TEST(latency_hist, empty_has_no_percentile)
+{
+    latency_hist_t *h = latency_hist_init();
+    ASSERT_NE(nullptr, h);
+
+    uint64_t ns = 0;
+    EXPECT_EQ(ERROR, latency_hist_percentile(h, 0.5, &ns));
+
+    latency_summary_t s;
+    EXPECT_EQ(ERROR, latency_hist_summary(h, &s));
+
+    latency_hist_free(h);
+}
+
+TEST(latency_hist, percentiles_of_uniform_distribution)
+{
+    latency_hist_t *h = latency_hist_init();
+    ASSERT_NE(nullptr, h);
+
+    // 1..1000 us
+    for (uint64_t us = 1; us <= 1000; us++) latency_hist_record(h, us * 1000);
+
+    latency_summary_t s;
+    ASSERT_EQ(OK, latency_hist_summary(h, &s));
+    EXPECT_EQ(1000u, s.count);
+    EXPECT_EQ(1000u, s.min_ns);
+    EXPECT_EQ(1000000u, s.max_ns);
+    EXPECT_NEAR(500500.0, (double)s.mean_ns, 1.0);
+
+    // bucket upper bounds, within the 12.5% resolution
+    EXPECT_GE(s.p50_ns, 500000u);
+    EXPECT_LE(s.p50_ns, 562500u);
+    EXPECT_GE(s.p99_ns, 990000u);
+    EXPECT_LE(s.p99_ns, 1000000u);
+    EXPECT_EQ(1000000u, s.p999_ns);
+
+    latency_hist_reset(h);
+    EXPECT_EQ(ERROR, latency_hist_summary(h, &s));
+
+    latency_hist_free(h);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "utilities/rcu_cfg/rcu_cfg.h"
+#include "common_def.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct test_cfg
+{
+    uint64_t a;
+    uint64_t b;     // always ~a when published
+};
+
+TEST(rcu_cfg_init, rejects_bad_arguments)
+{
+    test_cfg c = {1, ~1ull};
+    EXPECT_EQ(nullptr, rcu_cfg_init(0, &c, 1));
+    EXPECT_EQ(nullptr, rcu_cfg_init(sizeof(c), nullptr, 1));
+    EXPECT_EQ(nullptr, rcu_cfg_init(sizeof(c), &c, RCU_CFG_MAX_READERS + 1));
+}
+
+TEST(rcu_cfg_read, sees_each_publish_with_its_generation)
+{
+    test_cfg c = {1, ~1ull};
+    rcu_cfg_t *rc = rcu_cfg_init(sizeof(c), &c, 1);
+    ASSERT_NE(nullptr, rc);
+
+    // the initial copy is owned by the rcu_cfg
+    c.a = 99;
+    uint32_t gen = 0;
+    const test_cfg *r = (const test_cfg *)rcu_cfg_read(rc, 0, &gen);
+    ASSERT_NE(nullptr, r);
+    EXPECT_EQ(1u, gen);
+    EXPECT_EQ(1u, r->a);
+    EXPECT_EQ(OK, rcu_cfg_quiescent(rc, 0));
+
+    c = {2, ~2ull};
+    uint32_t pub_gen = 0;
+    ASSERT_EQ(OK, rcu_cfg_publish(rc, &c, &pub_gen));
+    EXPECT_EQ(2u, pub_gen);
+    r = (const test_cfg *)rcu_cfg_read(rc, 0, &gen);
+    EXPECT_EQ(2u, gen);
+    EXPECT_EQ(2u, r->a);
+
+    EXPECT_EQ(nullptr, rcu_cfg_read(rc, 1, &gen));
+    EXPECT_EQ(ERROR, rcu_cfg_quiescent(rc, 1));
+    EXPECT_EQ(OK, rcu_cfg_free(rc));
+}
+
+TEST(rcu_cfg_publish, replaced_copy_lives_until_every_reader_reports)
+{
+    test_cfg c = {1, ~1ull};
+    rcu_cfg_t *rc = rcu_cfg_init(sizeof(c), &c, 2);
+    ASSERT_NE(nullptr, rc);
+
+    // both readers hold generation 1
+    const test_cfg *r0 = (const test_cfg *)rcu_cfg_read(rc, 0, nullptr);
+    const test_cfg *r1 = (const test_cfg *)rcu_cfg_read(rc, 1, nullptr);
+
+    c = {2, ~2ull};
+    ASSERT_EQ(OK, rcu_cfg_publish(rc, &c, nullptr));
+    EXPECT_EQ(1u, rcu_cfg_retired(rc));
+    EXPECT_EQ(1u, r0->a);       // still valid, neither reader has reported
+    EXPECT_EQ(1u, r1->a);
+
+    ASSERT_EQ(OK, rcu_cfg_quiescent(rc, 0));
+    c = {3, ~3ull};
+    ASSERT_EQ(OK, rcu_cfg_publish(rc, &c, nullptr));
+    EXPECT_EQ(2u, rcu_cfg_retired(rc));     // reader 1 still holds generation 1
+    EXPECT_EQ(1u, r1->a);
+
+    ASSERT_EQ(OK, rcu_cfg_quiescent(rc, 0));
+    ASSERT_EQ(OK, rcu_cfg_quiescent(rc, 1));
+    c = {4, ~4ull};
+    ASSERT_EQ(OK, rcu_cfg_publish(rc, &c, nullptr));
+    EXPECT_EQ(1u, rcu_cfg_retired(rc));     // only generation 3, replaced just now
+
+    EXPECT_EQ(OK, rcu_cfg_free(rc));
+}
+
+TEST(rcu_cfg_publish, stalled_reader_bounds_the_retired_copies)
+{
+    test_cfg c = {0, ~0ull};
+    rcu_cfg_t *rc = rcu_cfg_init(sizeof(c), &c, 2);
+    ASSERT_NE(nullptr, rc);
+
+    for (uint64_t i = 1; i <= RCU_CFG_MAX_RETIRED; i++)
+    {
+        c = {i, ~i};
+        ASSERT_EQ(OK, rcu_cfg_publish(rc, &c, nullptr));
+        ASSERT_EQ(OK, rcu_cfg_quiescent(rc, 0));
+    }
+
+    // reader 1 never reported : the writer refuses instead of growing
+    c = {100, ~100ull};
+    uint32_t gen = 0;
+    EXPECT_EQ(ERROR, rcu_cfg_publish(rc, &c, &gen));
+    EXPECT_EQ((size_t)RCU_CFG_MAX_RETIRED, rcu_cfg_retired(rc));
+
+    ASSERT_EQ(OK, rcu_cfg_quiescent(rc, 1));
+    ASSERT_EQ(OK, rcu_cfg_publish(rc, &c, &gen));
+    EXPECT_EQ(RCU_CFG_MAX_RETIRED + 2u, gen);
+
+    EXPECT_EQ(OK, rcu_cfg_free(rc));
+}
+
+TEST(rcu_cfg_read, concurrent_readers_never_see_a_torn_copy)
+{
+    test_cfg c = {0, ~0ull};
+    const uint32_t n_readers = 3;
+    rcu_cfg_t *rc = rcu_cfg_init(sizeof(c), &c, n_readers);
+    ASSERT_NE(nullptr, rc);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> bad{0};
+    std::vector<std::thread> readers;
+    for (uint32_t r = 0; r < n_readers; r++)
+    {
+        readers.emplace_back([&, r]() {
+            uint32_t last_gen = 0;
+            while (!stop.load())
+            {
+                uint32_t gen = 0;
+                const test_cfg *p = (const test_cfg *)rcu_cfg_read(rc, r, &gen);
+                if (p->b != ~p->a || p->a + 1 != gen || gen < last_gen) bad++;
+                last_gen = gen;
+                rcu_cfg_quiescent(rc, r);
+            }
+        });
+    }
+
+    uint64_t published = 0;
+    while (published < 20000)
+    {
+        c = {published + 1, ~(published + 1)};
+        if (rcu_cfg_publish(rc, &c, nullptr) == OK) published++;
+        else std::this_thread::yield();
+    }
+
+    stop = true;
+    for (auto &t : readers) t.join();
+    EXPECT_EQ(0u, bad.load());
+    EXPECT_EQ(OK, rcu_cfg_free(rc));
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "utilities/snapshot/snapshot.h"
+#include "common_def.h"
+
+#include <atomic>
+#include <thread>
+
+struct test_payload
+{
+    uint64_t a;
+    uint64_t b;     // always equal to a when published
+    uint64_t c;     // always equal to ~a when published
+};
+
+TEST(snapshot_init, fails_on_zero_size)
+{
+    EXPECT_EQ(nullptr, snapshot_init(0));
+}
+
+TEST(snapshot_read, unpublished_has_generation_zero)
+{
+    snapshot_t *snap = snapshot_init(sizeof(test_payload));
+    ASSERT_NE(nullptr, snap);
+
+    test_payload out = {1, 1, 1};
+    uint64_t gen = 99;
+    ASSERT_EQ(OK, snapshot_read(snap, &out, &gen));
+    EXPECT_EQ(0u, gen);
+    EXPECT_EQ(0u, out.a);
+
+    snapshot_free(snap);
+}
+
+TEST(snapshot_read, returns_latest_publish)
+{
+    snapshot_t *snap = snapshot_init(sizeof(test_payload));
+    ASSERT_NE(nullptr, snap);
+
+    for (uint64_t i = 1; i <= 3; i++)
+    {
+        test_payload in = {i, i, ~i};
+        ASSERT_EQ(OK, snapshot_publish(snap, &in));
+    }
+
+    test_payload out = {};
+    uint64_t gen = 0;
+    ASSERT_EQ(OK, snapshot_read(snap, &out, &gen));
+    EXPECT_EQ(3u, gen);
+    EXPECT_EQ(3u, out.a);
+    EXPECT_EQ(3u, out.b);
+
+    snapshot_free(snap);
+}
+
+TEST(snapshot_read, never_observes_torn_payload)
+{
+    snapshot_t *snap = snapshot_init(sizeof(test_payload));
+    ASSERT_NE(nullptr, snap);
+
+    std::atomic<bool> run{true};
+    std::thread writer([&] {
+        uint64_t i = 0;
+        while (run.load())
+        {
+            i++;
+            test_payload in = {i, i, ~i};
+            snapshot_publish(snap, &in);
+        }
+    });
+
+    uint64_t last = 0;
+    bool torn = false;
+    bool backwards = false;
+    for (int i = 0; i < 200000 && !torn && !backwards; i++)
+    {
+        test_payload out = {};
+        uint64_t gen = 0;
+        if (snapshot_read(snap, &out, &gen) != OK || gen == 0) continue;
+        torn = (out.a != out.b) || (~out.a != out.c);
+        backwards = out.a < last;
+        last = out.a;
+    }
+
+    run.store(false);
+    writer.join();
+    snapshot_free(snap);
+
+    EXPECT_FALSE(torn);
+    EXPECT_FALSE(backwards);
+}
+
+TEST(snapshot_read, generation_matches_the_payload_it_comes_with)
+{
+    snapshot_t *snap = snapshot_init(sizeof(test_payload));
+    ASSERT_NE(nullptr, snap);
+
+    // publish i carries a == i, so a read must return generation == a
+    std::atomic<bool> run{true};
+    std::thread writer([&] {
+        uint64_t i = 0;
+        while (run.load())
+        {
+            i++;
+            test_payload in = {i, i, ~i};
+            snapshot_publish(snap, &in);
+        }
+    });
+
+    uint64_t mismatches = 0;
+    for (int i = 0; i < 200000; i++)
+    {
+        test_payload out = {};
+        uint64_t gen = 0;
+        if (snapshot_read(snap, &out, &gen) != OK) continue;
+        if (gen != out.a) mismatches++;
+    }
+
+    run.store(false);
+    writer.join();
+    snapshot_free(snap);
+
+    EXPECT_EQ(0u, mismatches);
+}
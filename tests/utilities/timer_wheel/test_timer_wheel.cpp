@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "utilities/timer_wheel/timer_wheel.h"
+#include "common_def.h"
+
+#include <vector>
+
+struct fire_log
+{
+    std::vector<uint64_t> at;
+};
+
+static void record(void *arg, uint64_t now_ms)
+{
+    static_cast<fire_log *>(arg)->at.push_back(now_ms);
+}
+
+TEST(timer_wheel, init_rejects_zero_tick)
+{
+    EXPECT_EQ(nullptr, timer_wheel_init(0, 0));
+}
+
+TEST(timer_wheel, periodic_timer_fires_each_period)
+{
+    timer_wheel_t *tw = timer_wheel_init(10, 1000);
+    ASSERT_NE(nullptr, tw);
+
+    fire_log log;
+    ASSERT_GE(timer_wheel_add(tw, 100, record, &log), 0);
+
+    for (uint64_t t = 1000; t <= 1500; t += 10) timer_wheel_advance(tw, t, 0);
+
+    ASSERT_EQ(5u, log.at.size());
+    for (size_t i = 0; i < log.at.size(); i++) EXPECT_EQ(1100 + 100 * i, log.at[i]);
+
+    timer_wheel_free(tw);
+}
+
+TEST(timer_wheel, periods_longer_than_one_lap)
+{
+    // 64 slots * 10 ms = 640 ms per lap
+    timer_wheel_t *tw = timer_wheel_init(10, 0);
+    ASSERT_NE(nullptr, tw);
+
+    fire_log slow, fast;
+    ASSERT_GE(timer_wheel_add(tw, 1000, record, &slow), 0);
+    ASSERT_GE(timer_wheel_add(tw, 360, record, &fast), 0);
+
+    for (uint64_t t = 0; t <= 3000; t += 10) timer_wheel_advance(tw, t, 0);
+
+    ASSERT_EQ(3u, slow.at.size());
+    EXPECT_EQ(1000u, slow.at[0]);
+    EXPECT_EQ(3000u, slow.at[2]);
+    EXPECT_EQ(8u, fast.at.size());
+
+    timer_wheel_free(tw);
+}
+
+TEST(timer_wheel, budget_defers_remaining_timers)
+{
+    timer_wheel_t *tw = timer_wheel_init(10, 0);
+    ASSERT_NE(nullptr, tw);
+
+    fire_log a, b, c;
+    timer_wheel_add(tw, 100, record, &a);
+    timer_wheel_add(tw, 100, record, &b);
+    timer_wheel_add(tw, 100, record, &c);
+
+    EXPECT_EQ(1, timer_wheel_advance(tw, 100, 1));
+    EXPECT_EQ(1, timer_wheel_advance(tw, 105, 1));
+    EXPECT_EQ(1, timer_wheel_advance(tw, 110, 1));
+    EXPECT_EQ(0, timer_wheel_advance(tw, 120, 1));
+    EXPECT_EQ(1u, a.at.size());
+    EXPECT_EQ(1u, b.at.size());
+    EXPECT_EQ(1u, c.at.size());
+
+    timer_wheel_free(tw);
+}
+
+TEST(timer_wheel, late_advance_skips_missed_periods)
+{
+    timer_wheel_t *tw = timer_wheel_init(10, 0);
+    ASSERT_NE(nullptr, tw);
+
+    fire_log log;
+    timer_wheel_add(tw, 100, record, &log);
+
+    // loop stalled for ~1 s : one catch-up call, not ten
+    EXPECT_EQ(1, timer_wheel_advance(tw, 1050, 0));
+    EXPECT_EQ(0, timer_wheel_advance(tw, 1140, 0));
+    EXPECT_EQ(1, timer_wheel_advance(tw, 1150, 0));
+
+    timer_wheel_free(tw);
+}
+
+TEST(timer_wheel, cancel_and_capacity)
+{
+    timer_wheel_t *tw = timer_wheel_init(1, 0);
+    ASSERT_NE(nullptr, tw);
+
+    fire_log log;
+    int ids[TIMER_WHEEL_MAX_TIMERS];
+    for (int i = 0; i < TIMER_WHEEL_MAX_TIMERS; i++)
+    {
+        ids[i] = timer_wheel_add(tw, 5, record, &log);
+        ASSERT_GE(ids[i], 0);
+    }
+    EXPECT_EQ(ERROR, timer_wheel_add(tw, 5, record, &log));
+
+    for (int i = 1; i < TIMER_WHEEL_MAX_TIMERS; i++) EXPECT_EQ(OK, timer_wheel_cancel(tw, ids[i]));
+    EXPECT_EQ(ERROR, timer_wheel_cancel(tw, ids[1]));
+
+    EXPECT_EQ(1, timer_wheel_advance(tw, 5, 0));
+    EXPECT_GE(timer_wheel_add(tw, 5, record, &log), 0);
+
+    timer_wheel_free(tw);
+}
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include "utilities/trace/trace.h"
+#include "common_def.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct dumped_thread
+{
+    uint32_t tid;
+    std::string name;
+    std::vector<trace_event_t> events;
+};
+
+// parse the file written by trace_dump(), same layout as scripts/trace_to_json.py reads
+static bool load_dump(const char *path, std::vector<std::string> &points, std::vector<dumped_thread> &threads)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return false;
+
+    uint32_t hdr[3];
+    bool ok = fread(hdr, sizeof(hdr), 1, fp) == 1 && hdr[0] == 0x43525445u && hdr[1] == 1u;
+    for (uint32_t p = 0; ok && p < hdr[2]; p++)
+    {
+        char name[TRACE_NAME_LEN];
+        ok = fread(name, sizeof(name), 1, fp) == 1;
+        points.emplace_back(name, strnlen(name, sizeof(name)));
+    }
+
+    uint32_t n_threads = 0;
+    ok = ok && fread(&n_threads, sizeof(n_threads), 1, fp) == 1;
+    for (uint32_t t = 0; ok && t < n_threads; t++)
+    {
+        dumped_thread th;
+        char name[TRACE_NAME_LEN];
+        uint32_t n = 0;
+        ok = fread(&th.tid, sizeof(th.tid), 1, fp) == 1 && fread(name, sizeof(name), 1, fp) == 1 &&
+             fread(&n, sizeof(n), 1, fp) == 1;
+        th.name.assign(name, strnlen(name, sizeof(name)));
+        th.events.resize(n);
+        ok = ok && (n == 0 || fread(th.events.data(), sizeof(trace_event_t), n, fp) == n);
+        threads.push_back(th);
+    }
+
+    fclose(fp);
+    return ok;
+}
+
+static const dumped_thread *find_thread(const std::vector<dumped_thread> &threads, const char *name)
+{
+    for (const auto &t : threads) if (t.name == name) return &t;
+    return nullptr;
+}
+
+// macros are no-ops in a build configured with -DEDGE_TRACE=OFF
+#ifdef EDGE_TRACE
+#define REQUIRE_TRACEPOINTS()   do { } while (0)
+#else
+#define REQUIRE_TRACEPOINTS()   GTEST_SKIP() << "tracepoints compiled out"
+#endif
+
+static std::string dump_path()
+{
+    return std::string(testing::TempDir()) + "test_trace.bin";
+}
+
+TEST(trace, event_layout_is_fixed)
+{
+    EXPECT_EQ(24u, sizeof(trace_event_t));
+}
+
+TEST(trace, disabled_records_nothing)
+{
+    trace_enable(1);
+    ASSERT_EQ(OK, trace_thread_register("gtest_main"));
+    trace_reset();
+    trace_enable(0);
+
+    TRACE_BEGIN(TRACE_FEATURES, 1);
+    TRACE_END(TRACE_FEATURES, 1);
+
+    std::vector<std::string> points;
+    std::vector<dumped_thread> threads;
+    ASSERT_EQ(OK, trace_dump(dump_path().c_str()));
+    ASSERT_TRUE(load_dump(dump_path().c_str(), points, threads));
+
+    const dumped_thread *t = find_thread(threads, "gtest_main");
+    ASSERT_NE(nullptr, t);
+    EXPECT_TRUE(t->events.empty());
+}
+
+TEST(trace, spans_round_trip_through_dump)
+{
+    REQUIRE_TRACEPOINTS();
+
+    ASSERT_EQ(OK, trace_thread_register("gtest_main"));
+    trace_reset();
+    trace_enable(1);
+
+    TRACE_BEGIN(TRACE_FIFO_DRAIN, 7);
+    TRACE_INSTANT(TRACE_ALARM, 3);
+    TRACE_END(TRACE_FIFO_DRAIN, 7);
+    trace_enable(0);
+
+    std::vector<std::string> points;
+    std::vector<dumped_thread> threads;
+    ASSERT_EQ(OK, trace_dump(dump_path().c_str()));
+    ASSERT_TRUE(load_dump(dump_path().c_str(), points, threads));
+
+    ASSERT_EQ((size_t)TRACE_POINT_COUNT, points.size());
+    EXPECT_EQ("fifo_drain", points[TRACE_FIFO_DRAIN]);
+    EXPECT_EQ("alarm", points[TRACE_ALARM]);
+
+    const dumped_thread *t = find_thread(threads, "gtest_main");
+    ASSERT_NE(nullptr, t);
+    ASSERT_EQ(3u, t->events.size());
+
+    EXPECT_EQ(TRACE_FIFO_DRAIN, t->events[0].point);
+    EXPECT_EQ(TRACE_PH_BEGIN, t->events[0].phase);
+    EXPECT_EQ(7u, t->events[0].arg);
+    EXPECT_EQ(TRACE_ALARM, t->events[1].point);
+    EXPECT_EQ(TRACE_PH_INSTANT, t->events[1].phase);
+    EXPECT_EQ(TRACE_PH_END, t->events[2].phase);
+
+    // monotonic per thread
+    EXPECT_LE(t->events[0].ts_ns, t->events[1].ts_ns);
+    EXPECT_LE(t->events[1].ts_ns, t->events[2].ts_ns);
+}
+
+TEST(trace, ring_keeps_newest_events)
+{
+    REQUIRE_TRACEPOINTS();
+
+    ASSERT_EQ(OK, trace_thread_register("gtest_main"));
+    trace_reset();
+    trace_enable(1);
+
+    const uint64_t extra = 10;
+    for (uint64_t i = 0; i < TRACE_EVENTS_PER_THREAD + extra; i++) TRACE_INSTANT(TRACE_BLOCK_POP, i);
+    trace_enable(0);
+
+    std::vector<std::string> points;
+    std::vector<dumped_thread> threads;
+    ASSERT_EQ(OK, trace_dump(dump_path().c_str()));
+    ASSERT_TRUE(load_dump(dump_path().c_str(), points, threads));
+
+    const dumped_thread *t = find_thread(threads, "gtest_main");
+    ASSERT_NE(nullptr, t);
+    ASSERT_EQ((size_t)TRACE_EVENTS_PER_THREAD, t->events.size());
+    EXPECT_EQ(extra, t->events.front().arg);
+    EXPECT_EQ(TRACE_EVENTS_PER_THREAD + extra - 1, t->events.back().arg);
+}
+
+TEST(trace, threads_get_separate_buffers)
+{
+    REQUIRE_TRACEPOINTS();
+
+    trace_reset();
+    trace_enable(1);
+
+    auto worker = [](const char *name, uint64_t base)
+    {
+        trace_thread_register(name);
+        for (uint64_t i = 0; i < 100; i++)
+        {
+            TRACE_BEGIN(TRACE_FEATURES, base + i);
+            TRACE_END(TRACE_FEATURES, base + i);
+        }
+    };
+    std::thread a(worker, "trace_worker_a", 1000);
+    std::thread b(worker, "trace_worker_b", 2000);
+    a.join();
+    b.join();
+    trace_enable(0);
+
+    std::vector<std::string> points;
+    std::vector<dumped_thread> threads;
+    ASSERT_EQ(OK, trace_dump(dump_path().c_str()));
+    ASSERT_TRUE(load_dump(dump_path().c_str(), points, threads));
+
+    const dumped_thread *ta = find_thread(threads, "trace_worker_a");
+    const dumped_thread *tb = find_thread(threads, "trace_worker_b");
+    ASSERT_NE(nullptr, ta);
+    ASSERT_NE(nullptr, tb);
+    EXPECT_NE(ta->tid, tb->tid);
+    ASSERT_EQ(200u, ta->events.size());
+    ASSERT_EQ(200u, tb->events.size());
+    for (const auto &ev : ta->events) EXPECT_TRUE(ev.arg >= 1000 && ev.arg < 1100);
+    for (const auto &ev : tb->events) EXPECT_TRUE(ev.arg >= 2000 && ev.arg < 2100);
+}
+
+TEST(trace, threads_registered_while_disabled_take_no_slot)
+{
+    trace_enable(0);
+
+    std::thread idle([] {
+        trace_thread_register("trace_idle");
+        trace_thread_unregister();
+    });
+    idle.join();
+
+    std::vector<std::string> points;
+    std::vector<dumped_thread> threads;
+    ASSERT_EQ(OK, trace_dump(dump_path().c_str()));
+    ASSERT_TRUE(load_dump(dump_path().c_str(), points, threads));
+    EXPECT_EQ(nullptr, find_thread(threads, "trace_idle"));
+}
+
+TEST(trace, restarted_thread_reuses_its_slot)
+{
+    REQUIRE_TRACEPOINTS();
+
+    trace_reset();
+    trace_enable(1);
+
+    // more start / stop cycles than there are slots
+    const uint64_t cycles = TRACE_MAX_THREADS + 4;
+    for (uint64_t c = 0; c < cycles; c++)
+    {
+        std::thread worker([c] {
+            ASSERT_EQ(OK, trace_thread_register("trace_restart"));
+            TRACE_INSTANT(TRACE_BLOCK_POP, c);
+            trace_thread_unregister();
+        });
+        worker.join();
+    }
+    trace_enable(0);
+
+    std::vector<std::string> points;
+    std::vector<dumped_thread> threads;
+    ASSERT_EQ(OK, trace_dump(dump_path().c_str()));
+    ASSERT_TRUE(load_dump(dump_path().c_str(), points, threads));
+
+    size_t named = 0;
+    for (const auto &t : threads) named += (t.name == "trace_restart");
+    EXPECT_EQ(1u, named);
+
+    // every cycle's event survives its thread, oldest first
+    const dumped_thread *t = find_thread(threads, "trace_restart");
+    ASSERT_NE(nullptr, t);
+    ASSERT_EQ(cycles, t->events.size());
+    EXPECT_EQ(0u, t->events.front().arg);
+    EXPECT_EQ(cycles - 1, t->events.back().arg);
+}
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include "utilities/trend_store/trend_store.h"
+#include "common_def.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// 2 channels, 1 s x 8 slots, 4 s x 4 slots
+static trend_store_cfg_t test_cfg()
+{
+    trend_store_cfg_t cfg = {};
+    cfg.n_channels = 2;
+    cfg.n_tiers = 2;
+    cfg.tier[0] = {1000, 8};
+    cfg.tier[1] = {4000, 4};
+    return cfg;
+}
+
+// four records per second, channel 0 = second index, channel 1 = constant 3
+static void feed_seconds(trend_store_t *store, uint64_t from_s, uint64_t to_s)
+{
+    for (uint64_t t = from_s * 1000; t < to_s * 1000; t += 250)
+    {
+        float values[2] = {(float)(t / 1000), 3.0f};
+        ASSERT_EQ(OK, trend_store_add(store, t, values));
+    }
+}
+
+TEST(trend_store_size, rejects_non_multiple_tiers)
+{
+    trend_store_cfg_t cfg = test_cfg();
+    cfg.tier[1].period_ms = 1500;
+    EXPECT_EQ(0u, trend_store_size(&cfg));
+}
+
+TEST(trend_store_attach, fails_on_short_buffer)
+{
+    trend_store_cfg_t cfg = test_cfg();
+    std::vector<uint8_t> mem(trend_store_size(&cfg) - 1);
+    EXPECT_EQ(nullptr, trend_store_attach(mem.data(), mem.size(), &cfg));
+}
+
+TEST(trend_store_query, rolls_up_into_coarser_tier)
+{
+    trend_store_cfg_t cfg = test_cfg();
+    std::vector<uint8_t> mem(trend_store_size(&cfg));
+    trend_store_t *store = trend_store_attach(mem.data(), mem.size(), &cfg);
+    ASSERT_NE(nullptr, store);
+
+    feed_seconds(store, 0, 9);      // closes seconds 0..7, first 4 s bucket closes at 8 s
+
+    trend_point_t pts[16];
+    size_t n = 0;
+    trend_query_info_t info = {};
+
+    ASSERT_EQ(OK, trend_store_query(store, 0, 0, 100000, 1000, pts, 16, &n, &info));
+    EXPECT_EQ(1000u, info.tier_period_ms);
+    EXPECT_EQ(0, info.truncated);
+    ASSERT_EQ(8u, n);
+    EXPECT_EQ(2000u, pts[2].start_ms);
+    EXPECT_EQ(4u, pts[2].count);
+    EXPECT_FLOAT_EQ(2.0f, pts[2].mean);
+
+    // coarsest tier with period <= 10 s is the 4 s tier
+    ASSERT_EQ(OK, trend_store_query(store, 0, 0, 100000, 10000, pts, 16, &n, &info));
+    EXPECT_EQ(4000u, info.tier_period_ms);
+    ASSERT_EQ(1u, n);
+    EXPECT_EQ(0u, pts[0].start_ms);
+    EXPECT_EQ(16u, pts[0].count);
+    EXPECT_FLOAT_EQ(0.0f, pts[0].min);
+    EXPECT_FLOAT_EQ(3.0f, pts[0].max);
+    EXPECT_FLOAT_EQ(1.5f, pts[0].mean);
+    EXPECT_NEAR(std::sqrt((0.0f + 1.0f + 4.0f + 9.0f) / 4.0f), pts[0].rms, 1e-5f);
+
+    trend_point_t latest;
+    ASSERT_EQ(OK, trend_store_latest(store, 0, 1, &latest));
+    EXPECT_EQ(7000u, latest.start_ms);
+    EXPECT_FLOAT_EQ(3.0f, latest.rms);
+
+    trend_store_close(store);
+}
+
+TEST(trend_store_query, ring_keeps_most_recent_and_filters_range)
+{
+    trend_store_cfg_t cfg = test_cfg();
+    std::vector<uint8_t> mem(trend_store_size(&cfg));
+    trend_store_t *store = trend_store_attach(mem.data(), mem.size(), &cfg);
+    ASSERT_NE(nullptr, store);
+
+    feed_seconds(store, 0, 21);     // seconds 0..19 closed, ring holds 12..19
+
+    trend_point_t pts[16];
+    size_t n = 0;
+    trend_query_info_t info = {};
+    ASSERT_EQ(OK, trend_store_query(store, 0, 12000, 100000, 1000, pts, 16, &n, &info));
+    EXPECT_EQ(1000u, info.tier_period_ms);
+    EXPECT_EQ(12000u, info.oldest_ms);
+    ASSERT_EQ(8u, n);
+    EXPECT_EQ(12000u, pts[0].start_ms);
+    EXPECT_EQ(19000u, pts[7].start_ms);
+
+    ASSERT_EQ(OK, trend_store_query(store, 0, 14500, 17000, 1000, pts, 16, &n, nullptr));
+    ASSERT_EQ(2u, n);
+    EXPECT_EQ(15000u, pts[0].start_ms);
+    EXPECT_EQ(16000u, pts[1].start_ms);
+
+    trend_store_close(store);
+}
+
+TEST(trend_store_query, falls_through_to_a_tier_that_still_holds_the_start)
+{
+    trend_store_cfg_t cfg = test_cfg();
+    std::vector<uint8_t> mem(trend_store_size(&cfg));
+    trend_store_t *store = trend_store_attach(mem.data(), mem.size(), &cfg);
+    ASSERT_NE(nullptr, store);
+
+    feed_seconds(store, 0, 21);     // 1 s ring holds 12..19, 4 s ring holds 0..12
+
+    trend_point_t pts[16];
+    size_t n = 0;
+    trend_query_info_t info = {};
+    ASSERT_EQ(OK, trend_store_query(store, 0, 2000, 100000, 1000, pts, 16, &n, &info));
+    EXPECT_EQ(4000u, info.tier_period_ms);
+    EXPECT_EQ(0u, info.oldest_ms);
+    EXPECT_EQ(0, info.truncated);
+    ASSERT_EQ(3u, n);
+    EXPECT_EQ(4000u, pts[0].start_ms);
+    EXPECT_EQ(12000u, pts[2].start_ms);
+
+    // more buckets than room
+    ASSERT_EQ(OK, trend_store_query(store, 0, 12000, 100000, 1000, pts, 5, &n, &info));
+    EXPECT_EQ(1000u, info.tier_period_ms);
+    EXPECT_EQ(5u, n);
+    EXPECT_EQ(1, info.truncated);
+
+    // exactly as many as room is not a truncation
+    ASSERT_EQ(OK, trend_store_query(store, 0, 12000, 17000, 1000, pts, 5, &n, &info));
+    EXPECT_EQ(5u, n);
+    EXPECT_EQ(0, info.truncated);
+
+    // the coarsest tier wraps too : what is left, flagged
+    feed_seconds(store, 21, 41);    // 4 s ring holds 20..32
+    ASSERT_EQ(OK, trend_store_query(store, 0, 2000, 100000, 1000, pts, 16, &n, &info));
+    EXPECT_EQ(4000u, info.tier_period_ms);
+    EXPECT_EQ(20000u, info.oldest_ms);
+    EXPECT_EQ(1, info.truncated);
+    ASSERT_EQ(4u, n);
+    EXPECT_EQ(20000u, pts[0].start_ms);
+
+    trend_store_close(store);
+}
+
+TEST(trend_store_attach, restart_reuses_matching_layout)
+{
+    trend_store_cfg_t cfg = test_cfg();
+    std::vector<uint8_t> mem(trend_store_size(&cfg));
+
+    trend_store_t *store = trend_store_attach(mem.data(), mem.size(), &cfg);
+    ASSERT_NE(nullptr, store);
+    feed_seconds(store, 0, 3);
+    trend_store_close(store);
+
+    // same memory, same layout : history and open bucket survive
+    store = trend_store_attach(mem.data(), mem.size(), &cfg);
+    ASSERT_NE(nullptr, store);
+    feed_seconds(store, 3, 4);
+
+    trend_point_t pts[16];
+    size_t n = 0;
+    ASSERT_EQ(OK, trend_store_query(store, 0, 0, 100000, 1000, pts, 16, &n, nullptr));
+    EXPECT_EQ(3u, n);
+    trend_store_close(store);
+
+    // different layout : store is reinitialised
+    cfg.tier[0].slots = 6;
+    std::vector<uint8_t> mem2(mem);
+    mem2.resize(trend_store_size(&cfg));
+    store = trend_store_attach(mem2.data(), mem2.size(), &cfg);
+    ASSERT_NE(nullptr, store);
+    ASSERT_EQ(OK, trend_store_query(store, 0, 0, 100000, 1000, pts, 16, &n, nullptr));
+    EXPECT_EQ(0u, n);
+    trend_store_close(store);
+}
+
+TEST(trend_store_attach, reinitialises_on_corrupt_offsets)
+{
+    trend_store_cfg_t cfg = test_cfg();
+    std::vector<uint8_t> mem(trend_store_size(&cfg));
+
+    trend_store_t *store = trend_store_attach(mem.data(), mem.size(), &cfg);
+    ASSERT_NE(nullptr, store);
+    feed_seconds(store, 0, 3);
+    trend_store_close(store);
+
+    // header otherwise intact, tier 0 open bucket pointed far outside the store
+    const size_t tier0_acc_offset = 16 + 24;
+    const uint64_t wild = 1ull << 40;
+    std::memcpy(&mem[tier0_acc_offset], &wild, sizeof(wild));
+
+    store = trend_store_attach(mem.data(), mem.size(), &cfg);
+    ASSERT_NE(nullptr, store);
+    feed_seconds(store, 3, 5);
+
+    trend_point_t pts[16];
+    size_t n = 0;
+    ASSERT_EQ(OK, trend_store_query(store, 0, 0, 100000, 1000, pts, 16, &n, nullptr));
+    ASSERT_EQ(1u, n);
+    EXPECT_EQ(3000u, pts[0].start_ms);
+    trend_store_close(store);
+}
+
+TEST(trend_store_add, rejects_time_going_backwards)
+{
+    trend_store_cfg_t cfg = test_cfg();
+    std::vector<uint8_t> mem(trend_store_size(&cfg));
+    trend_store_t *store = trend_store_attach(mem.data(), mem.size(), &cfg);
+    ASSERT_NE(nullptr, store);
+
+    float values[2] = {1.0f, 1.0f};
+    uint64_t rejected = 99;
+    ASSERT_EQ(OK, trend_store_rejected(store, &rejected));
+    EXPECT_EQ(0u, rejected);
+
+    ASSERT_EQ(OK, trend_store_add(store, 5000, values));
+    EXPECT_EQ(ERROR, trend_store_add(store, 3000, values));
+    EXPECT_EQ(ERROR, trend_store_add(store, 4999, values));
+    ASSERT_EQ(OK, trend_store_add(store, 5000, values));
+    ASSERT_EQ(OK, trend_store_rejected(store, &rejected));
+    EXPECT_EQ(2u, rejected);
+
+    trend_store_close(store);
+}